@@ -0,0 +1,130 @@
+/**
+ * @brief initools lookup benchmark
+ *
+ * @file lookup.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+
+/* C++ system */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+
+/* C system */
+#include <cstdlib>
+#include <cstdint>
+#include <cinttypes>
+#include <cstdio>
+
+/* Defines --------------------------------------------- */
+#define BENCH_SECTIONS   1000U
+#define BENCH_KEYS       16U
+#define BENCH_ITERATIONS 2000000U
+
+/* Notes ----------------------------------------------- */
+/* Compares the per-lookup cost of the out-of-line getters (through the
+ * library, PLT included when it is shared) with the inline fast path.
+ * Build with -DENABLE_BENCHMARKS=1, and -DENABLE_STATIC=1 to compare
+ * against the static library. The lookups are then run again on
+ * the frozen document. */
+
+/* Variable declaration -------------------------------- */
+/** @brief Sink of the results, so that the loops are not optimized out */
+static volatile uint64_t sSink = 0U;
+
+/* Type definitions ------------------------------------ */
+struct Lookup {
+    std::string mSection;
+    std::string mKey;
+};
+
+/* Support functions ----------------------------------- */
+static void buildDocument(INI &pINI) {
+    std::string lText;
+    for(uint32_t i = 0U; i < BENCH_SECTIONS; ++i) {
+        lText += "[section." + std::to_string(i) + "]\n";
+        for(uint32_t j = 0U; j < BENCH_KEYS; ++j) {
+            lText += "key_" + std::to_string(j) + "=" + std::to_string(i * BENCH_KEYS + j) + "\n";
+        }
+    }
+
+    pINI.parseBuffer(lText.data(), lText.size());
+}
+
+template<typename F>
+static void run(const char *pName, const std::vector<Lookup> &pLookups, const F &pLookup) {
+    const auto lStart = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0U; i < BENCH_ITERATIONS; ++i) {
+        const Lookup &lLookup = pLookups[i % pLookups.size()];
+        sSink = sSink + pLookup(lLookup);
+    }
+
+    const auto lEnd = std::chrono::steady_clock::now();
+    const double lNs = std::chrono::duration<double, std::nano>(lEnd - lStart).count() / BENCH_ITERATIONS;
+
+    std::printf("%-36s %8.1f ns/lookup\n", pName, lNs);
+}
+
+static void runAll(const INI &pINI, const std::vector<Lookup> &pLookups) {
+    run("getUInt32 (out of line)", pLookups, [&pINI](const Lookup &pLookup) {
+        uint32_t lValue = 0U;
+        pINI.getUInt32(pLookup.mKey, lValue, pLookup.mSection);
+        return lValue;
+    });
+
+    run("getValue (out of line, copy)", pLookups, [&pINI](const Lookup &pLookup) {
+        std::string lValue;
+        pINI.getValue(pLookup.mKey, lValue, pLookup.mSection);
+        return lValue.size();
+    });
+
+    run("get<uint32_t> (inline)", pLookups, [&pINI](const Lookup &pLookup) {
+        uint32_t lValue = 0U;
+        pINI.get(pLookup.mKey, lValue, pLookup.mSection);
+        return lValue;
+    });
+
+    run("getView (inline, no copy)", pLookups, [&pINI](const Lookup &pLookup) {
+        std::string_view lValue;
+        pINI.getView(pLookup.mKey, lValue, pLookup.mSection);
+        return lValue.size();
+    });
+}
+
+/* Main ------------------------------------------------ */
+int main(void) {
+    INI lINI;
+    buildDocument(lINI);
+
+    /* Lookups spread over the document, and a few hot ones
+     * staying in cache, where the call overhead shows most */
+    std::vector<Lookup> lLookups;
+    for(uint32_t i = 0U; i < 4096U; ++i) {
+        const uint32_t lSection = (i * 7919U) % BENCH_SECTIONS;
+        const uint32_t lKey     = (i * 31U) % BENCH_KEYS;
+        lLookups.push_back({"section." + std::to_string(lSection), "key_" + std::to_string(lKey)});
+    }
+
+    const std::vector<Lookup> lHot(lLookups.begin(), lLookups.begin() + 4U);
+
+    std::printf("%zu distinct lookups\n", lLookups.size());
+    runAll(lINI, lLookups);
+
+    std::printf("%zu distinct lookups\n", lHot.size());
+    runAll(lINI, lHot);
+
+    /* Same lookups through the perfect hash */
+    lINI.freeze();
+
+    std::printf("%zu distinct lookups, frozen\n", lLookups.size());
+    runAll(lINI, lLookups);
+
+    std::printf("%zu distinct lookups, frozen\n", lHot.size());
+    runAll(lINI, lHot);
+
+    return EXIT_SUCCESS;
+}
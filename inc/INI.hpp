@@ -10,19 +10,121 @@
 /* Includes -------------------------------------------- */
 /* C++ System */
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <functional>
+#include <iostream>
 #include <map>
+#include <memory>
+#include <forward_list>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <exception>
 
+/* Project */
+#include "INIStringPool.hpp"
+#include "ININame.hpp"
+#include "INIParser.hpp"
+#include "INIConvert.hpp"
+#include "INIList.hpp"
+#include "INIQuery.hpp"
+#include "INITree.hpp"
+#include "INIColumns.hpp"
+#include "INIJson.hpp"
+#include "INIFrozen.hpp"
+#include "INIValueIndex.hpp"
+
 /* C System */
 #include <cstdint>
 
 /* Defines --------------------------------------------- */
 
 /* Type definitions ------------------------------------ */
+/** @brief INI document modes, to be OR'ed together */
+enum INIMode : uint32_t {
+    INI_MODE_DEFAULT          = 0x00000000U,
+    INI_MODE_INTERNING        = 0x00000001U, /**< Identical names and values share one stored copy */
+    INI_MODE_INTERPOLATION    = 0x00000002U, /**< ${key}, ${section:key} and ${env:VAR} are resolved when read */
+    INI_MODE_HIERARCHY        = 0x00000004U, /**< Sections also form a tree, split on a separator */
+    INI_MODE_CASE_INSENSITIVE = 0x00000008U, /**< Section and key names are compared ignoring ASCII case */
+    INI_MODE_MULTILINE        = 0x00000010U, /**< '=' in values, continuation lines and quoted values */
+    INI_MODE_TOLERANT         = 0x00000020U, /**< Faulty lines are skipped and listed in diagnostics() */
+    INI_MODE_INDENTED         = 0x00000040U, /**< With INI_MODE_MULTILINE, indented lines continue the previous value */
+    INI_MODE_QUIET            = 0x00000080U, /**< parseFile and generateFile do not report on stdout */
+};
+
+/** @brief Key/value entry */
+struct INIEntry {
+    INIString mValue;
+
+    /** @brief Value converted by a schema while parsing */
+    INITypedValue mTyped;
+
+    /** @brief Value split by the list getters on first read, one list per delimiter */
+    mutable std::forward_list<INIList> mLists;
+
+    /** @brief Hash of the value, 0 until first needed. Atomic, as
+     * const readers may compute it concurrently ; they all store the
+     * same value, so relaxed accesses are enough. */
+    mutable std::atomic<uint64_t> mHash;
+
+    INIEntry() : mHash(0U) {}
+
+    INIEntry(INIEntry &&pOther) :
+        mValue(std::move(pOther.mValue)),
+        mTyped(std::move(pOther.mTyped)),
+        mLists(std::move(pOther.mLists)),
+        mHash(pOther.mHash.load(std::memory_order_relaxed))
+    {
+        /* Empty for now */
+    }
+
+    uint64_t hash(void) const {
+        uint64_t lHash = mHash.load(std::memory_order_relaxed);
+        if(0U == lHash) {
+            lHash = INIValueIndex::hash(mValue.view());
+            mHash.store(lHash, std::memory_order_relaxed);
+        }
+
+        return lHash;
+    }
+};
+
+/** @brief Interpolated value of an entry, computed on first read */
+struct INIInterpolation {
+    uint32_t    mState;
+    std::string mValue;
+};
+
+/** @brief Section, with its entries and their order of appearance.
+ * In case-insensitive mode, the map keys are the folded names,
+ * mName and mOrder keep the names as first written.
+ */
+struct INISection {
+    INIString mName;
+    std::map<INIString, INIEntry, ININameLess> mEntries;
+    std::vector<INIString> mOrder;
+
+    /** @brief Sum of the fingerprints of the entries, in any order,
+     * and hash of the name, folded in case-insensitive mode */
+    uint64_t mFingerprint = 0U;
+    uint64_t mNameHash    = 0U;
+
+    /** @brief Entries by key atom, only filled in interning mode */
+    std::unordered_map<INIAtom, INIEntry *> mAtomEntries;
+};
+
+/** @brief Lazy views on the section names, and on the keys of a section */
+typedef ININameQuery<std::map<INIString, INISection, ININameLess>> INISectionQuery;
+typedef ININameQuery<std::map<INIString, INIEntry, ININameLess>>   INIKeyQuery;
 
 /* Forward declarations -------------------------------- */
+class INIBuilder;
+class INIRuntimeSchema;
+struct INIViolation;
 
 /* INI file exception class ---------------------------- */
 class INIException : public std::exception {
@@ -35,15 +137,33 @@ class INIException : public std::exception {
 /* INI class ------------------------------------------- */
 class INI {
     public:
-        INI(const std::string &pFile);
+        explicit INI(const uint32_t &pMode = INI_MODE_DEFAULT);
+        INI(const std::string &pFile, const uint32_t &pMode = INI_MODE_DEFAULT);
 
         virtual ~INI();
 
         /* Parser */
         int parseFile(const std::string &pFile);
+        int parseFile(const std::string &pFile,
+            const INIRuntimeSchema &pSchema,
+            std::vector<INIViolation> &pViolations);
+        int parseBuffer(const char *pData, const size_t &pSize);
 
         /* Getters */
         std::string fileName(void) const;
+        uint32_t mode(void) const;
+
+        /** @brief Content fingerprints, kept up to date by every change.
+         * Equal documents or sections have equal fingerprints, whatever
+         * the order of their sections and keys. Fingerprints compare
+         * across documents with the same case mode, and across runs.
+         * Different contents may collide : equal fingerprints are only
+         * a strong hint of equal contents, not a proof. */
+        uint64_t fingerprint(void) const;
+        int fingerprint(const std::string &pSection, uint64_t &pFingerprint) const;
+
+        /** @brief Problems of the last parse, in file order (tolerant mode only) */
+        const std::vector<INIDiagnostic> &diagnostics(void) const;
 
         bool sectionExists(const std::string &pSection) const;
         bool keyExists(const std::string &pKey, const std::string &pSection = "default") const;
@@ -52,11 +172,57 @@ class INI {
             std::string &pOut,
             const std::string &pSection = "default") const;
 
+        /** @brief Same as getValue, without copying. The view is '\0'
+         * terminated and stays valid until the document is modified */
+        int getView(const std::string_view &pKey,
+            std::string_view &pOut,
+            const std::string_view &pSection = "default") const;
+
+        /** @brief Typed lookup inlined in the caller, without logging.
+         * Same conversions as the typed getters, T being an integer,
+         * a floating point, bool, std::string or std::string_view. */
+        template<typename T>
+        int get(const std::string_view &pKey,
+            T &pValue,
+            const std::string_view &pSection = "default") const;
+
         std::vector<std::string> getSections(void) const;
         std::vector<std::string> getKeys(const std::string &pSection = "default") const;
         std::vector<std::string> getValues(const std::string &pSection = "default") const;
         std::map<std::string, std::string> getSectionContents(const std::string &pSection = "default") const;
 
+        /* Prefix and glob queries ("backend.eu-west.*", "tls_*"), in name order */
+        INISectionQuery querySections(const std::string_view &pPattern) const;
+        INIKeyQuery queryKeys(const std::string_view &pPattern, const std::string &pSection = "default") const;
+
+        /* Columnar extraction of the sections matching pSelector, one row
+         * per section in name order. 0 threads means one per hardware thread. */
+        int extractColumns(const std::string_view &pSelector,
+            const std::vector<INIColumnSpec> &pSpecs,
+            INIColumns &pColumns,
+            const size_t &pThreads = 0U) const;
+
+        /* Section tree (hierarchy mode only) */
+        int setSeparator(const char &pSeparator);
+        const INITreeNode *getNode(const std::string &pSection) const;
+        int getInheritedValue(const std::string &pKey,
+            std::string &pOut,
+            const std::string &pSection) const;
+
+        /* Interpolation (interpolation mode only) */
+        int resolveAll(void) const;
+
+        /* Interned lookups (interning mode only) */
+        INIAtom atom(const std::string &pName) const;
+        int getValue(const INIAtom &pKey, std::string &pOut, const INIAtom &pSection) const;
+
+        /* Replays the document, in order, through a parser handler */
+        int visit(INIParserHandler &pHandler) const;
+
+        /* Memory accounting */
+        size_t memoryUsage(void) const;
+        size_t internedBytesSaved(void) const;
+
         int getInt64(const std::string &pKey, int64_t &pValue, const std::string &pSection = "default") const;
         int getInt32(const std::string &pKey, int32_t &pValue, const std::string &pSection = "default") const;
         int getInt16(const std::string &pKey, int16_t &pValue, const std::string &pSection = "default") const;
@@ -69,6 +235,17 @@ class INI {
         int getBoolean(const std::string &pKey, bool &pValue, const std::string &pSection = "default") const;
         int getDouble(const std::string &pKey, double &pValue, const std::string &pSection = "default") const;
 
+        /* List getters, the views stay valid until the entry is modified */
+        int getList(const std::string &pKey,
+            INIArrayView<std::string_view> &pList,
+            const std::string &pSection = "default",
+            const char &pDelim = ',') const;
+        template<typename T>
+        int getArray(const std::string &pKey,
+            INIArrayView<T> &pArray,
+            const std::string &pSection = "default",
+            const char &pDelim = ',') const;
+
         /* Setters */
         int setInt64(const std::string &pKey, const int64_t &pValue, const std::string &pSection = "default");
         int setInt32(const std::string &pKey, const int32_t &pValue, const std::string &pSection = "default");
@@ -100,18 +277,251 @@ class INI {
         int removeSection(const std::string &pSection);
         int removeKey(const std::string &pSection, const std::string &pKey);
 
-        /* Generator */
+        /* Read-only form : lookups go through a perfect hash over
+         * the (section, key) pairs, modifications and parsing fail
+         * until thaw() is called */
+        int freeze(void);
+        void thaw(void);
+        bool frozen(void) const;
+
+        /* Secondary index on the values, built in bulk now and after
+         * each parse, then kept up to date by the setters, adders and
+         * removers. The queries return lazy views. */
+        int indexValues(const uint32_t &pFlags = INI_VALUE_INDEX_VALUES);
+        void dropValueIndex(void);
+        INIValueQuery findValue(const std::string_view &pValue) const;
+        INIValueQuery findValue(const std::string_view &pKey, const std::string_view &pValue) const;
+
+        /* Generator. Large documents are formatted in chunks on
+         * pThreads workers, 0 meaning one per hardware thread,
+         * each chunk being written at its own offset */
         virtual int generateFile(const std::string &pDest) const;
+        int generateFile(const std::string &pDest, const size_t &pThreads) const;
+        int generate(std::ostream &pStream) const;
+
+        /* JSON export, in file order, through chunks of bounded size */
+        int exportJson(const INIWriteCallback &pSink, const uint32_t &pFlags = INI_JSON_DEFAULT) const;
     protected:
+        friend class INIBuilder;
+
+        int parseFile(const std::string &pFile, INIBuilder &pBuilder);
+
+        /* Storage helpers */
+        const INISection *findSection(const std::string_view &pSection) const;
+        INISection *findSection(const std::string_view &pSection);
+        const INIEntry *findEntry(const std::string_view &pKey, const std::string_view &pSection) const;
+        INIEntry *findEntry(const std::string_view &pKey, const std::string_view &pSection);
+
+        INISection *insertSection(const std::string_view &pSection);
+        INIEntry *insertEntry(INISection &pSection, const std::string_view &pKey, const std::string_view &pValue);
+        INIEntry *updateEntry(INISection &pSection, const std::string_view &pKey, const std::string_view &pValue);
+        void eraseSection(const std::string_view &pSection);
+        void eraseEntry(INISection &pSection, const std::string_view &pKey);
+        void clear(void);
+
+        /** @brief Moves an entry fingerprint in or out of a section, and of the document */
+        void fingerprint(INISection &pSection, const uint64_t &pAdded, const uint64_t &pRemoved);
+
+        uint32_t parserOptions(void) const;
+
+        /** @brief Sections formatted together, and where they go in the file */
+        struct INIGenerateChunk {
+            std::vector<const INISection *> mSections;
+            size_t mOffset = 0U;
+            size_t mSize   = 0U;
+        };
+
+        std::vector<INIGenerateChunk> generateChunks(void) const;
+
+        /** @brief Name stored as map key, folded in case-insensitive mode */
+        INIString keyOf(const INIString &pName);
+
+        /* Interpolation helpers */
+        int valueOf(const INIEntry &pEntry,
+            const std::string_view &pKey,
+            const std::string_view &pSection,
+            std::string_view &pOut) const;
+        int resolve(const INIEntry &pEntry,
+            const std::string_view &pKey,
+            const std::string_view &pSection,
+            std::string_view &pOut) const;
+        void invalidate(const std::string_view &pKey, const std::string_view &pSection);
+
+        INIList *listOf(const std::string_view &pKey,
+            const std::string_view &pSection,
+            const char &pDelim) const;
+
+        template<typename T>
+        int convertEntry(const INIEntry &pEntry,
+            const std::string_view &pKey,
+            const std::string_view &pSection,
+            T &pValue) const;
+
+        uint32_t mMode;
+
+        /* The pool must outlive every string stored below */
+        INIStringPool mPool;
+
         bool mFileParsed;
         std::string mFileName;
         std::fstream mFileStream;
 
-        std::map<std::string, std::map<std::string, std::string>> mSections;
-        std::map<std::string, std::vector<std::string>> mSectionElementOrder;
-        std::vector<std::string> mSectionOrder;
+        std::vector<INIDiagnostic> mDiagnostics;
+
+        std::map<INIString, INISection, ININameLess> mSections;
+        std::vector<INIString> mSectionOrder;
+
+        /** @brief Sum of the fingerprints of the sections */
+        uint64_t mFingerprint;
+
+        /** @brief Sections by name atom, only filled in interning mode */
+        std::unordered_map<INIAtom, INISection *> mAtomSections;
+
+        /** @brief Sections split on their separator, only filled in hierarchy mode */
+        INITree mTree;
+
+        /** @brief Entries by value, only set once indexValues() is called */
+        std::unique_ptr<INIValueIndex> mValueIndex;
+
+        /** @brief Index of the entries, only set once frozen */
+        std::unique_ptr<INIFrozenIndex> mFrozen;
+
+        /** @brief Guards the caches filled by the const getters */
+        mutable std::recursive_mutex mCacheMutex;
+
+        /** @brief Resolved values, and the entries depending on each name,
+         * only filled in interpolation mode. Environment variables
+         * are read once, when the value is first resolved. */
+        mutable std::unordered_map<const INIEntry *, INIInterpolation> mInterpolations;
+        mutable std::unordered_map<std::string, std::unordered_set<std::string>> mDependents;
 
     private:
 };
 
+/* Inline implementation ------------------------------- */
+/* The lookup fast path, the parsing, error reporting
+ * and interpolation stay in INI.cpp */
+inline const INISection *INI::findSection(const std::string_view &pSection) const {
+    auto lIt = mSections.find(pSection);
+    return (mSections.end() == lIt) ? nullptr : &lIt->second;
+}
+
+inline INISection *INI::findSection(const std::string_view &pSection) {
+    auto lIt = mSections.find(pSection);
+    return (mSections.end() == lIt) ? nullptr : &lIt->second;
+}
+
+inline const INIEntry *INI::findEntry(const std::string_view &pKey, const std::string_view &pSection) const {
+    if(nullptr != mFrozen) {
+        return mFrozen->find(pSection, pKey);
+    }
+
+    const INISection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
+        return nullptr;
+    }
+
+    auto lIt = lSection->mEntries.find(pKey);
+    return (lSection->mEntries.end() == lIt) ? nullptr : &lIt->second;
+}
+
+inline INIEntry *INI::findEntry(const std::string_view &pKey, const std::string_view &pSection) {
+    INISection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
+        return nullptr;
+    }
+
+    auto lIt = lSection->mEntries.find(pKey);
+    return (lSection->mEntries.end() == lIt) ? nullptr : &lIt->second;
+}
+
+inline int INI::valueOf(const INIEntry &pEntry,
+    const std::string_view &pKey,
+    const std::string_view &pSection,
+    std::string_view &pOut) const
+{
+    pOut = pEntry.mValue.view();
+
+    if((0U == (mMode & INI_MODE_INTERPOLATION))
+        || (std::string_view::npos == pOut.find("${")))
+    {
+        /* Nothing to interpolate */
+        return 0;
+    }
+
+    return resolve(pEntry, pKey, pSection, pOut);
+}
+
+template<typename T>
+int INI::convertEntry(const INIEntry &pEntry,
+    const std::string_view &pKey,
+    const std::string_view &pSection,
+    T &pValue) const
+{
+    std::string_view lValue;
+
+    int lResult = valueOf(pEntry, pKey, pSection, lValue);
+    if(0 > lResult) {
+        return -1;
+    }
+
+    if(0 == lResult) {
+        /* Not interpolated, use the value converted while parsing if it fits */
+        lResult = pEntry.mTyped.to(pValue);
+        if(1 != lResult) {
+            return lResult;
+        }
+    }
+
+    return INIConvert::to(lValue, pValue);
+}
+
+inline int INI::getView(const std::string_view &pKey,
+    std::string_view &pOut,
+    const std::string_view &pSection) const
+{
+    const INIEntry *lEntry = findEntry(pKey, pSection);
+    if(nullptr == lEntry) {
+        return -1;
+    }
+
+    return (0 > valueOf(*lEntry, pKey, pSection, pOut)) ? -1 : 0;
+}
+
+template<typename T>
+inline int INI::get(const std::string_view &pKey,
+    T &pValue,
+    const std::string_view &pSection) const
+{
+    const INIEntry *lEntry = findEntry(pKey, pSection);
+    if(nullptr == lEntry) {
+        return -1;
+    }
+
+    return (0 > convertEntry(*lEntry, pKey, pSection, pValue)) ? -1 : 0;
+}
+
+/* Template implementation ----------------------------- */
+template<typename T>
+int INI::getArray(const std::string &pKey,
+    INIArrayView<T> &pArray,
+    const std::string &pSection,
+    const char &pDelim) const
+{
+    /* The conversions are cached, and shared with concurrent readers */
+    std::lock_guard<std::recursive_mutex> lLock(mCacheMutex);
+
+    INIList *lList = listOf(pKey, pSection, pDelim);
+    if(nullptr == lList) {
+        return -1;
+    }
+
+    int lResult = lList->array(pArray);
+    if(-2 == lResult) {
+        std::cerr << "[ERROR] <INI::getArray> Value is out of bounds !" << std::endl;
+    }
+
+    return (0 == lResult) ? 0 : -1;
+}
+
 #endif /* INI_HPP */
@@ -0,0 +1,471 @@
+/**
+ * @brief INI compile-time schema binding
+ *
+ * Describes how a configuration structure maps onto an INI document :
+ *
+ *     struct Config { uint16_t port; bool enabled; std::string host; };
+ *
+ *     static constexpr auto sSchema = iniSchema(
+ *         iniField("server", "port",    &Config::port).defaults(8080U).range(1U, 65535U),
+ *         iniField("server", "enabled", &Config::enabled).defaults(true),
+ *         iniField("server", "host",    &Config::host).required()
+ *     );
+ *
+ *     Config lConfig;
+ *     std::vector<INIBindIssue> lIssues;
+ *     iniBind(lINI, sSchema, lConfig, lIssues);
+ *
+ * The (section, key) hashes are computed at compile time,
+ * the document is then walked once and every problem is reported.
+ * A document binds as its getters read : names are matched without
+ * case in case-insensitive mode, and values are interpolated in
+ * interpolation mode. INI text is bound as written.
+ *
+ * @file INIBinding.hpp
+ */
+
+#ifndef INIBINDING_HPP
+#define INIBINDING_HPP
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+#include "INIConvert.hpp"
+#include "ININame.hpp"
+#include "INIParser.hpp"
+
+/* C++ System */
+#include <array>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Problems reported by the binding */
+enum INIBindError : uint32_t {
+    INI_BIND_ERROR_NONE = 0U,
+    INI_BIND_ERROR_UNKNOWN_KEY,     /**< The document has a key the schema does not describe */
+    INI_BIND_ERROR_MISSING_KEY,     /**< A required key is not in the document */
+    INI_BIND_ERROR_INVALID_VALUE,   /**< The value cannot be converted to the field type */
+    INI_BIND_ERROR_OUT_OF_RANGE,    /**< The value does not fit in the field range */
+    INI_BIND_ERROR_SYNTAX,          /**< The text is not valid INI, see mSyntax */
+};
+
+struct INIBindIssue {
+    INIBindError mError;
+    std::string  mSection;
+    std::string  mKey;
+    uint32_t     mLine;
+
+    /** @brief Parser error and column, for syntax errors only */
+    INIParseError mSyntax = INI_PARSE_ERROR_NONE;
+    uint32_t      mColumn = 0U;
+};
+
+/* Compile-time hashing -------------------------------- */
+/** @brief FNV-1a, usable in constant expressions.
+ * Folding hashes the names as ININame folds them. */
+constexpr uint64_t iniHash(const std::string_view &pStr, uint64_t pSeed = 14695981039346656037ULL, const bool &pFold = false) {
+    for(const char lChar : pStr) {
+        pSeed ^= static_cast<uint8_t>(pFold ? ININame::fold(lChar) : lChar);
+        pSeed *= 1099511628211ULL;
+    }
+
+    return pSeed;
+}
+
+constexpr uint64_t iniHash(const std::string_view &pSection, const std::string_view &pKey, const bool &pFold = false) {
+    /* Separate the section from the key, so that
+     * ("ab", "c") and ("a", "bc") do not collide */
+    return iniHash(pKey, iniHash(pSection, 14695981039346656037ULL, pFold) * 1099511628211ULL, pFold);
+}
+
+/* INI field class ------------------------------------- */
+template<typename T>
+struct INIFieldTraits {
+    /** @brief Type used to store the default value and the range */
+    typedef T value_type;
+    static constexpr bool sRanged = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+};
+
+template<>
+struct INIFieldTraits<std::string> {
+    typedef std::string_view value_type;
+    static constexpr bool sRanged = false;
+};
+
+/** @brief Describes one member of the structure S */
+template<typename S, typename T>
+class INIField {
+    public:
+        typedef S structure;
+        typedef T type;
+        typedef typename INIFieldTraits<T>::value_type value_type;
+
+        constexpr INIField(const std::string_view &pSection, const std::string_view &pKey, T S::*pMember) :
+            mSection(pSection),
+            mKey(pKey),
+            mHash(iniHash(pSection, pKey)),
+            mMember(pMember),
+            mDefault(),
+            mMin(lowest()),
+            mMax(highest()),
+            mRequired(false)
+        {
+            /* Empty for now */
+        }
+
+        /* Builders */
+        constexpr INIField defaults(const value_type &pDefault) const {
+            INIField lField(*this);
+            lField.mDefault = pDefault;
+            return lField;
+        }
+
+        constexpr INIField range(const value_type &pMin, const value_type &pMax) const {
+            static_assert(INIFieldTraits<T>::sRanged, "Only numeric fields have a range");
+
+            INIField lField(*this);
+            lField.mMin = pMin;
+            lField.mMax = pMax;
+            return lField;
+        }
+
+        constexpr INIField required(void) const {
+            INIField lField(*this);
+            lField.mRequired = true;
+            return lField;
+        }
+
+        /* Binding */
+        void reset(S &pOut) const {
+            pOut.*mMember = T(mDefault);
+        }
+
+        INIBindError assign(S &pOut, const std::string_view &pValue) const {
+            T lValue;
+
+            int lResult = INIConvert::to(pValue, lValue);
+            if(-2 == lResult) {
+                return INI_BIND_ERROR_OUT_OF_RANGE;
+            } else if(0 > lResult) {
+                return INI_BIND_ERROR_INVALID_VALUE;
+            }
+
+            if constexpr (INIFieldTraits<T>::sRanged) {
+                if((lValue < mMin) || (mMax < lValue)) {
+                    return INI_BIND_ERROR_OUT_OF_RANGE;
+                }
+            }
+
+            pOut.*mMember = std::move(lValue);
+            return INI_BIND_ERROR_NONE;
+        }
+
+        std::string_view mSection;
+        std::string_view mKey;
+        uint64_t         mHash;
+        T S::*           mMember;
+        value_type       mDefault;
+        value_type       mMin;
+        value_type       mMax;
+        bool             mRequired;
+
+    private:
+        static constexpr value_type lowest(void) {
+            if constexpr (INIFieldTraits<T>::sRanged) {
+                return std::numeric_limits<T>::lowest();
+            } else {
+                return value_type();
+            }
+        }
+
+        static constexpr value_type highest(void) {
+            if constexpr (INIFieldTraits<T>::sRanged) {
+                return std::numeric_limits<T>::max();
+            } else {
+                return value_type();
+            }
+        }
+};
+
+template<typename S, typename T>
+constexpr INIField<S, T> iniField(const std::string_view &pSection, const std::string_view &pKey, T S::*pMember) {
+    return INIField<S, T>(pSection, pKey, pMember);
+}
+
+/* INI schema class ------------------------------------ */
+/** @brief Field of a schema, as found by its hash */
+struct INIFieldSlot {
+    uint64_t         mHash;
+    size_t           mIndex;
+    std::string_view mSection;
+    std::string_view mKey;
+    bool             mRequired;
+};
+
+template<typename... F>
+class INISchema {
+    public:
+        typedef typename std::tuple_element<0U, std::tuple<F...>>::type::structure structure;
+
+        static constexpr size_t sSize = sizeof...(F);
+
+        constexpr INISchema(const F &... pFields) :
+            mFields(pFields...),
+            mSlots(sortedSlots(std::index_sequence_for<F...>(), false)),
+            mFoldedSlots(sortedSlots(std::index_sequence_for<F...>(), true))
+        {
+            /* Empty for now */
+        }
+
+        /** @brief Index of the field bound to (section, key), -1 if there is none.
+         * Folding matches the names without case. */
+        constexpr int find(const std::string_view &pSection, const std::string_view &pKey, const bool &pFold = false) const {
+            const std::array<INIFieldSlot, sSize> &lSlots = pFold ? mFoldedSlots : mSlots;
+            const uint64_t lHash = iniHash(pSection, pKey, pFold);
+
+            /* Lower bound on the hash */
+            size_t lLow = 0U, lHigh = sSize;
+            while(lLow < lHigh) {
+                const size_t lMid = lLow + ((lHigh - lLow) / 2U);
+                if(lSlots[lMid].mHash < lHash) {
+                    lLow = lMid + 1U;
+                } else {
+                    lHigh = lMid;
+                }
+            }
+
+            /* Verify the names, hashes may collide */
+            for(; (lLow < sSize) && (lHash == lSlots[lLow].mHash); ++lLow) {
+                if(equal(pSection, lSlots[lLow].mSection, pFold) && equal(pKey, lSlots[lLow].mKey, pFold)) {
+                    return static_cast<int>(lSlots[lLow].mIndex);
+                }
+            }
+
+            return -1;
+        }
+
+        void reset(structure &pOut) const {
+            std::apply([&pOut](const F &... pField) { (pField.reset(pOut), ...); }, mFields);
+        }
+
+        INIBindError assign(const size_t &pIndex, structure &pOut, const std::string_view &pValue) const {
+            static constexpr auto sAssigners = assigners(std::index_sequence_for<F...>());
+
+            return sAssigners[pIndex](*this, pOut, pValue);
+        }
+
+        std::tuple<F...>                  mFields;
+        std::array<INIFieldSlot, sSize>   mSlots;
+        std::array<INIFieldSlot, sSize>   mFoldedSlots;   /**< Same fields, by folded hash */
+
+    private:
+        typedef INIBindError (*assigner_t)(const INISchema &, structure &, const std::string_view &);
+
+        template<size_t I>
+        static INIBindError assignField(const INISchema &pSchema, structure &pOut, const std::string_view &pValue) {
+            return std::get<I>(pSchema.mFields).assign(pOut, pValue);
+        }
+
+        template<size_t... I>
+        static constexpr std::array<assigner_t, sSize> assigners(std::index_sequence<I...>) {
+            return {{ &assignField<I>... }};
+        }
+
+        static constexpr bool equal(const std::string_view &pLeft, const std::string_view &pRight, const bool &pFold) {
+            if(pLeft.size() != pRight.size()) {
+                return false;
+            }
+
+            for(size_t i = 0U; i < pLeft.size(); ++i) {
+                if(pFold ? (ININame::fold(pLeft[i]) != ININame::fold(pRight[i])) : (pLeft[i] != pRight[i])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        template<size_t... I>
+        constexpr std::array<INIFieldSlot, sSize> sortedSlots(std::index_sequence<I...>, const bool &pFold) const {
+            std::array<INIFieldSlot, sSize> lSlots = {{
+                INIFieldSlot{
+                    pFold ? iniHash(std::get<I>(mFields).mSection, std::get<I>(mFields).mKey, true) : std::get<I>(mFields).mHash,
+                    I,
+                    std::get<I>(mFields).mSection,
+                    std::get<I>(mFields).mKey,
+                    std::get<I>(mFields).mRequired
+                }...
+            }};
+
+            /* Insertion sort, std::sort is not constexpr */
+            for(size_t i = 1U; i < sSize; ++i) {
+                INIFieldSlot lSlot = lSlots[i];
+                size_t j = i;
+                for(; (0U < j) && (lSlot.mHash < lSlots[j - 1U].mHash); --j) {
+                    lSlots[j] = lSlots[j - 1U];
+                }
+                lSlots[j] = lSlot;
+            }
+
+            return lSlots;
+        }
+};
+
+template<typename... F>
+constexpr INISchema<F...> iniSchema(const F &... pFields) {
+    return INISchema<F...>(pFields...);
+}
+
+/* INI binder class ------------------------------------ */
+/** @brief Fills a structure from parser events,
+ * either replayed from a document or straight from the parser.
+ * Given the document, names and values are read in its mode.
+ */
+template<typename Schema>
+class INIBinder : public INIParserHandler {
+    public:
+        typedef typename Schema::structure structure;
+
+        INIBinder(const Schema &pSchema, structure &pOut, const INI *pDocument = nullptr) :
+            mSchema(pSchema),
+            mOut(pOut),
+            mDocument(((nullptr != pDocument) && (0U != (pDocument->mode() & INI_MODE_INTERPOLATION))) ? pDocument : nullptr),
+            mFold((nullptr != pDocument) && (0U != (pDocument->mode() & INI_MODE_CASE_INSENSITIVE))),
+            mSeen()
+        {
+            /* Empty for now */
+        }
+
+        /** @brief Applies the defaults and forgets previous issues */
+        void begin(void) {
+            mSchema.reset(mOut);
+            mSeen.fill(false);
+            mIssues.clear();
+        }
+
+        /** @brief Reports the missing keys.
+         * Returns 0 if the structure was bound without any issue, -1 otherwise */
+        int end(void) {
+            for(const auto &lSlot : mSchema.mSlots) {
+                if(lSlot.mRequired && !mSeen[lSlot.mIndex]) {
+                    report(INI_BIND_ERROR_MISSING_KEY, lSlot.mSection, lSlot.mKey, 0U);
+                }
+            }
+
+            return mIssues.empty() ? 0 : -1;
+        }
+
+        const std::vector<INIBindIssue> &issues(void) const {
+            return mIssues;
+        }
+
+        int onSection(const std::string_view &pSection, const uint32_t &pLine) override {
+            (void)pSection;
+            (void)pLine;
+            return 0;
+        }
+
+        int onEntry(const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue,
+            const uint32_t &pLine) override
+        {
+            const int lIndex = mSchema.find(pSection, pKey, mFold);
+            if(0 > lIndex) {
+                report(INI_BIND_ERROR_UNKNOWN_KEY, pSection, pKey, pLine);
+                return 0;
+            }
+
+            mSeen[lIndex] = true;
+
+            /* Replayed values are raw, interpolate them as the getters do */
+            std::string_view lValue = pValue;
+            if((nullptr != mDocument) && (0 > mDocument->getView(pKey, lValue, pSection))) {
+                report(INI_BIND_ERROR_INVALID_VALUE, pSection, pKey, pLine);
+                return 0;
+            }
+
+            const INIBindError lError = mSchema.assign(static_cast<size_t>(lIndex), mOut, lValue);
+            if(INI_BIND_ERROR_NONE != lError) {
+                report(lError, pSection, pKey, pLine);
+            }
+
+            return 0;
+        }
+
+        int onError(const INIParseError &pError, const uint32_t &pLine, const uint32_t &pColumn) override {
+            /* Syntax errors stop the binding */
+            report(INI_BIND_ERROR_SYNTAX, std::string_view(), std::string_view(), pLine);
+            mIssues.back().mSyntax = pError;
+            mIssues.back().mColumn = pColumn;
+            return -1;
+        }
+
+    private:
+        void report(const INIBindError &pError,
+            const std::string_view &pSection,
+            const std::string_view &pKey,
+            const uint32_t &pLine)
+        {
+            mIssues.push_back(INIBindIssue{pError, std::string(pSection), std::string(pKey), pLine});
+        }
+
+        const Schema                     &mSchema;
+        structure                        &mOut;
+        const INI                        *mDocument;  /**< Set to interpolate the values */
+        bool                              mFold;
+        std::array<bool, Schema::sSize>   mSeen;
+        std::vector<INIBindIssue>         mIssues;
+};
+
+/* Binding functions ----------------------------------- */
+/** @brief Fills pOut from a parsed document, in its mode.
+ * Unresolved references are reported as invalid values.
+ * Returns 0 on success, -1 if any issue was reported */
+template<typename Schema>
+int iniBind(const INI &pINI, const Schema &pSchema, typename Schema::structure &pOut, std::vector<INIBindIssue> &pIssues) {
+    INIBinder<Schema> lBinder(pSchema, pOut, &pINI);
+
+    lBinder.begin();
+    if(0 > pINI.visit(lBinder)) {
+        return -1;
+    }
+
+    int lResult = lBinder.end();
+    pIssues = lBinder.issues();
+
+    return lResult;
+}
+
+/** @brief Fills pOut straight from INI text, without building a document.
+ * Returns 0 on success, -1 on syntax errors or if any issue was reported */
+template<typename Schema>
+int iniBind(std::istream &pStream, const Schema &pSchema, typename Schema::structure &pOut, std::vector<INIBindIssue> &pIssues) {
+    INIBinder<Schema> lBinder(pSchema, pOut);
+    INIParser         lParser(lBinder);
+
+    lBinder.begin();
+    if(0 > lParser.parse(pStream)) {
+        pIssues = lBinder.issues();
+        return -1;
+    }
+
+    int lResult = lBinder.end();
+    pIssues = lBinder.issues();
+
+    return lResult;
+}
+
+#endif /* INIBINDING_HPP */
@@ -0,0 +1,89 @@
+/**
+ * @brief INI columnar extraction classes
+ *
+ * @file INIColumns.hpp
+ */
+
+#ifndef INICOLUMNS_HPP
+#define INICOLUMNS_HPP
+
+/* Includes -------------------------------------------- */
+#include "INIConvert.hpp"
+#include "INIList.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Key to extract, and the type of its column.
+ * Supported types are INT64, DOUBLE, BOOLEAN and STRING. */
+struct INIColumnSpec {
+    std::string  mKey;
+    INIValueType mType;
+};
+
+/* INI column class ------------------------------------ */
+/** @brief Values of one key across the selected sections.
+ * Rows whose key is missing, or cannot be converted,
+ * are invalid and hold a zero value.
+ */
+class INIColumn {
+    public:
+        INIColumn();
+
+        const std::string &key(void) const;
+        INIValueType type(void) const;
+        size_t size(void) const;
+
+        bool valid(const size_t &pRow) const;
+        size_t validCount(void) const;
+
+        /** @brief One bit per row, row N is bit (N % 64) of word N / 64 */
+        INIArrayView<uint64_t> validity(void) const;
+
+        /* Only the array of the column type is filled */
+        INIArrayView<int64_t> int64s(void) const;
+        INIArrayView<double> doubles(void) const;
+        INIArrayView<uint8_t> booleans(void) const;
+        INIArrayView<std::string_view> strings(void) const;
+
+    protected:
+        friend class INI;
+
+        void reset(const INIColumnSpec &pSpec, const size_t &pRows);
+
+        std::string  mKey;
+        INIValueType mType;
+        size_t       mRows;
+
+        std::vector<uint64_t>         mValidity;
+        std::vector<int64_t>          mInt64s;
+        std::vector<double>           mDoubles;
+        std::vector<uint8_t>          mBooleans;
+        std::vector<std::string_view> mStrings;
+
+    private:
+};
+
+/** @brief Struct-of-arrays view on homogeneous sections.
+ * String columns point into the document, the
+ * columns are valid until the document is modified.
+ */
+struct INIColumns {
+    std::vector<std::string_view> mSections;
+    std::vector<INIColumn>        mColumns;
+
+    size_t rows(void) const {
+        return mSections.size();
+    }
+};
+
+#endif /* INICOLUMNS_HPP */
@@ -0,0 +1,169 @@
+/**
+ * @brief INI value conversion class
+ *
+ * @file INIConvert.hpp
+ */
+
+#ifndef INICONVERT_HPP
+#define INICONVERT_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <limits>
+#include <type_traits>
+
+/* C System */
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Types a value can be converted to */
+enum INIValueType : uint32_t {
+    INI_TYPE_NONE = 0U,
+    INI_TYPE_STRING,
+    INI_TYPE_INT64,
+    INI_TYPE_UINT64,
+    INI_TYPE_DOUBLE,
+    INI_TYPE_BOOLEAN,
+};
+
+/** @brief Value converted once and kept for later reads */
+struct INITypedValue {
+    INIValueType mType;
+    union {
+        int64_t  mInt64;
+        uint64_t mUInt64;
+        double   mDouble;
+        bool     mBoolean;
+    };
+
+    INITypedValue() : mType(INI_TYPE_NONE), mUInt64(0U) {
+        /* Empty for now */
+    }
+
+    /** @brief Same as INIConvert::to, returns 1 if the
+     * stored type cannot be used to produce a T */
+    template<typename T>
+    int to(T &pValue) const;
+};
+
+/* INI value conversion class -------------------------- */
+/** @brief Conversion rules shared by the typed getters.
+ * Integers containing "0x" are read as hexadecimal,
+ * booleans are true/True/1 or false/False/0.
+ * All methods return 0 on success, -1 if the value is invalid
+ * and -2 if it does not fit in the requested type.
+ */
+class INIConvert {
+    public:
+        static int toInt64(const std::string_view &pStr, int64_t &pValue);
+        static int toUInt64(const std::string_view &pStr, uint64_t &pValue);
+        static int toDouble(const std::string_view &pStr, double &pValue);
+        static int toBoolean(const std::string_view &pStr, bool &pValue);
+        static int toTyped(const std::string_view &pStr, const INIValueType &pType, INITypedValue &pValue);
+
+        template<typename T>
+        static int to(const std::string_view &pStr, T &pValue);
+};
+
+/* Template implementation ----------------------------- */
+template<typename T>
+int INIConvert::to(const std::string_view &pStr, T &pValue) {
+    if constexpr (std::is_same<T, bool>::value) {
+        return toBoolean(pStr, pValue);
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        pValue.assign(pStr.data(), pStr.size());
+        return 0;
+    } else if constexpr (std::is_same<T, std::string_view>::value) {
+        pValue = pStr;
+        return 0;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        double lTempVal = 0.0;
+        if(0 > toDouble(pStr, lTempVal)) {
+            return -1;
+        }
+
+        pValue = static_cast<T>(lTempVal);
+        return 0;
+    } else if constexpr (std::is_signed<T>::value) {
+        int64_t lTempVal = 0;
+        if(0 > toInt64(pStr, lTempVal)) {
+            return -1;
+        }
+
+        /* Check limits */
+        if(std::numeric_limits<T>::max() < lTempVal || std::numeric_limits<T>::min() > lTempVal) {
+            return -2;
+        }
+
+        pValue = static_cast<T>(lTempVal);
+        return 0;
+    } else {
+        static_assert(std::is_unsigned<T>::value, "Unsupported INI value type");
+
+        uint64_t lTempVal = 0U;
+        if(0 > toUInt64(pStr, lTempVal)) {
+            return -1;
+        }
+
+        /* Check limits */
+        if(std::numeric_limits<T>::max() < lTempVal) {
+            return -2;
+        }
+
+        pValue = static_cast<T>(lTempVal);
+        return 0;
+    }
+}
+
+template<typename T>
+int INITypedValue::to(T &pValue) const {
+    if constexpr (std::is_same<T, bool>::value) {
+        if(INI_TYPE_BOOLEAN != mType) {
+            return 1;
+        }
+
+        pValue = mBoolean;
+        return 0;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        if(INI_TYPE_DOUBLE != mType) {
+            return 1;
+        }
+
+        pValue = static_cast<T>(mDouble);
+        return 0;
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        if(INI_TYPE_INT64 != mType) {
+            return 1;
+        }
+
+        /* Check limits */
+        if(std::numeric_limits<T>::max() < mInt64 || std::numeric_limits<T>::min() > mInt64) {
+            return -2;
+        }
+
+        pValue = static_cast<T>(mInt64);
+        return 0;
+    } else if constexpr (std::is_integral<T>::value) {
+        if(INI_TYPE_UINT64 != mType) {
+            return 1;
+        }
+
+        /* Check limits */
+        if(std::numeric_limits<T>::max() < mUInt64) {
+            return -2;
+        }
+
+        pValue = static_cast<T>(mUInt64);
+        return 0;
+    } else {
+        /* Strings are never cached */
+        (void)pValue;
+        return 1;
+    }
+}
+
+#endif /* INICONVERT_HPP */
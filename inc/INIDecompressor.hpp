@@ -0,0 +1,88 @@
+/**
+ * @brief INI stream decompressor class
+ *
+ * @file INIDecompressor.hpp
+ */
+
+#ifndef INIDECOMPRESSOR_HPP
+#define INIDECOMPRESSOR_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <istream>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Compression formats, detected from their magic bytes */
+enum INICompression : uint32_t {
+    INI_COMPRESSION_NONE = 0U,
+    INI_COMPRESSION_GZIP,   /**< Needs zlib at build time */
+    INI_COMPRESSION_ZSTD,   /**< Needs libzstd at build time */
+};
+
+struct z_stream_s;
+struct ZSTD_DCtx_s;
+
+/* INI decompressor class ------------------------------ */
+/** @brief Reads a stream, decompressing it if it starts with the
+ * magic bytes of a supported format. Only one input chunk is
+ * held, the output goes straight to the buffer of the caller.
+ */
+class INIDecompressor {
+    public:
+        explicit INIDecompressor(std::istream &pStream);
+
+        virtual ~INIDecompressor();
+
+        INIDecompressor(const INIDecompressor &) = delete;
+        INIDecompressor &operator=(const INIDecompressor &) = delete;
+
+        /** @brief Fills pOut with up to pSize bytes of text.
+         * Returns the number of bytes, 0 at the end of the
+         * stream and -1 on errors (corrupt or truncated data,
+         * format not supported by this build). */
+        long read(char *pOut, const size_t &pSize);
+
+        INICompression compression(void) const;
+
+        /** @brief Was the format enabled at build time ? */
+        static bool supports(const INICompression &pCompression);
+
+    protected:
+        int start(void);
+        long fill(void);
+
+        long readGzip(char *pOut, const size_t &pSize);
+        long readZstd(char *pOut, const size_t &pSize);
+
+        std::istream &mStream;
+
+        /** @brief Compressed bytes read but not consumed yet,
+         * from mBegin to mEnd */
+        std::vector<char> mInput;
+        size_t            mBegin;
+        size_t            mEnd;
+
+        INICompression mCompression;
+        bool           mStarted;
+
+        /** @brief End of a gzip member or zstd frame reached */
+        bool           mFinished;
+
+        /** @brief The last call filled the whole output, the
+         * decoder may hold more without needing input */
+        bool           mOutputFull;
+
+        z_stream_s  *mZlib;
+        ZSTD_DCtx_s *mZstd;
+
+    private:
+};
+
+#endif /* INIDECOMPRESSOR_HPP */
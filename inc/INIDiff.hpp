@@ -0,0 +1,82 @@
+/**
+ * @brief INI document diff class
+ *
+ * @file INIDiff.hpp
+ */
+
+#ifndef INIDIFF_HPP
+#define INIDIFF_HPP
+
+/* Includes -------------------------------------------- */
+#include "INIStringPool.hpp"
+
+/* C++ System */
+#include <vector>
+
+/* C System */
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+class INI;
+
+/** @brief Operations of an edit script */
+enum INIEditOp : uint8_t {
+    INI_EDIT_NONE = 0U,
+    INI_EDIT_ADD_SECTION,
+    INI_EDIT_REMOVE_SECTION,    /**< Removes the section and all its keys */
+    INI_EDIT_ADD_KEY,
+    INI_EDIT_REMOVE_KEY,
+    INI_EDIT_CHANGE_KEY,
+};
+
+/** @brief Edit of a script. The strings are shared with the
+ * documents, the script must not outlive them */
+struct INIEdit {
+    INIEditOp mOp;
+    INIString mSection;
+    INIString mKey;     /**< Empty for section edits */
+    INIString mValue;   /**< Empty for removals */
+};
+
+/** @brief Changes of both sides that cannot be merged */
+struct INIConflict {
+    INIEdit mOurs;
+    INIEdit mTheirs;
+};
+
+/* INI diff class -------------------------------------- */
+/** @brief Edit scripts between documents.
+ * Scripts are sorted by section then key, a section edit coming
+ * before the edits of its keys. Raw values are compared, names
+ * ignoring case if either document is case-insensitive. Every entry
+ * is compared, fingerprints being only probabilistic.
+ */
+class INIDiff {
+    public:
+        /** @brief Edits turning pFrom into pTo, found in one merge
+         * pass over the sorted sections and keys of both documents */
+        static int diff(const INI &pFrom, const INI &pTo, std::vector<INIEdit> &pScript);
+
+        /** @brief Edits bringing the changes from pBase to pTheirs into
+         * pOurs. The conflicting changes are left out of the script and
+         * reported, -1 is returned if there are any. */
+        static int merge(const INI &pBase,
+            const INI &pOurs,
+            const INI &pTheirs,
+            std::vector<INIEdit> &pScript,
+            std::vector<INIConflict> &pConflicts);
+
+        /** @brief Applies a script through the mutation API */
+        static int apply(INI &pDoc, const std::vector<INIEdit> &pScript);
+
+    protected:
+        static void mergeSection(const INIEdit *pOurs, const INIEdit *pOursEnd,
+            const INIEdit *pTheirs, const INIEdit *pTheirsEnd,
+            const bool &pFold,
+            std::vector<INIEdit> &pScript,
+            std::vector<INIConflict> &pConflicts);
+};
+
+#endif /* INIDIFF_HPP */
@@ -0,0 +1,144 @@
+/**
+ * @brief INI frozen index class
+ *
+ * @file INIFrozen.hpp
+ */
+
+#ifndef INIFROZEN_HPP
+#define INIFROZEN_HPP
+
+/* Includes -------------------------------------------- */
+#include "ININame.hpp"
+
+/* C++ System */
+#include <string_view>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+/** @brief Average number of keys per bucket of the hash */
+#define INI_FROZEN_BUCKET_SIZE 4U
+
+/* Type definitions ------------------------------------ */
+struct INIEntry;
+
+/** @brief Entry of a frozen document, at the slot given by the hash */
+struct INIFrozenSlot {
+    uint64_t         mHash;
+    std::string_view mSection;
+    std::string_view mKey;
+    const INIEntry  *mEntry;
+};
+
+/** @brief (section, key) pair to index */
+struct INIFrozenItem {
+    std::string_view mSection;
+    std::string_view mKey;
+    const INIEntry  *mEntry;
+};
+
+/* INI frozen index class ------------------------------ */
+/** @brief Minimal perfect hash over the (section, key) pairs of a
+ * document that no longer changes (CHD, "compress, hash and
+ * displace"). Pairs are spread over buckets of about
+ * INI_FROZEN_BUCKET_SIZE keys, each bucket keeps the displacement
+ * that sends its keys to free slots. A lookup is one hash, one
+ * probe and one comparison. The names must outlive the index.
+ */
+class INIFrozenIndex {
+    public:
+        explicit INIFrozenIndex(const bool &pFold = false);
+
+        /** @brief The names must be unique, folded in case-insensitive mode */
+        int build(const std::vector<INIFrozenItem> &pItems);
+
+        const INIEntry *find(const std::string_view &pSection, const std::string_view &pKey) const;
+
+        size_t size(void) const;
+        size_t memoryUsage(void) const;
+
+        static uint64_t hash(const std::string_view &pName, const uint64_t &pSeed, const bool &pFold);
+
+    protected:
+        uint64_t hash(const std::string_view &pSection, const std::string_view &pKey) const;
+        size_t bucket(const uint64_t &pHash) const;
+        size_t slot(const uint64_t &pHash, const uint32_t &pDisplacement) const;
+
+        bool     mFold;
+        uint64_t mSeed;
+
+        /** @brief Displacement of each bucket */
+        std::vector<uint32_t>      mDisplacements;
+        std::vector<INIFrozenSlot> mSlots;
+
+    private:
+};
+
+/* Inline implementation ------------------------------- */
+inline uint64_t INIFrozenIndex::hash(const std::string_view &pName, const uint64_t &pSeed, const bool &pFold) {
+    /* Eight bytes at a time, with the finalizer of MurmurHash3 */
+    static const uint64_t sMultiplier = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t lHash = pSeed ^ (pName.size() * sMultiplier);
+
+    size_t i = 0U;
+    for(; i < pName.size(); i += sizeof(uint64_t)) {
+        uint64_t lWord = 0U;
+        std::memcpy(&lWord, pName.data() + i, (pName.size() - i) < sizeof(lWord) ? (pName.size() - i) : sizeof(lWord));
+        if(pFold) {
+            lWord = ININame::foldWord(lWord);
+        }
+
+        lHash = (lHash ^ lWord) * sMultiplier;
+        lHash ^= lHash >> 32U;
+    }
+
+    lHash ^= lHash >> 33U;
+    lHash *= 0xFF51AFD7ED558CCDULL;
+    lHash ^= lHash >> 33U;
+    lHash *= 0xC4CEB9FE1A85EC53ULL;
+    lHash ^= lHash >> 33U;
+
+    return lHash;
+}
+
+inline uint64_t INIFrozenIndex::hash(const std::string_view &pSection, const std::string_view &pKey) const {
+    return hash(pKey, hash(pSection, mSeed, mFold), mFold);
+}
+
+inline size_t INIFrozenIndex::bucket(const uint64_t &pHash) const {
+    /* Range reduction without a division */
+    return static_cast<size_t>(((pHash >> 32U) * mDisplacements.size()) >> 32U);
+}
+
+inline size_t INIFrozenIndex::slot(const uint64_t &pHash, const uint32_t &pDisplacement) const {
+    uint64_t lHash = (pHash ^ (pDisplacement * 0x9E3779B97F4A7C15ULL)) * 0xFF51AFD7ED558CCDULL;
+    lHash ^= lHash >> 32U;
+
+    return static_cast<size_t>(((lHash & 0xFFFFFFFFULL) * mSlots.size()) >> 32U);
+}
+
+inline const INIEntry *INIFrozenIndex::find(const std::string_view &pSection, const std::string_view &pKey) const {
+    if(mSlots.empty()) {
+        return nullptr;
+    }
+
+    const uint64_t       lHash = hash(pSection, pKey);
+    const INIFrozenSlot &lSlot = mSlots[slot(lHash, mDisplacements[bucket(lHash)])];
+
+    /* Names that are not in the document land on any slot */
+    if((lHash != lSlot.mHash)
+        || (0 != ININame::compare(lSlot.mKey, pKey, mFold))
+        || (0 != ININame::compare(lSlot.mSection, pSection, mFold)))
+    {
+        return nullptr;
+    }
+
+    return lSlot.mEntry;
+}
+
+#endif /* INIFROZEN_HPP */
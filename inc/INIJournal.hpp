@@ -0,0 +1,137 @@
+/**
+ * @brief INI change journal class
+ *
+ * @file INIJournal.hpp
+ */
+
+#ifndef INIJOURNAL_HPP
+#define INIJOURNAL_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief First bytes of a journal, "INIJ" */
+#define INI_JOURNAL_MAGIC   0x4A494E49U
+#define INI_JOURNAL_VERSION 1U
+
+/** @brief Journal size triggering a compaction, by default */
+#define INI_JOURNAL_COMPACT_THRESHOLD (1024U * 1024U)
+
+/* Type definitions ------------------------------------ */
+class INI;
+
+/** @brief Operations recorded in a journal.
+ * Replaying them is idempotent, so a journal can be
+ * replayed over a file it was already compacted into.
+ */
+enum INIJournalOp : uint8_t {
+    INI_JOURNAL_OP_NONE = 0U,
+    INI_JOURNAL_OP_PUT,             /**< Sets a key, adding it (and its section) if needed */
+    INI_JOURNAL_OP_REMOVE_KEY,
+    INI_JOURNAL_OP_ADD_SECTION,
+    INI_JOURNAL_OP_REMOVE_SECTION,
+};
+
+/* INI journal class ----------------------------------- */
+/** @brief Write-ahead journal of the changes made to a parsed document.
+ * Each change is applied to the document, then appended to a side file.
+ * It is durable once the setter returns. Concurrent setters share
+ * one write and one fdatasync (group commit). When the journal grows
+ * past its threshold, it is compacted in the background: the document
+ * is written over its file and the journal restarts empty.
+ * While journaled, the document must only be modified through the journal.
+ *
+ * A failed write or fdatasync cannot be retried safely, so the journal
+ * fails instead : every setter whose change was not durable yet returns
+ * -1, and the later ones are refused. The document then holds changes
+ * that are not in the journal, as reported by failed(). Parse the file
+ * again and reopen the journal to come back to the durable state.
+ */
+class INIJournal {
+    public:
+        /** @brief An empty path means "<document file>.journal" */
+        INIJournal(INI &pINI, const std::string &pPath = std::string(),
+            const size_t &pThreshold = INI_JOURNAL_COMPACT_THRESHOLD);
+
+        virtual ~INIJournal();
+
+        INIJournal(const INIJournal &) = delete;
+        INIJournal &operator=(const INIJournal &) = delete;
+
+        /** @brief Replays the existing journal into the document
+         * (to be called after parseFile), and opens it for appending */
+        int open(void);
+        void close(void);
+
+        /* Journaled setters */
+        int setString(const std::string &pKey, const std::string &pValue, const std::string &pSection = "default");
+        int setInt64(const std::string &pKey, const int64_t &pValue, const std::string &pSection = "default");
+        int setUInt64(const std::string &pKey, const uint64_t &pValue, const std::string &pSection = "default");
+        int addString(const std::string &pKey, const std::string &pValue, const std::string &pSection = "default");
+        int addSection(const std::string &pSection);
+        int removeKey(const std::string &pSection, const std::string &pKey);
+        int removeSection(const std::string &pSection);
+
+        /** @brief Writes the document over its file and empties the journal */
+        int compact(void);
+
+        const std::string &path(void) const;
+        size_t size(void) const;
+
+        /** @brief A write failed, the document is ahead of the journal */
+        bool failed(void) const;
+
+    protected:
+        int replay(const std::string &pData, size_t &pValid);
+        int apply(const INIJournalOp &pOp,
+            const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue);
+
+        uint64_t append(const INIJournalOp &pOp,
+            const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue);
+        int commit(const uint64_t &pSequence);
+        int fail(const char *pFunction);
+
+        int compactLocked(std::unique_lock<std::mutex> &pLock);
+        void startCompaction(void);
+
+        INI        &mINI;
+        std::string mPath;
+        size_t      mThreshold;
+        int         mFd;
+
+        /** @brief Guards the document, the pending records and the counters */
+        mutable std::mutex      mMutex;
+        std::condition_variable mCondition;
+
+        /** @brief Records appended but not written yet */
+        std::string mPending;
+        uint64_t    mAppended;
+        uint64_t    mDurable;
+        bool        mSyncing;
+        bool        mCompacting;
+        bool        mFailed;
+
+        /** @brief Bytes in the journal file, written or pending */
+        size_t mSize;
+
+        /** @brief Background compaction, guarded by mMutex */
+        std::thread mCompactor;
+
+    private:
+};
+
+#endif /* INIJOURNAL_HPP */
@@ -0,0 +1,61 @@
+/**
+ * @brief INI JSON writer class
+ *
+ * @file INIJson.hpp
+ */
+
+#ifndef INIJSON_HPP
+#define INIJSON_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string_view>
+#include <functional>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief Size of the chunks handed to the sink, by default */
+#define INI_JSON_CHUNK_SIZE 65536U
+
+/* Type definitions ------------------------------------ */
+/** @brief JSON export options, to be OR'ed together */
+enum INIJsonFlag : uint32_t {
+    INI_JSON_DEFAULT = 0x00000000U, /**< One object of sections, values as strings */
+    INI_JSON_NDJSON  = 0x00000001U, /**< One {"section":..., "values":{...}} line per section */
+    INI_JSON_TYPED   = 0x00000002U, /**< Booleans and numbers inferred with the getters' rules */
+};
+
+/** @brief Receives the output, returning a negative value stops the export */
+typedef std::function<int(const char *pData, const size_t &pSize)> INIWriteCallback;
+
+/* INI JSON writer class ------------------------------- */
+/** @brief Buffers JSON text and hands it to a sink in fixed-size chunks.
+ * Once the sink failed, every call fails.
+ */
+class INIJsonWriter {
+    public:
+        INIJsonWriter(const INIWriteCallback &pSink, const size_t &pChunkSize = INI_JSON_CHUNK_SIZE);
+
+        int write(const std::string_view &pText);
+
+        /** @brief Writes pStr quoted, escaping it as needed.
+         * Eight bytes are checked at a time. */
+        int writeString(const std::string_view &pStr);
+
+        int flush(void);
+
+    protected:
+        INIWriteCallback mSink;
+
+        std::vector<char> mBuffer;
+        size_t            mSize;
+        bool              mFailed;
+
+    private:
+};
+
+#endif /* INIJSON_HPP */
@@ -0,0 +1,130 @@
+/**
+ * @brief INI list value class
+ *
+ * @file INIList.hpp
+ */
+
+#ifndef INILIST_HPP
+#define INILIST_HPP
+
+/* Includes -------------------------------------------- */
+#include "INIConvert.hpp"
+
+/* C++ System */
+#include <string_view>
+#include <vector>
+#include <forward_list>
+#include <new>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Read-only view on a contiguous array of elements */
+template<typename T>
+class INIArrayView {
+    public:
+        INIArrayView() : mData(nullptr), mSize(0U) {}
+        INIArrayView(const T *pData, const size_t &pSize) : mData(pData), mSize(pSize) {}
+
+        const T *data(void) const { return mData; }
+        size_t size(void) const { return mSize; }
+        bool empty(void) const { return 0U == mSize; }
+
+        const T *begin(void) const { return mData; }
+        const T *end(void) const { return mData + mSize; }
+
+        const T &operator[](const size_t &pIndex) const { return mData[pIndex]; }
+
+    protected:
+        const T *mData;
+        size_t   mSize;
+};
+
+/** @brief Elements of a list converted to one type */
+struct INIListArray {
+    /** @brief Converted elements, of the type identified by mTag */
+    std::vector<uint64_t> mValues;
+    const void           *mTag;
+    int                   mResult;
+};
+
+/* INI list class -------------------------------------- */
+/** @brief Value split on a delimiter, with its converted elements.
+ * Like split, the list stops at the first empty element.
+ * Elements are trimmed views on the value, nothing is copied.
+ * Each requested conversion is kept in its own array, so that the
+ * views handed out stay valid until the list is dropped.
+ */
+class INIList {
+    public:
+        INIList();
+
+        int assign(const std::string_view &pValue, const char &pDelim);
+
+        char delimiter(void) const;
+        INIArrayView<std::string_view> items(void) const;
+
+        /** @brief Converts the elements with INIConvert::to,
+         * returns 0, -1 or -2 like INIConvert */
+        template<typename T>
+        int array(INIArrayView<T> &pArray);
+
+    protected:
+        template<typename T>
+        static const void *tag(void) {
+            static const char sTag = 0;
+            return &sTag;
+        }
+
+        std::vector<std::string_view> mItems;
+        char mDelim;
+
+        /** @brief One array per type, never moved once converted */
+        std::forward_list<INIListArray> mArrays;
+
+    private:
+};
+
+/* Template implementation ----------------------------- */
+template<typename T>
+int INIList::array(INIArrayView<T> &pArray) {
+    static_assert((sizeof(T) <= sizeof(uint64_t)) && (alignof(T) <= alignof(uint64_t)),
+        "Unsupported INI array element type");
+
+    INIListArray *lArray = nullptr;
+    for(auto &lElmt : mArrays) {
+        if(tag<T>() == lElmt.mTag) {
+            lArray = &lElmt;
+            break;
+        }
+    }
+
+    if(nullptr == lArray) {
+        /* Convert the elements once, in place */
+        lArray = &mArrays.emplace_front();
+        lArray->mValues.assign((mItems.size() * sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t), 0U);
+        lArray->mTag    = tag<T>();
+        lArray->mResult = 0;
+
+        unsigned char *lBytes = reinterpret_cast<unsigned char *>(lArray->mValues.data());
+        for(size_t i = 0U; (i < mItems.size()) && (0 == lArray->mResult); ++i) {
+            T lValue = T();
+            lArray->mResult = INIConvert::to(mItems[i], lValue);
+            new (lBytes + i * sizeof(T)) T(lValue);
+        }
+    }
+
+    if(0 != lArray->mResult) {
+        pArray = INIArrayView<T>();
+        return lArray->mResult;
+    }
+
+    pArray = INIArrayView<T>(std::launder(reinterpret_cast<const T *>(lArray->mValues.data())), mItems.size());
+    return 0;
+}
+
+#endif /* INILIST_HPP */
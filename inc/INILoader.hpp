@@ -0,0 +1,74 @@
+/**
+ * @brief INI asynchronous loader class
+ *
+ * @file INILoader.hpp
+ */
+
+#ifndef INILOADER_HPP
+#define INILOADER_HPP
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+#include "INIThreadPool.hpp"
+
+/* C++ System */
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <functional>
+#include <exception>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Called from a worker once a file is loaded.
+ * pResult is 0 on success, pINI is nullptr otherwise.
+ */
+typedef std::function<void(const std::string &pFile, int pResult, std::unique_ptr<INI> pINI)> INILoadCallback;
+
+/** @brief Same as INILoadCallback, with the exception
+ * thrown while loading, if any */
+typedef std::function<void(const std::string &pFile, int pResult, std::unique_ptr<INI> pINI, std::exception_ptr pError)> INILoadHandler;
+
+/* INI loader class ------------------------------------ */
+/** @brief Loads many INI files concurrently.
+ * The reads of every file are requested from the kernel by a
+ * prefetching thread as soon as the file is submitted, so the workers
+ * parse files already being read ahead while the others are still on
+ * their way. Each file completes on its own, in no particular order.
+ * An exception thrown while loading fails that file only : the future
+ * rethrows it, the callback gets -1.
+ * The destructor waits for the pending loads.
+ */
+class INILoader {
+    public:
+        /** @brief 0 workers means one per hardware thread */
+        explicit INILoader(const size_t &pWorkers = 0U);
+
+        virtual ~INILoader();
+
+        /** @brief The future throws an INIException if the file cannot be loaded */
+        std::future<std::unique_ptr<INI>> load(const std::string &pFile, const uint32_t &pMode = INI_MODE_DEFAULT);
+        void load(const std::string &pFile, INILoadCallback pCallback, const uint32_t &pMode = INI_MODE_DEFAULT);
+
+        std::vector<std::future<std::unique_ptr<INI>>> load(const std::vector<std::string> &pFiles, const uint32_t &pMode = INI_MODE_DEFAULT);
+
+    protected:
+        void submit(const std::string &pFile, const uint32_t &pMode, INILoadHandler pHandler);
+
+        static void prefetch(const std::string &pFile);
+
+        /** @brief Opens and advises the files, off the caller's thread */
+        INIThreadPool mPrefetcher;
+
+        INIThreadPool mPool;
+
+    private:
+};
+
+#endif /* INILOADER_HPP */
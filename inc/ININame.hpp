@@ -0,0 +1,80 @@
+/**
+ * @brief INI name comparison class
+ *
+ * @file ININame.hpp
+ */
+
+#ifndef ININAME_HPP
+#define ININAME_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+#define INI_NAME_ONES 0x0101010101010101ULL
+
+/* Type definitions ------------------------------------ */
+
+/* INI name class -------------------------------------- */
+/** @brief ASCII case folding of section and key names.
+ * Only 'A' to 'Z' are folded, other bytes (UTF-8 included)
+ * are compared as they are. Eight bytes are handled at a time.
+ */
+class ININame {
+    public:
+        static constexpr char fold(const char &pChar) {
+            return (('A' <= pChar) && ('Z' >= pChar)) ? static_cast<char>(pChar + ('a' - 'A')) : pChar;
+        }
+
+        /** @brief Folds the eight bytes of a word at once */
+        static uint64_t foldWord(const uint64_t &pWord) {
+            /* The high bit of each byte is cleared, so that the additions never carry */
+            const uint64_t lAscii = pWord & (0x7FULL * INI_NAME_ONES);
+            const uint64_t lAbove = lAscii + ((0x80ULL - 'A') * INI_NAME_ONES);        /* >= 'A' */
+            const uint64_t lBelow = lAscii + ((0x80ULL - 'Z' - 1ULL) * INI_NAME_ONES); /* >  'Z' */
+
+            /* 0x80 in the upper case bytes, 0x20 once shifted */
+            const uint64_t lUpper = lAbove & ~lBelow & ~pWord & (0x80ULL * INI_NAME_ONES);
+
+            return pWord | (lUpper >> 2U);
+        }
+
+        /** @brief Folds in place */
+        static void fold(char *pData, const size_t &pSize);
+        static std::string folded(const std::string_view &pName);
+
+        /** @brief Three-way comparison, as std::string_view::compare */
+        static int compare(const std::string_view &pLeft, const std::string_view &pRight, const bool &pFold);
+};
+
+/** @brief Ordering of section and key names,
+ * usable with any string-like type (transparent).
+ * Case-insensitive when folding.
+ */
+struct ININameLess {
+    typedef void is_transparent;
+
+    explicit ININameLess(const bool &pFold = false) : mFold(pFold) {}
+
+    bool operator()(const std::string_view &pLeft, const std::string_view &pRight) const {
+        return mFold ? (0 > ININame::compare(pLeft, pRight, true)) : (pLeft < pRight);
+    }
+
+    bool equal(const std::string_view &pLeft, const std::string_view &pRight) const {
+        return mFold ? (0 == ININame::compare(pLeft, pRight, true)) : (pLeft == pRight);
+    }
+
+    bool folds(void) const {
+        return mFold;
+    }
+
+    bool mFold;
+};
+
+#endif /* ININAME_HPP */
@@ -0,0 +1,140 @@
+/**
+ * @brief INI streaming parser class
+ *
+ * @file INIParser.hpp
+ */
+
+#ifndef INIPARSER_HPP
+#define INIPARSER_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <istream>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief Size of the chunks read from streams */
+#define INI_PARSER_CHUNK_SIZE 65536U
+
+/* Type definitions ------------------------------------ */
+/** @brief Syntax errors reported by the parser */
+enum INIParseError : uint32_t {
+    INI_PARSE_ERROR_NONE = 0U,
+    INI_PARSE_ERROR_UNCLOSED_SECTION,   /**< '[' without a matching ']' */
+    INI_PARSE_ERROR_EMPTY_KEY,          /**< Line starting with '=' */
+    INI_PARSE_ERROR_NO_EQUAL_SIGN,      /**< Neither a section, a comment nor a key/value pair */
+    INI_PARSE_ERROR_INVALID_PAIR,       /**< More than one '=' on the line */
+    INI_PARSE_ERROR_UNCLOSED_QUOTE,     /**< Quoted value without its closing '"' */
+    INI_PARSE_ERROR_INVALID_ESCAPE,     /**< Unknown escape sequence in a quoted value */
+    INI_PARSE_ERROR_TEXT_AFTER_QUOTE,   /**< Text after the closing '"' of a value */
+    INI_PARSE_ERROR_DUPLICATE_SECTION,  /**< Section defined twice, reported by the document */
+    INI_PARSE_ERROR_DUPLICATE_KEY,      /**< Key defined twice in a section, reported by the document */
+};
+
+/** @brief Problem found in a file. Columns start at 1,
+ * 0 meaning that the whole line is concerned. */
+struct INIDiagnostic {
+    uint32_t      mLine;
+    uint32_t      mColumn;
+    INIParseError mKind;
+};
+
+/** @brief Parser options, to be OR'ed together */
+enum INIParserOption : uint32_t {
+    INI_PARSER_STRICT    = 0x00000000U,
+    INI_PARSER_MULTILINE = 0x00000001U, /**< '=' in values, continuation lines and quoted values */
+    INI_PARSER_INDENTED  = 0x00000002U, /**< With INI_PARSER_MULTILINE, indented lines continue the value */
+};
+
+/* INI parser handler class ---------------------------- */
+/** @brief Receives the parsed elements, in file order.
+ * The views are only valid for the duration of the call.
+ * Returning a negative value stops the parser. Returning 0
+ * from onError skips the rest of the line, parsing goes on
+ * with the next one.
+ */
+class INIParserHandler {
+    public:
+        virtual ~INIParserHandler() {}
+
+        virtual int onSection(const std::string_view &pSection, const uint32_t &pLine) = 0;
+        virtual int onEntry(const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue,
+            const uint32_t &pLine) = 0;
+        virtual int onError(const INIParseError &pError, const uint32_t &pLine, const uint32_t &pColumn) = 0;
+};
+
+/* INI parser class ------------------------------------ */
+/** @brief Push parser, fed with arbitrary chunks of INI text.
+ * With INI_PARSER_MULTILINE, values are split on the first '=',
+ * a trailing '\\' joins the next line, and "quoted values" may span
+ * lines and hold the \\n, \\t, \\r, \\\\ and \\" escapes.
+ * Indented lines are parsed on their own, unless INI_PARSER_INDENTED
+ * is set too : then an indented line continues a plain value on a new
+ * line, whatever it holds.
+ * An entry is reported once its value is complete, at its first line.
+ */
+class INIParser {
+    public:
+        INIParser(INIParserHandler &pHandler, const uint32_t &pOptions = INI_PARSER_STRICT);
+
+        virtual ~INIParser();
+
+        /* Parser */
+        int feed(const char *pData, const size_t &pSize);
+        int finish(void);
+
+        /** @brief Parses a whole stream, gzip or zstd compressed
+         * streams being detected and decompressed on the fly */
+        int parse(std::istream &pStream);
+        void reset(void);
+
+        /* Getters */
+        uint32_t line(void) const;
+        const std::string &section(void) const;
+
+        static const char *errorName(const INIParseError &pError);
+
+    protected:
+        int parseLine(std::string_view pLine);
+
+        /* Multi-line values */
+        bool continueValue(const std::string_view &pLine, int &pResult);
+        int beginValue(const std::string_view &pKey, const std::string_view &pValue);
+        void appendPlain(const std::string_view &pText);
+        int appendQuoted(const std::string_view &pText);
+        int flushValue(void);
+
+        /** @brief Column of a character of the line being parsed */
+        uint32_t columnOf(const char *pChar) const;
+
+        INIParserHandler &mHandler;
+        uint32_t          mOptions;
+
+        /** @brief Incomplete line carried over from the previous chunk */
+        std::string mPending;
+        std::string mSection;
+        uint32_t    mLine;
+        bool        mStopped;
+
+        /** @brief Start of the line being parsed */
+        const char *mLineBegin;
+
+        /** @brief Entry whose value may go on, the buffers
+         * keep their capacity from one entry to the next */
+        std::string mKey;
+        std::string mValue;
+        uint32_t    mValueLine;
+        uint32_t    mValueColumn;
+        uint32_t    mValueState;
+
+    private:
+};
+
+#endif /* INIPARSER_HPP */
@@ -0,0 +1,36 @@
+/**
+ * @brief INI name pattern class
+ *
+ * @file INIPattern.hpp
+ */
+
+#ifndef INIPATTERN_HPP
+#define INIPATTERN_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string_view>
+
+/* C System */
+#include <cstddef>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI pattern class ----------------------------------- */
+/** @brief Regex-free glob patterns.
+ * '*' matches any sequence, '?' any character,
+ * "[a-z0-9_]" a character class and "[!...]" its complement.
+ */
+class INIPattern {
+    public:
+        static bool isPattern(const std::string_view &pPattern);
+        static std::string_view prefix(const std::string_view &pPattern);
+        static bool match(const std::string_view &pPattern, const std::string_view &pStr);
+
+    protected:
+        static bool matchOne(const std::string_view &pPattern, size_t &pPos, const char &pChar);
+};
+
+#endif /* INIPATTERN_HPP */
@@ -0,0 +1,142 @@
+/**
+ * @brief INI name query class
+ *
+ * @file INIQuery.hpp
+ */
+
+#ifndef INIQUERY_HPP
+#define INIQUERY_HPP
+
+/* Includes -------------------------------------------- */
+#include "INIPattern.hpp"
+#include "ININame.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <iterator>
+
+/* C System */
+#include <cstddef>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI name query class -------------------------------- */
+/** @brief Lazy view on the names of a sorted map matching a glob pattern.
+ * The literal prefix of the pattern is looked up with a binary search,
+ * then only the names sharing that prefix are visited.
+ * In case-insensitive mode, the pattern and the names are folded.
+ * The view must not outlive the document, nor be used
+ * after the queried section has been removed.
+ */
+template<typename Map>
+class ININameQuery {
+    public:
+        class iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef std::string_view          value_type;
+                typedef std::ptrdiff_t            difference_type;
+                typedef const std::string_view   *pointer;
+                typedef std::string_view          reference;
+
+                iterator() : mQuery(nullptr) {}
+                iterator(const ININameQuery *pQuery, const typename Map::const_iterator &pIt) :
+                    mQuery(pQuery),
+                    mIt(pIt)
+                {
+                    skip();
+                }
+
+                std::string_view operator*(void) const { return mIt->first; }
+                const typename Map::mapped_type &value(void) const { return mIt->second; }
+
+                iterator &operator++(void) {
+                    ++mIt;
+                    skip();
+                    return *this;
+                }
+
+                iterator operator++(int) {
+                    iterator lOld = *this;
+                    ++(*this);
+                    return lOld;
+                }
+
+                bool operator==(const iterator &pOther) const { return mIt == pOther.mIt; }
+                bool operator!=(const iterator &pOther) const { return mIt != pOther.mIt; }
+
+            protected:
+                /** @brief Moves to the next matching name, or to the end */
+                void skip(void) {
+                    while(mQuery->mLast != mIt) {
+                        std::string_view lName = mIt->first;
+                        if(0 != lName.compare(0U, mQuery->mPrefix.size(), mQuery->mPrefix)) {
+                            /* Past the names sharing the prefix */
+                            mIt = mQuery->mLast;
+                            break;
+                        }
+
+                        if(mQuery->mExact || INIPattern::match(mQuery->mPattern, lName)) {
+                            break;
+                        }
+
+                        ++mIt;
+                    }
+                }
+
+                const ININameQuery *mQuery;
+                typename Map::const_iterator mIt;
+        };
+
+        ININameQuery() : mExact(false) {}
+
+        ININameQuery(const Map &pMap, const std::string_view &pPattern) :
+            mPattern(pPattern),
+            mPrefix(INIPattern::prefix(pPattern)),
+            mExact(false),
+            mFirst(pMap.lower_bound(mPrefix)),
+            mLast(pMap.end())
+        {
+            if(pMap.key_comp().folds()) {
+                /* The names are stored folded */
+                ININame::fold(&mPattern[0U], mPattern.size());
+                ININame::fold(&mPrefix[0U], mPrefix.size());
+            }
+
+            if(!INIPattern::isPattern(pPattern)) {
+                /* Plain name, at most one match */
+                mFirst = pMap.find(mPattern);
+                mLast  = (pMap.end() == mFirst) ? mFirst : std::next(mFirst);
+                mExact = true;
+            } else if(mPrefix.size() == mPattern.size() - 1U && '*' == mPattern.back()) {
+                /* "prefix*", every name in the prefix range matches */
+                mExact = true;
+            }
+        }
+
+        iterator begin(void) const { return iterator(this, mFirst); }
+        iterator end(void) const { return iterator(this, mLast); }
+
+        bool empty(void) const { return begin() == end(); }
+
+        size_t count(void) const {
+            return static_cast<size_t>(std::distance(begin(), end()));
+        }
+
+    protected:
+        std::string mPattern;
+        std::string mPrefix;
+
+        /** @brief Every name sharing the prefix matches */
+        bool mExact;
+
+        typename Map::const_iterator mFirst;
+        typename Map::const_iterator mLast;
+
+    private:
+};
+
+#endif /* INIQUERY_HPP */
@@ -0,0 +1,127 @@
+/**
+ * @brief INI document registry class
+ *
+ * @file INIRegistry.hpp
+ */
+
+#ifndef INIREGISTRY_HPP
+#define INIREGISTRY_HPP
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <vector>
+#include <future>
+#include <atomic>
+#include <shared_mutex>
+#include <functional>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief Number of shards, by default */
+#define INI_REGISTRY_SHARDS 16U
+
+/* Type definitions ------------------------------------ */
+/** @brief Loads the document of a name, nullptr on failure.
+ * Called without any lock held, possibly from several threads. */
+typedef std::function<std::unique_ptr<INI>(const std::string &pName)> INIRegistryLoader;
+
+/** @brief Document of a name, being loaded until mLoaded is set */
+struct INIRegistrySlot {
+    std::shared_future<std::shared_ptr<const INI>> mDocument;
+
+    /** @brief Footprint of the document, counted in the budget once loaded */
+    size_t mBytes;
+    bool   mLoaded;
+
+    /** @brief Set by lookups, cleared by the clock hand */
+    std::atomic<bool> mReferenced;
+};
+
+/** @brief Part of the registry, with its own lock and clock hand */
+struct alignas(64) INIRegistryShard {
+    mutable std::shared_mutex mMutex;
+
+    std::map<std::string, INIRegistrySlot, std::less<>> mSlots;
+    std::map<std::string, INIRegistrySlot, std::less<>>::iterator mHand;
+
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+    std::atomic<uint64_t> mWaits;
+    std::atomic<uint64_t> mEvictions;
+};
+
+/* INI registry class ---------------------------------- */
+/** @brief Documents by name, loaded on first use and evicted
+ * (CLOCK, second chance) when their footprint, as given by
+ * INI::memoryUsage, goes over the budget.
+ * Names are spread over shards. A hit takes the shared lock of
+ * one shard and does not allocate. Concurrent misses on the same
+ * name wait for a single load. An evicted document stays alive
+ * as long as the callers hold it.
+ */
+class INIRegistry {
+    public:
+        /** @brief A budget of 0 means no limit, an empty
+         * loader parses the name as a file path */
+        explicit INIRegistry(const size_t &pBudget,
+            const INIRegistryLoader &pLoader = INIRegistryLoader(),
+            const size_t &pShards = INI_REGISTRY_SHARDS);
+
+        virtual ~INIRegistry();
+
+        INIRegistry(const INIRegistry &) = delete;
+        INIRegistry &operator=(const INIRegistry &) = delete;
+
+        /** @brief nullptr if the document cannot be loaded */
+        std::shared_ptr<const INI> get(const std::string_view &pName);
+
+        /** @brief Drops a document, to be loaded again on next use.
+         * Documents being loaded are not dropped. */
+        void erase(const std::string_view &pName);
+        void clear(void);
+
+        size_t budget(void) const;
+        size_t usage(void) const;
+        size_t size(void) const;
+
+        uint64_t hits(void) const;
+        uint64_t misses(void) const;
+
+        /** @brief Lookups that waited on the load of another thread,
+         * counted neither as hits nor as misses */
+        uint64_t waits(void) const;
+        uint64_t evictions(void) const;
+
+    protected:
+        INIRegistryShard &shard(const std::string_view &pName);
+
+        std::shared_ptr<const INI> load(INIRegistryShard &pShard, const std::string_view &pName);
+
+        /* Eviction */
+        void evict(void);
+        size_t sweep(INIRegistryShard &pShard);
+        void erase(INIRegistryShard &pShard, std::map<std::string, INIRegistrySlot, std::less<>>::iterator pIt);
+
+        const size_t      mBudget;
+        INIRegistryLoader mLoader;
+
+        std::vector<std::unique_ptr<INIRegistryShard>> mShards;
+
+        std::atomic<size_t> mUsage;
+
+        /** @brief Shard the next eviction starts from */
+        std::atomic<size_t> mNextShard;
+
+    private:
+};
+
+#endif /* INIREGISTRY_HPP */
@@ -0,0 +1,108 @@
+/**
+ * @brief INI runtime schema class
+ *
+ * @file INIRuntimeSchema.hpp
+ */
+
+#ifndef INIRUNTIMESCHEMA_HPP
+#define INIRUNTIMESCHEMA_HPP
+
+/* Includes -------------------------------------------- */
+#include "INIConvert.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+#include <functional>
+
+/* C System */
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Schema violations reported while parsing */
+enum INIViolationKind : uint32_t {
+    INI_VIOLATION_NONE = 0U,
+    INI_VIOLATION_UNKNOWN_SECTION,      /**< The section is not allowed */
+    INI_VIOLATION_UNKNOWN_KEY,          /**< The key is not declared in its section */
+    INI_VIOLATION_MISSING_SECTION,      /**< A required section is not in the file */
+    INI_VIOLATION_MISSING_KEY,          /**< A required key is not in the file */
+    INI_VIOLATION_INVALID_TYPE,         /**< The value cannot be converted to the declared type */
+    INI_VIOLATION_OUT_OF_RANGE,         /**< The value is out of the declared range */
+    INI_VIOLATION_PATTERN_MISMATCH,     /**< The value does not match the declared pattern */
+};
+
+struct INIViolation {
+    INIViolationKind mKind;
+    std::string      mSection;
+    std::string      mKey;
+    uint32_t         mLine;
+};
+
+/** @brief Rule applied to the value of one key */
+struct INIKeyRule {
+    INIValueType  mType;
+    bool          mRequired;
+    bool          mHasRange;
+    INITypedValue mMin;
+    INITypedValue mMax;
+    std::string   mPattern;
+};
+
+/** @brief Rule applied to a section, the name may be a pattern */
+struct INISectionRule {
+    std::string mName;
+    bool        mRequired;
+    std::map<std::string, INIKeyRule, std::less<>> mKeys;
+};
+
+/* INI runtime schema class ---------------------------- */
+class INIRuntimeSchema {
+    public:
+        INIRuntimeSchema();
+
+        virtual ~INIRuntimeSchema();
+
+        /* Declarations */
+        int addSection(const std::string &pSection, const bool &pRequired = false);
+        int addKey(const std::string &pSection,
+            const std::string &pKey,
+            const INIValueType &pType,
+            const bool &pRequired = false);
+
+        int setIntRange(const std::string &pSection, const std::string &pKey, const int64_t &pMin, const int64_t &pMax);
+        int setUIntRange(const std::string &pSection, const std::string &pKey, const uint64_t &pMin, const uint64_t &pMax);
+        int setDoubleRange(const std::string &pSection, const std::string &pKey, const double &pMin, const double &pMax);
+        int setPattern(const std::string &pSection, const std::string &pKey, const std::string &pPattern);
+
+        void allowUnknownSections(const bool &pAllow);
+        void allowUnknownKeys(const bool &pAllow);
+
+        /* Validation */
+        const INISectionRule *findSection(const std::string_view &pSection) const;
+        INIViolationKind checkSection(const std::string_view &pSection, const INISectionRule *&pRule) const;
+        INIViolationKind checkValue(const INISectionRule *pRule,
+            const std::string_view &pKey,
+            const std::string_view &pValue,
+            INITypedValue &pTyped) const;
+
+        const std::vector<INISectionRule> &sections(void) const;
+
+    protected:
+        INIKeyRule *findKey(const std::string &pSection, const std::string &pKey);
+
+        /** @brief Sections with a literal name, by name, then the patterns */
+        std::vector<INISectionRule> mSections;
+        std::map<std::string, size_t, std::less<>> mSectionIndex;
+        std::vector<size_t> mPatternSections;
+
+        bool mAllowUnknownSections;
+        bool mAllowUnknownKeys;
+
+    private:
+};
+
+#endif /* INIRUNTIMESCHEMA_HPP */
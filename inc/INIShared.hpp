@@ -0,0 +1,148 @@
+/**
+ * @brief INI shared memory image class
+ *
+ * @file INIShared.hpp
+ */
+
+#ifndef INISHARED_HPP
+#define INISHARED_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <atomic>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief First bytes of an image, "INIS" */
+#define INI_SHARED_MAGIC   0x53494E49U
+#define INI_SHARED_VERSION 2U
+
+/** @brief The names of the image are folded, and looked up ignoring case */
+#define INI_SHARED_FLAG_FOLDED 0x00000001U
+
+/* Type definitions ------------------------------------ */
+class INI;
+
+/** @brief String of an image, as an offset in its string table.
+ * Strings are '\0' terminated.
+ */
+struct INISharedString {
+    uint32_t mOffset;
+    uint32_t mSize;
+};
+
+/** @brief Entry of an image */
+struct INISharedEntry {
+    INISharedString mKey;
+    INISharedString mValue;
+};
+
+/** @brief Section of an image, with the range of its entries */
+struct INISharedSection {
+    INISharedString mName;
+    uint32_t        mFirstEntry;
+    uint32_t        mEntryCount;
+};
+
+/** @brief Head of an image. The sections, the entries of each
+ * section and the strings follow, sections and entries sorted
+ * by name. Every reference is an offset, so the image can be
+ * mapped at any address.
+ */
+struct INISharedHeader {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mFlags;
+    uint32_t mReserved;
+    uint64_t mSize;
+    uint64_t mGeneration;
+    uint32_t mSectionCount;
+    uint32_t mEntryCount;
+    uint64_t mSectionsOffset;
+    uint64_t mEntriesOffset;
+    uint64_t mStringsOffset;
+};
+
+/** @brief Control segment, naming the current image */
+struct INISharedControl {
+    std::atomic<uint64_t> mGeneration;
+};
+
+/* INI shared configuration class ---------------------- */
+/** @brief Read-only configuration published in POSIX shared memory.
+ * One process publishes a parsed document under a name, as the
+ * segment "<name>.<generation>", then switches the control segment
+ * "<name>" to it. The other processes attach to the current image
+ * and read values straight from the mapping, and call refresh()
+ * to move to a newer image. Publishing again unlinks the previous
+ * image, processes still mapping it keep it until they move on.
+ * Existing segments are never replaced : a generation whose segment
+ * is left over is skipped, and of two concurrent publications only
+ * the first to switch the control segment succeeds.
+ * Raw values are published, they are not interpolated.
+ */
+class INISharedConfig {
+    public:
+        INISharedConfig();
+
+        virtual ~INISharedConfig();
+
+        INISharedConfig(const INISharedConfig &) = delete;
+        INISharedConfig &operator=(const INISharedConfig &) = delete;
+
+        /* Publisher */
+        static int publish(const INI &pINI, const std::string &pName);
+        static int unlink(const std::string &pName);
+
+        /* Images as plain bytes, e.g. binary snapshot files.
+         * Sections and entries come back in name order. */
+        static int serialize(const INI &pINI, std::string &pImage);
+        static int deserialize(const std::string_view &pImage, INI &pINI);
+
+        /* Workers */
+        int attach(const std::string &pName);
+        int refresh(void);
+        void detach(void);
+
+        uint64_t generation(void) const;
+        size_t sectionCount(void) const;
+
+        /** @brief The views point into the image,
+         * they stay valid until the next refresh or detach */
+        int getValue(const std::string_view &pKey,
+            std::string_view &pOut,
+            const std::string_view &pSection = "default") const;
+
+    protected:
+        /** @brief Checks every offset and count of an image against its size */
+        static int check(const std::string_view &pImage);
+
+        int map(const uint64_t &pGeneration);
+        void unmap(void);
+
+        std::string_view string(const INISharedString &pString) const;
+        const INISharedSection *findSection(const std::string_view &pSection) const;
+
+        std::string mName;
+
+        const INISharedControl *mControl;
+        const INISharedHeader  *mHeader;
+
+        /** @brief Length of the mapping of the image, the header
+         * being writable by other processes */
+        size_t mMapped;
+
+        /* Sorted arrays and string table of the mapped image */
+        const INISharedSection *mSections;
+        const INISharedEntry   *mEntries;
+        const char             *mStrings;
+
+    private:
+};
+
+#endif /* INISHARED_HPP */
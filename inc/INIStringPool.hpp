@@ -0,0 +1,144 @@
+/**
+ * @brief INI string pool class
+ *
+ * @file INIStringPool.hpp
+ */
+
+#ifndef INISTRINGPOOL_HPP
+#define INISTRINGPOOL_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief Identity of an interned string.
+ * Two names interned in the same pool compare equal
+ * if and only if their atoms are equal. 0 is never a valid atom.
+ */
+typedef uintptr_t INIAtom;
+
+/* Forward declarations -------------------------------- */
+class INIStringPool;
+
+/** @brief Storage node of a pooled string.
+ * The characters (and a terminating '\0') are stored
+ * right after the node, in the same allocation.
+ */
+struct INIStringNode {
+    INIStringPool        *mPool;
+    std::atomic<uint32_t> mRefs;
+    size_t                mSize;
+
+    const char *data(void) const {
+        return reinterpret_cast<const char *>(this + 1);
+    }
+};
+
+/* INI string class ------------------------------------ */
+/** @brief Reference counted handle on a pooled string.
+ * The count is atomic : handles on the strings of a document may be
+ * copied and dropped from several threads while the document is not
+ * modified. Acquiring a string and dropping its last reference only
+ * happen through modifications of the document, which are not.
+ */
+class INIString {
+    public:
+        INIString();
+        INIString(const INIString &pOther);
+        INIString(INIString &&pOther) noexcept;
+
+        ~INIString();
+
+        INIString &operator=(const INIString &pOther);
+        INIString &operator=(INIString &&pOther) noexcept;
+
+        std::string_view view(void) const {
+            return (nullptr == mNode) ? std::string_view() : std::string_view(mNode->data(), mNode->mSize);
+        }
+
+        const char *c_str(void) const {
+            return (nullptr == mNode) ? "" : mNode->data();
+        }
+
+        size_t size(void) const {
+            return (nullptr == mNode) ? 0U : mNode->mSize;
+        }
+
+        bool empty(void) const {
+            return 0U == size();
+        }
+
+        INIAtom atom(void) const {
+            return reinterpret_cast<INIAtom>(mNode);
+        }
+
+        std::string str(void) const {
+            return std::string(view());
+        }
+
+        operator std::string_view(void) const {
+            return view();
+        }
+
+    private:
+        friend class INIStringPool;
+
+        explicit INIString(INIStringNode *pNode);
+
+        INIStringNode *mNode;
+};
+
+/* INI string pool class ------------------------------- */
+class INIStringPool {
+    public:
+        INIStringPool(const bool &pDeduplicate = false);
+
+        virtual ~INIStringPool();
+
+        INIStringPool(const INIStringPool &) = delete;
+        INIStringPool &operator=(const INIStringPool &) = delete;
+
+        /* Storage */
+        INIString acquire(const std::string_view &pStr);
+
+        /* Getters */
+        bool deduplicates(void) const;
+        INIAtom atom(const std::string_view &pStr) const;
+
+        size_t count(void) const;
+        size_t storedBytes(void) const;
+        size_t referencedBytes(void) const;
+        size_t savedBytes(void) const;
+        size_t memoryUsage(void) const;
+
+    protected:
+        friend class INIString;
+
+        void ref(INIStringNode *pNode);
+        void unref(INIStringNode *pNode);
+
+        static size_t nodeBytes(const INIStringNode *pNode);
+
+        bool mDeduplicate;
+
+        /** @brief Interned strings, only used when deduplicating */
+        std::unordered_map<std::string_view, INIStringNode *> mIndex;
+
+        size_t mCount;
+        size_t mStoredBytes;
+        std::atomic<size_t> mReferencedBytes;
+
+    private:
+};
+
+#endif /* INISTRINGPOOL_HPP */
@@ -0,0 +1,56 @@
+/**
+ * @brief INI worker thread pool class
+ *
+ * @file INIThreadPool.hpp
+ */
+
+#ifndef INITHREADPOOL_HPP
+#define INITHREADPOOL_HPP
+
+/* Includes -------------------------------------------- */
+/* C++ System */
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* C System */
+#include <cstddef>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI thread pool class ------------------------------- */
+/** @brief Fixed set of workers running queued tasks in FIFO order.
+ * A task throwing is reported, and does not stop its worker.
+ * The destructor runs the tasks still queued, then joins the workers.
+ */
+class INIThreadPool {
+    public:
+        /** @brief 0 workers means one per hardware thread */
+        explicit INIThreadPool(const size_t &pWorkers = 0U);
+
+        virtual ~INIThreadPool();
+
+        INIThreadPool(const INIThreadPool &) = delete;
+        INIThreadPool &operator=(const INIThreadPool &) = delete;
+
+        void submit(std::function<void(void)> pTask);
+        size_t workers(void) const;
+
+    protected:
+        void run(void);
+
+        std::vector<std::thread>             mWorkers;
+        std::deque<std::function<void(void)>> mTasks;
+        std::mutex                           mMutex;
+        std::condition_variable              mCondition;
+        bool                                 mStopping;
+
+    private:
+};
+
+#endif /* INITHREADPOOL_HPP */
@@ -0,0 +1,78 @@
+/**
+ * @brief INI section tree class
+ *
+ * @file INITree.hpp
+ */
+
+#ifndef INITREE_HPP
+#define INITREE_HPP
+
+/* Includes -------------------------------------------- */
+#include "ININame.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <vector>
+
+/* C System */
+#include <cstddef>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+struct INISection;
+
+/** @brief Node of the section tree.
+ * Nodes of intermediate names ("a.b" for "[a.b.c]")
+ * exist even if the section itself does not.
+ */
+struct INITreeNode {
+    std::string_view mPath; /**< Full section name */
+    std::string_view mName; /**< Last component of the name */
+
+    /** @brief Section of this node, nullptr if there is none */
+    INISection *mSection;
+
+    INITreeNode *mParent;
+    std::vector<INITreeNode *> mChildren;
+};
+
+/* INI tree class -------------------------------------- */
+/** @brief Sections arranged as a tree, split on a separator */
+class INITree {
+    public:
+        INITree(const char &pSeparator = '.', const bool &pFold = false);
+
+        /* The nodes point to the root */
+        INITree(const INITree &) = delete;
+        INITree &operator=(const INITree &) = delete;
+
+        char separator(void) const;
+        void setSeparator(const char &pSeparator);
+
+        INITreeNode *insert(const std::string_view &pPath, INISection *pSection);
+        void erase(const std::string_view &pPath);
+        void clear(void);
+
+        const INITreeNode *root(void) const;
+        const INITreeNode *find(const std::string_view &pPath) const;
+        size_t count(void) const;
+
+    protected:
+        INITreeNode *node(const std::string_view &pPath);
+
+        char mSeparator;
+
+        /** @brief Parent of the top level names */
+        INITreeNode mRoot;
+
+        /** @brief Nodes by full name, the keys hold the names the nodes point to */
+        std::map<std::string, std::unique_ptr<INITreeNode>, ININameLess> mNodes;
+
+    private:
+};
+
+#endif /* INITREE_HPP */
@@ -0,0 +1,200 @@
+/**
+ * @brief INI value index class
+ *
+ * @file INIValueIndex.hpp
+ */
+
+#ifndef INIVALUEINDEX_HPP
+#define INIVALUEINDEX_HPP
+
+/* Includes -------------------------------------------- */
+#include "ININame.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <iterator>
+#include <functional>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+struct INIEntry;
+
+/** @brief What the value index covers, to be OR'ed together */
+enum INIValueIndexFlag : uint32_t {
+    INI_VALUE_INDEX_NONE   = 0x00000000U,
+    INI_VALUE_INDEX_VALUES = 0x00000001U, /**< Entries by value */
+    INI_VALUE_INDEX_PAIRS  = 0x00000002U, /**< Entries by (key, value) pair */
+};
+
+/** @brief Entry holding a value. The names are spelled as first
+ * written, the views stay valid until the entry is modified. */
+struct INIValueRef {
+    std::string_view mSection;
+    std::string_view mKey;
+    std::string_view mValue;
+    const INIEntry  *mEntry;
+};
+
+/** @brief Entries sharing a hash */
+typedef std::vector<INIValueRef> INIValuePostings;
+
+/* INI value query class ------------------------------- */
+/** @brief Lazy view on the entries holding a value, optionally under
+ * a given key. Only the postings of the hash of the query are visited,
+ * and those of other values are skipped. The entries come in no
+ * particular order. The view must not outlive the document, nor be
+ * used after the document has been modified.
+ */
+class INIValueQuery {
+    public:
+        class iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef INIValueRef               value_type;
+                typedef std::ptrdiff_t            difference_type;
+                typedef const INIValueRef        *pointer;
+                typedef const INIValueRef        &reference;
+
+                iterator() : mQuery(nullptr), mIndex(0U) {}
+                iterator(const INIValueQuery *pQuery, const size_t &pIndex) :
+                    mQuery(pQuery),
+                    mIndex(pIndex)
+                {
+                    skip();
+                }
+
+                const INIValueRef &operator*(void) const { return (*mQuery->mPostings)[mIndex]; }
+                const INIValueRef *operator->(void) const { return &(*mQuery->mPostings)[mIndex]; }
+
+                iterator &operator++(void) {
+                    ++mIndex;
+                    skip();
+                    return *this;
+                }
+
+                iterator operator++(int) {
+                    iterator lOld = *this;
+                    ++(*this);
+                    return lOld;
+                }
+
+                bool operator==(const iterator &pOther) const { return mIndex == pOther.mIndex; }
+                bool operator!=(const iterator &pOther) const { return mIndex != pOther.mIndex; }
+
+            protected:
+                /** @brief Moves to the next matching entry, or to the end */
+                void skip(void) {
+                    const size_t lEnd = mQuery->size();
+                    while(lEnd != mIndex) {
+                        const INIValueRef &lRef = (*mQuery->mPostings)[mIndex];
+                        if((lRef.mValue == mQuery->mValue)
+                            && (!mQuery->mByKey || (0 == ININame::compare(lRef.mKey, mQuery->mKey, mQuery->mFold))))
+                        {
+                            break;
+                        }
+
+                        ++mIndex;
+                    }
+                }
+
+                const INIValueQuery *mQuery;
+                size_t mIndex;
+        };
+
+        INIValueQuery() : mPostings(nullptr), mByKey(false), mFold(false) {}
+
+        INIValueQuery(const INIValuePostings *pPostings,
+            const std::string_view &pValue,
+            const std::string_view *pKey,
+            const bool &pFold) :
+            mPostings(pPostings),
+            mValue(pValue),
+            mKey((nullptr != pKey) ? *pKey : std::string_view()),
+            mByKey(nullptr != pKey),
+            mFold(pFold)
+        {
+            /* Empty for now */
+        }
+
+        iterator begin(void) const { return iterator(this, 0U); }
+        iterator end(void) const { return iterator(this, size()); }
+
+        bool empty(void) const { return begin() == end(); }
+
+        size_t count(void) const {
+            return static_cast<size_t>(std::distance(begin(), end()));
+        }
+
+    protected:
+        size_t size(void) const { return (nullptr == mPostings) ? 0U : mPostings->size(); }
+
+        const INIValuePostings *mPostings;
+
+        std::string mValue;
+        std::string mKey;
+
+        /** @brief The key must match too */
+        bool mByKey;
+        bool mFold;
+
+    private:
+};
+
+/* INI value index class ------------------------------- */
+/** @brief Secondary index of a document, from the values, and from
+ * the (key, value) pairs, to the entries holding them. Each hash
+ * keeps its postings in a vector, so that a query is one hash lookup
+ * then a scan of the entries sharing that hash. Keys are folded in
+ * case-insensitive mode. Values are indexed raw, not interpolated.
+ */
+class INIValueIndex {
+    public:
+        INIValueIndex(const uint32_t &pFlags, const bool &pFold);
+
+        uint32_t flags(void) const;
+
+        /** @brief pHash is the hash of the value, as INIEntry::hash */
+        void insert(const INIValueRef &pRef, const uint64_t &pHash);
+        void erase(const INIValueRef &pRef, const uint64_t &pHash);
+        void reserve(const size_t &pEntries);
+        void clear(void);
+
+        /** @brief Pair queries fall back on the values when only those are indexed */
+        INIValueQuery find(const std::string_view &pValue) const;
+        INIValueQuery find(const std::string_view &pKey, const std::string_view &pValue) const;
+
+        size_t memoryUsage(void) const;
+
+        /** @brief Hash of a value, never 0 */
+        static uint64_t hash(const std::string_view &pValue);
+
+    protected:
+        uint64_t pairHash(const std::string_view &pKey, const uint64_t &pHash) const;
+
+        static void erase(std::unordered_map<uint64_t, INIValuePostings> &pMap,
+            const uint64_t &pHash,
+            const INIEntry *pEntry);
+
+        uint32_t mFlags;
+        bool     mFold;
+
+        std::unordered_map<uint64_t, INIValuePostings> mValues;
+        std::unordered_map<uint64_t, INIValuePostings> mPairs;
+
+    private:
+};
+
+/* Inline implementation ------------------------------- */
+inline uint64_t INIValueIndex::hash(const std::string_view &pValue) {
+    return std::hash<std::string_view>()(pValue) | 1U;
+}
+
+#endif /* INIVALUEINDEX_HPP */
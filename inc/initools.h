@@ -0,0 +1,104 @@
+/**
+ * @brief initools C API
+ *
+ * @file initools.h
+ */
+
+#ifndef INITOOLS_H
+#define INITOOLS_H
+
+/* Includes -------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Defines --------------------------------------------- */
+/** @brief Document modes, same values as INIMode */
+#define INI_C_MODE_DEFAULT          0x00000000U
+#define INI_C_MODE_INTERNING        0x00000001U
+#define INI_C_MODE_INTERPOLATION    0x00000002U
+#define INI_C_MODE_HIERARCHY        0x00000004U
+#define INI_C_MODE_CASE_INSENSITIVE 0x00000008U
+#define INI_C_MODE_MULTILINE        0x00000010U
+#define INI_C_MODE_TOLERANT         0x00000020U
+#define INI_C_MODE_INDENTED         0x00000040U
+#define INI_C_MODE_QUIET            0x00000080U
+
+/* Type definitions ------------------------------------ */
+/** @brief Status codes returned by the API */
+typedef enum {
+    INI_STATUS_OK        = 0,
+    INI_STATUS_INVALID   = -1, /**< Value cannot be converted, or operation failed */
+    INI_STATUS_RANGE     = -2, /**< Value does not fit in the requested type */
+    INI_STATUS_NOT_FOUND = -3, /**< Unknown section or key */
+    INI_STATUS_ARGUMENT  = -4, /**< NULL document or output */
+} ini_status_t;
+
+/** @brief Opaque document handle */
+typedef struct ini_document ini_document_t;
+
+/** @brief Iteration callbacks, returning non-zero stops the iteration.
+ * The strings are '\0' terminated, and only valid during the call.
+ */
+typedef int (*ini_section_cb_t)(const char *pName, size_t pSize, void *pUser);
+typedef int (*ini_entry_cb_t)(const char *pKey, size_t pKeySize,
+    const char *pValue, size_t pValueSize, void *pUser);
+
+/* Documents ------------------------------------------- */
+/** @brief The constructors return NULL on failure.
+ * Documents are released with ini_free. */
+ini_document_t *ini_new(uint32_t pMode);
+ini_document_t *ini_open(const char *pFile, uint32_t pMode);
+ini_document_t *ini_parse(const char *pData, size_t pSize, uint32_t pMode);
+void ini_free(ini_document_t *pDoc);
+
+int ini_write(const ini_document_t *pDoc, const char *pFile);
+
+/** @brief Problems of the last parse, with INI_C_MODE_TOLERANT.
+ * pKind is one of the parser errors, columns start at 1
+ * and are 0 for duplicates. */
+size_t ini_diagnostic_count(const ini_document_t *pDoc);
+int ini_diagnostic(const ini_document_t *pDoc, size_t pIndex,
+    uint32_t *pLine, uint32_t *pColumn, uint32_t *pKind);
+
+/** @brief Content fingerprints, equal for equal contents whatever their
+ * order, and only very likely different for different contents.
+ * A NULL section is the default section. */
+uint64_t ini_fingerprint(const ini_document_t *pDoc);
+int ini_section_fingerprint(const ini_document_t *pDoc, const char *pSection, uint64_t *pFingerprint);
+
+/* Lookups --------------------------------------------- */
+/** @brief A NULL section is the default section.
+ * Returned strings point into the document, are '\0' terminated,
+ * and stay valid until the document is modified or freed.
+ * Keys whose references cannot be resolved give INI_STATUS_INVALID. */
+int ini_get(const ini_document_t *pDoc, const char *pSection, const char *pKey,
+    const char **pValue, size_t *pSize);
+int ini_get_int64(const ini_document_t *pDoc, const char *pSection, const char *pKey, int64_t *pValue);
+int ini_get_uint64(const ini_document_t *pDoc, const char *pSection, const char *pKey, uint64_t *pValue);
+int ini_get_double(const ini_document_t *pDoc, const char *pSection, const char *pKey, double *pValue);
+int ini_get_bool(const ini_document_t *pDoc, const char *pSection, const char *pKey, int *pValue);
+
+int ini_has_section(const ini_document_t *pDoc, const char *pSection);
+int ini_has_key(const ini_document_t *pDoc, const char *pSection, const char *pKey);
+
+/* Iteration, in name order ---------------------------- */
+int ini_foreach_section(const ini_document_t *pDoc, ini_section_cb_t pCallback, void *pUser);
+int ini_foreach_entry(const ini_document_t *pDoc, const char *pSection, ini_entry_cb_t pCallback, void *pUser);
+
+/* Modifiers ------------------------------------------- */
+/** @brief ini_set changes an existing key, ini_add creates one */
+int ini_set(ini_document_t *pDoc, const char *pSection, const char *pKey, const char *pValue);
+int ini_add(ini_document_t *pDoc, const char *pSection, const char *pKey, const char *pValue);
+int ini_add_section(ini_document_t *pDoc, const char *pSection);
+int ini_remove_key(ini_document_t *pDoc, const char *pSection, const char *pKey);
+int ini_remove_section(ini_document_t *pDoc, const char *pSection);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* INITOOLS_H */
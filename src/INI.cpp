@@ -6,6 +6,12 @@
 
 /* Includes -------------------------------------------- */
 #include "INI.hpp"
+#include "INIConvert.hpp"
+#include "INIParser.hpp"
+#include "INIPattern.hpp"
+#include "INIRuntimeSchema.hpp"
+#include "INITree.hpp"
+#include "INIJson.hpp"
 
 /* C++ System */
 #include <iostream>
@@ -15,340 +21,984 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <charconv>
+#include <atomic>
 
 /* C System */
 #include <cstdlib>
 #include <cstdint>
+#include <cinttypes>
 #include <climits>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 
 /* Defines --------------------------------------------- */
+/** @brief Fewest rows worth a thread of their own when extracting columns */
+#define INI_COLUMNS_MIN_ROWS 4096U
+
+/** @brief Entries formatted at once when generating, per buffer and per task */
+#define INI_GENERATE_CHUNK_ENTRIES 16384U
 
 /* Type definitions ------------------------------------ */
 
 /* Helper functions ------------------------------------ */
-static void split(const std::string &pStr, const char pDelim, std::vector<std::string> &pWords) {
-    size_t lPos = 0U, lOldPos = 0U;
-    while(std::string::npos != lPos) {
-        std::string lSub;
-
-        /* Save the old position in the string */
-        lOldPos = lPos;
+/** @brief Name under which an entry is tracked for interpolation */
+static std::string dependencyName(const std::string_view &pKey, const std::string_view &pSection, const bool &pFold) {
+    std::string lName(pSection);
+    lName.push_back('\0');
+    lName.append(pKey);
 
-        /* Find the position of the next '\n' */
-        lPos = pStr.find(pDelim, lPos);
+    if(pFold) {
+        ININame::fold(&lName[0U], lName.size());
+    }
 
-        /* Extract the substring (lSub) */
-        lSub = pStr.substr(lOldPos, lPos - lOldPos);
+    return lName;
+}
 
-        if(std::string::npos != lPos) {
-            ++lPos;
-        }
+/** @brief Fingerprint of an entry, added to the one of its section */
+static uint64_t entryFingerprint(const std::string_view &pKey, const std::string_view &pValue, const bool &pFold) {
+    return INIFrozenIndex::hash(pValue, INIFrozenIndex::hash(pKey, 0U, pFold), false);
+}
 
-        if(lSub.empty()) {
-            break;
-        }
+/** @brief Fingerprint of a section, from the hash of its name and the
+ * sum of the fingerprints of its entries, added to the one of the document */
+static uint64_t sectionFingerprint(const INISection &pSection) {
+    /* Finalizer of MurmurHash3 */
+    uint64_t lHash = pSection.mNameHash ^ pSection.mFingerprint;
+    lHash ^= lHash >> 33U;
+    lHash *= 0xFF51AFD7ED558CCDULL;
+    lHash ^= lHash >> 33U;
+    lHash *= 0xC4CEB9FE1A85EC53ULL;
+    lHash ^= lHash >> 33U;
+
+    return lHash;
+}
 
-        pWords.push_back(lSub);
+/** @brief Whether a value is quoted, so that it is parsed back as is.
+ * In multi-line mode, the values that only a quoted value can hold are :
+ * line breaks, a '"' opening the value, and a trailing '\\' or blank. */
+static bool quoted(const std::string_view &pValue, const bool &pMultiline) {
+    if(!pMultiline || pValue.empty()) {
+        return false;
     }
-}
 
-static std::vector<std::string> split(const std::string &pStr, char pDelim) {
-    std::vector<std::string> lWords;
+    /* Blanks trimmed by the parser, line breaks aside */
+    static const std::string_view sBlanks = " \t\f\v";
 
-    split(pStr, pDelim, lWords);
+    const size_t lFirst = pValue.find_first_not_of(sBlanks);
 
-    return lWords;
+    return (std::string_view::npos != pValue.find_first_of("\n\r"))
+        || ((std::string_view::npos != lFirst) && ('"' == pValue[lFirst]))
+        || ('\\' == pValue.back())
+        || (std::string_view::npos != sBlanks.find(pValue.back()));
 }
 
-static std::string getStrAfterDelim(const std::string &pStr, char pDelim) {
-    size_t lDelimPos = pStr.find_last_of(pDelim);
-    size_t lEOLPos   = pStr.find('\n');
+static void appendValue(std::string &pOut, const std::string_view &pValue, const bool &pMultiline) {
+    if(!quoted(pValue, pMultiline)) {
+        pOut.append(pValue);
+        return;
+    }
+
+    pOut.push_back('"');
+    for(const char lChar : pValue) {
+        switch(lChar) {
+            case '\n':
+                pOut.append("\\n");
+                break;
+            case '\r':
+                pOut.append("\\r");
+                break;
+            case '\\':
+            case '"':
+                pOut.push_back('\\');
+                pOut.push_back(lChar);
+                break;
+            default:
+                pOut.push_back(lChar);
+                break;
+        }
+    }
+    pOut.push_back('"');
+}
 
-    /* Check if we found the delimiter */
-    if(std::string::npos == lDelimPos) {
-        /* Delimiter is not there, simply return the argument */
-        return pStr;
+/** @brief Size of a value once written by appendValue */
+static size_t valueSize(const std::string_view &pValue, const bool &pMultiline) {
+    if(!quoted(pValue, pMultiline)) {
+        return pValue.size();
     }
 
-    if(std::string::npos != lEOLPos) {
-        ++lEOLPos;
+    size_t lSize = pValue.size() + 2U;
+    for(const char lChar : pValue) {
+        if(('\n' == lChar) || ('\r' == lChar) || ('\\' == lChar) || ('"' == lChar)) {
+            ++lSize;
+        }
     }
 
-    std::string lSub = pStr.substr(lDelimPos, lEOLPos - lDelimPos);
+    return lSize;
+}
+
+/** @brief Writes a section, its entries in order, then an empty line.
+ * This also adds an empty line at EOF. */
+static void appendSection(std::string &pOut, const INISection &pSection, const bool &pMultiline) {
+    pOut.push_back('[');
+    pOut.append(pSection.mName.view());
+    pOut.append("]\n");
 
-    return lSub;
+    for(const auto &lKey : pSection.mOrder) {
+        pOut.append(lKey.view());
+        pOut.push_back('=');
+        appendValue(pOut, pSection.mEntries.find(lKey)->second.mValue.view(), pMultiline);
+        pOut.push_back('\n');
+    }
+
+    pOut.push_back('\n');
 }
 
-static std::string getStrBeforeDelim(const std::string &pStr, char pDelim) {
-    return pStr.substr(0U, pStr.find_first_of(pDelim));
+static size_t sectionSize(const INISection &pSection, const bool &pMultiline) {
+    size_t lSize = pSection.mName.view().size() + 4U;
+
+    for(const auto &lKey : pSection.mOrder) {
+        lSize += lKey.view().size() + 2U + valueSize(pSection.mEntries.find(lKey)->second.mValue.view(), pMultiline);
+    }
+
+    return lSize;
 }
 
-static void removeChar(std::string &pStr, const char pChar) {
-    size_t lPos = 0U;
+/** @brief Writes all of a buffer at an offset of a file */
+static int writeAt(const int &pFd, const std::string &pData, const off_t &pOffset) {
+    size_t lDone = 0U;
+    while(lDone < pData.size()) {
+        const ssize_t lWritten = pwrite(pFd, pData.data() + lDone, pData.size() - lDone, pOffset + static_cast<off_t>(lDone));
+        if(0 > lWritten) {
+            if(EINTR == errno) {
+                continue;
+            }
 
-    while(std::string::npos != lPos) {
-        if(std::string::npos == (lPos = pStr.find(pChar))) {
-            break;
+            return -1;
         }
-        pStr = pStr.substr(0U, lPos) + pStr.substr(lPos + 1U);
+
+        lDone += static_cast<size_t>(lWritten);
     }
+
+    return 0;
 }
 
-static void removeFirstChar(std::string &pStr, const char pChar) {
-    if(0U == pStr.find(pChar)) {
-        pStr = pStr.substr(1U);
+/** @brief Writes a value as a JSON boolean or number when the
+ * typed getters would read it as one, as a string otherwise */
+static int writeTyped(INIJsonWriter &pWriter, const std::string_view &pValue) {
+    char    lBuf[32U];
+    int64_t lInt64  = 0;
+    double  lDouble = 0.0;
+    bool    lBool   = false;
+
+    if(pValue.empty()) {
+        return pWriter.writeString(pValue);
     }
-}
 
-static void removeTrailingChar(std::string &pStr, const char pChar) {
-    if(pChar == pStr.at(pStr.size() - 1)) {
-        pStr = pStr.substr(0U, pStr.size() - 1);
+    if(0 == INIConvert::toInt64(pValue, lInt64)) {
+        /* Re-formatted, "0x1F" or "+1" are not JSON numbers */
+        const std::to_chars_result lResult = std::to_chars(lBuf, lBuf + sizeof(lBuf), lInt64);
+        return pWriter.write(std::string_view(lBuf, lResult.ptr - lBuf));
     }
-}
 
-static void frontTrim(std::string &pStr, const std::string &pChars) {
-    size_t lStart = pStr.find_first_not_of(pChars);
-    pStr = (lStart == std::string::npos) ? pStr : pStr.substr(lStart);
-}
+    if((0 == INIConvert::toDouble(pValue, lDouble)) && std::isfinite(lDouble)) {
+        const std::to_chars_result lResult = std::to_chars(lBuf, lBuf + sizeof(lBuf), lDouble);
+        return pWriter.write(std::string_view(lBuf, lResult.ptr - lBuf));
+    }
+
+    if(0 == INIConvert::toBoolean(pValue, lBool)) {
+        return pWriter.write(lBool ? "true" : "false");
+    }
 
-static void backTrim(std::string &pStr, const std::string &pChars) {
-    size_t lEnd = pStr.find_last_not_of(pChars);
-    pStr = (lEnd == std::string::npos) ? pStr : pStr.substr(0U, lEnd + 1U);
+    return pWriter.writeString(pValue);
 }
 
-static void removeChar(std::vector<std::string> &pStrs, const char pChar) {
-    for(size_t i = 0U; i < pStrs.size(); ++i) {
-        removeChar(pStrs[i], pChar);
+static int toBaseString(const uint64_t &pValue, const int &pBase, const int &pDigits, std::string &pOut) {
+    if(10 == pBase) {
+        pOut = std::to_string(pValue);
+    } else if (16 == pBase) {
+        char lStr[19U];
+        std::snprintf(lStr, sizeof(lStr), "0x%0*" PRIX64, pDigits, pValue);
+        pOut = std::string(lStr);
+    } else {
+        return -1;
     }
+
+    return 0;
 }
 
 /* Private helper functions ---------------------------- */
 bool INI::sectionExists(const std::string &pSection) const {
     /* Does this section exist ? */
-    return (mSections.end() != mSections.find(pSection));
+    return nullptr != findSection(pSection);
 }
 
 bool INI::keyExists(const std::string &pKey, const std::string &pSection) const {
-    /* Does the section and key exist ? 
-     * We also check the section here because otherwise
-     * the "at" method will throw a out_of_range
-     * exception if it soesn't exist. */
-    return ((sectionExists(pSection))
-        && (mSections.at(pSection).end() != mSections.at(pSection).find(pKey)));
+    /* Does the section and key exist ? */
+    return nullptr != findEntry(pKey, pSection);
 }
 
+INIString INI::keyOf(const INIString &pName) {
+    if(!mSections.key_comp().folds()) {
+        return pName;
+    }
 
-/* INI class ------------------------------------------- */
-INI::INI(const std::string &pFile) {
-    mFileParsed = false;
+    /* Folded once here, so that lookups never allocate a lowered copy */
+    const std::string lFolded = ININame::folded(pName.view());
+    return (lFolded == pName.view()) ? pName : mPool.acquire(lFolded);
+}
 
-    int lResult = parseFile(pFile);
-    if(0 != lResult) {
-        std::cerr << "[ERROR] <INI::INI> Failed to parse file " << pFile << std::endl;
-        throw INIException();
+INISection *INI::insertSection(const std::string_view &pSection) {
+    if(mSections.end() != mSections.find(pSection)) {
+        /* This section already exists ! */
+        return nullptr;
     }
 
-    mFileParsed = true;
+    INIString lName = mPool.acquire(pSection);
+    INIString lKey  = keyOf(lName);
+
+    auto lResult = mSections.emplace(lKey, INISection());
+
+    INISection *lSection = &lResult.first->second;
+    lSection->mName    = lName;
+    lSection->mEntries = std::map<INIString, INIEntry, ININameLess>(mSections.key_comp());
+    mSectionOrder.push_back(lName);
+
+    lSection->mNameHash = INIFrozenIndex::hash(lName.view(), 0U, mSections.key_comp().folds());
+    mFingerprint += sectionFingerprint(*lSection);
+
+    if(mPool.deduplicates()) {
+        mAtomSections[lKey.atom()] = lSection;
+    }
+
+    if(0U != (mMode & INI_MODE_HIERARCHY)) {
+        mTree.insert(lKey, lSection);
+    }
+
+    return lSection;
 }
 
-INI::~INI() {
-    /* Empty for now */
+INIEntry *INI::insertEntry(INISection &pSection, const std::string_view &pKey, const std::string_view &pValue) {
+    if(pSection.mEntries.end() != pSection.mEntries.find(pKey)) {
+        /* This key already exists ! */
+        return nullptr;
+    }
+
+    INIString lName = mPool.acquire(pKey);
+    INIString lKey  = keyOf(lName);
+
+    auto lResult = pSection.mEntries.emplace(lKey, INIEntry());
+
+    INIEntry *lEntry = &lResult.first->second;
+    lEntry->mValue = mPool.acquire(pValue);
+    pSection.mOrder.push_back(lName);
+
+    fingerprint(pSection, entryFingerprint(pKey, pValue, mSections.key_comp().folds()), 0U);
+
+    if(mPool.deduplicates()) {
+        pSection.mAtomEntries[lKey.atom()] = lEntry;
+    }
+
+    if(nullptr != mValueIndex) {
+        mValueIndex->insert(INIValueRef{pSection.mName.view(), lName.view(), lEntry->mValue.view(), lEntry}, lEntry->hash());
+    }
+
+    /* A reference to this key may now be resolved */
+    invalidate(pKey, pSection.mName);
+
+    return lEntry;
 }
 
-int INI::parseFile(const std::string &pFile) {
-    if(mFileParsed) {
-        /* File has already been parsed, need to flush all data and start over */
-        std::cerr << "[ERROR] <INI::parseFile> Ini file is not empty, clearing data" << std::endl;
-        mSections.clear();
-        mSectionElementOrder.clear();
-        mSectionOrder.clear();
+INIEntry *INI::updateEntry(INISection &pSection, const std::string_view &pKey, const std::string_view &pValue) {
+    auto lIt = pSection.mEntries.find(pKey);
+    if(pSection.mEntries.end() == lIt) {
+        return nullptr;
     }
 
-    mFileStream.open(pFile, std::ios::in | std::ios::out);
+    INIEntry *lEntry = &lIt->second;
 
-    /* Check if the file was opened correctly */
-    if(!mFileStream.is_open()) {
-        std::cerr << "[ERROR] <INI::parseFile> Failed to open file " << pFile << std::endl;
-        return -1;
+    const bool lFold = mSections.key_comp().folds();
+    fingerprint(pSection, entryFingerprint(pKey, pValue, lFold), entryFingerprint(pKey, lEntry->mValue.view(), lFold));
+
+    /* Indexed under the old value until now */
+    INIValueRef lRef{pSection.mName.view(), lIt->first.view(), lEntry->mValue.view(), lEntry};
+    if(nullptr != mValueIndex) {
+        if(pSection.mEntries.key_comp().folds()) {
+            /* The map key is folded, keep the name as first written */
+            lRef.mKey = std::find_if(pSection.mOrder.begin(), pSection.mOrder.end(),
+                [&pSection, &pKey](const INIString &pName) { return pSection.mEntries.key_comp().equal(pName, pKey); })->view();
+        }
+
+        mValueIndex->erase(lRef, lEntry->hash());
     }
 
-    /* Set default section name */
-    std::string lSection    = "default";
-    bool        lNewSection = false;
+    lEntry->mValue = mPool.acquire(pValue);
+    lEntry->mTyped = INITypedValue();
+    lEntry->mLists.clear();
+    lEntry->mHash.store(0U, std::memory_order_relaxed);
 
-    /* Parse the INI file */
-    uint32_t lLineCount = 0U;
-    for(std::string lLine = ""; std::getline(mFileStream, lLine);) {
-        std::istringstream lStrStream(lLine);
-        std::string lKey, lEq, lValue;
-
-        ++lLineCount;
-
-        /* Get the name out of the string stream.
-         * Either it is a section name, a comment
-         * or a value */
-
-        /* Check if there is something on this line */
-        if(!(lStrStream >> lKey)) {
-            /* Got nothing from the stream */
-            if(EOF == lStrStream.get()) {
-                /* This line is empty or EOF */
-                continue;
-            }
+    if(nullptr != mValueIndex) {
+        lRef.mValue = lEntry->mValue.view();
+        mValueIndex->insert(lRef, lEntry->hash());
+    }
+
+    mInterpolations.erase(lEntry);
+    invalidate(pKey, pSection.mName);
 
-            /* Something went wrong if you are here */
-            std::cerr << "[ERROR] <INI::parseFile> Unknown parsing error at line "
-                      << lLineCount << std::endl;
-            mFileStream.close();
+    return lEntry;
+}
+
+void INI::eraseSection(const std::string_view &pSection) {
+    auto lIt = mSections.find(pSection);
+    if(mSections.end() == lIt) {
+        return;
+    }
+
+    /* Drop the interpolation state of the entries */
+    for(auto &lEntry : lIt->second.mEntries) {
+        mInterpolations.erase(&lEntry.second);
+        invalidate(lEntry.first, pSection);
+
+        if(nullptr != mValueIndex) {
+            mValueIndex->erase(INIValueRef{std::string_view(), lEntry.first.view(), std::string_view(), &lEntry.second}, lEntry.second.hash());
+        }
+    }
+
+    mFingerprint -= sectionFingerprint(lIt->second);
+
+    mTree.erase(pSection);
+    mAtomSections.erase(lIt->first.atom());
+    mSectionOrder.erase(std::find_if(mSectionOrder.begin(), mSectionOrder.end(),
+        [this, &pSection](const INIString &pName) { return mSections.key_comp().equal(pName, pSection); }));
+    mSections.erase(lIt);
+}
+
+void INI::eraseEntry(INISection &pSection, const std::string_view &pKey) {
+    auto lIt = pSection.mEntries.find(pKey);
+    if(pSection.mEntries.end() == lIt) {
+        return;
+    }
+
+    mInterpolations.erase(&lIt->second);
+    invalidate(pKey, pSection.mName);
+
+    if(nullptr != mValueIndex) {
+        mValueIndex->erase(INIValueRef{std::string_view(), lIt->first.view(), std::string_view(), &lIt->second}, lIt->second.hash());
+    }
+
+    fingerprint(pSection, 0U, entryFingerprint(pKey, lIt->second.mValue.view(), mSections.key_comp().folds()));
+
+    pSection.mAtomEntries.erase(lIt->first.atom());
+    pSection.mOrder.erase(std::find_if(pSection.mOrder.begin(), pSection.mOrder.end(),
+        [&pSection, &pKey](const INIString &pName) { return pSection.mEntries.key_comp().equal(pName, pKey); }));
+    pSection.mEntries.erase(lIt);
+}
+
+void INI::clear(void) {
+    mDiagnostics.clear();
+    mInterpolations.clear();
+    mDependents.clear();
+    mTree.clear();
+    mAtomSections.clear();
+    mSectionOrder.clear();
+    mSections.clear();
+    mFingerprint = 0U;
+
+    if(nullptr != mValueIndex) {
+        mValueIndex->clear();
+    }
+}
+
+void INI::fingerprint(INISection &pSection, const uint64_t &pAdded, const uint64_t &pRemoved) {
+    /* The sums wrap around, so that removing undoes adding */
+    mFingerprint -= sectionFingerprint(pSection);
+    pSection.mFingerprint += pAdded - pRemoved;
+    mFingerprint += sectionFingerprint(pSection);
+}
+
+/* Interpolation helpers ------------------------------- */
+/** @brief States of an interpolated value. Failures are not kept,
+ * so that a reference or a variable defined later is picked up */
+enum {
+    INI_INTERPOLATION_RESOLVING = 0U,
+    INI_INTERPOLATION_RESOLVED,
+};
+
+int INI::resolve(const INIEntry &pEntry,
+    const std::string_view &pKey,
+    const std::string_view &pSection,
+    std::string_view &pOut) const
+{
+    /* Concurrent readers share the cache, references are resolved recursively */
+    std::lock_guard<std::recursive_mutex> lLock(mCacheMutex);
+
+    /* Has this value been resolved already ? */
+    auto lResult = mInterpolations.emplace(&pEntry, INIInterpolation{INI_INTERPOLATION_RESOLVING, std::string()});
+    INIInterpolation &lInterpolation = lResult.first->second;
+
+    if(!lResult.second) {
+        if(INI_INTERPOLATION_RESOLVING == lInterpolation.mState) {
+            std::cerr << "[ERROR] <INI::resolve> Reference cycle through (" << pSection << ", " << pKey << ")" << std::endl;
             return -1;
         }
 
-        /* Remove prefix and trailing whitespaces */
-        frontTrim(lLine, " ");
-        backTrim(lLine, " ");
+        pOut = lInterpolation.mValue;
+        return 1;
+    }
+
+    const std::string_view lRaw = pEntry.mValue.view();
+    const std::string      lSelf = dependencyName(pKey, pSection, mSections.key_comp().folds());
+    std::string            lValue;
+    size_t                 lPos = 0U;
+
+    while(true) {
+        size_t lStart = lRaw.find("${", lPos);
+        if(std::string_view::npos == lStart) {
+            lValue.append(lRaw.substr(lPos));
+            break;
+        }
 
-        /* Check if this line is a comment */
-        if('#' == lLine[0U] || ';' == lLine[0U]) {
-            /* This is a comment */
+        if((lPos < lStart) && ('$' == lRaw[lStart - 1U])) {
+            /* "$${" is an escaped "${" */
+            lValue.append(lRaw.substr(lPos, lStart - 1U - lPos));
+            lValue.append("${");
+            lPos = lStart + 2U;
             continue;
         }
 
-        /* Check if the is a section name */
-        if('[' == lLine[0U]) {
-            /* The section tag is [tag] */
-            size_t lPos = lLine.find_first_of(']');
-            if(std::string::npos == lPos) {
-                /* End og tag not found, this INI file is corrupt */
-                std::cerr << "[ERROR] <INI::parseFile> Found unclosed section tag at line " 
-                          << lLineCount << std::endl;
-                mFileStream.close();
-                return -1;
-            }
+        size_t lEnd = lRaw.find('}', lStart + 2U);
+        if(std::string_view::npos == lEnd) {
+            std::cerr << "[ERROR] <INI::resolve> Unterminated reference in (" << pSection << ", " << pKey << ")" << std::endl;
+            mInterpolations.erase(&pEntry);
+            return -1;
+        }
 
-            /* Get the section name */
-            lSection = lLine.substr(1, lPos - 1);
+        lValue.append(lRaw.substr(lPos, lStart - lPos));
+        lPos = lEnd + 1U;
 
-            /* Does this section exist already ? */
-            if(sectionExists(lSection)) {
-                /* This section already exists ! */
-                std::cerr << "[ERROR] <INI::parseFile> Duplicate Section in INI file at line " << lLineCount << std::endl;
-                mFileStream.close();
+        /* ${key}, ${section:key} or ${env:VAR} */
+        const std::string_view lRef = lRaw.substr(lStart + 2U, lEnd - lStart - 2U);
+        const size_t lColon = lRef.find(':');
+        const std::string_view lRefSection = (std::string_view::npos == lColon) ? pSection : lRef.substr(0U, lColon);
+        const std::string_view lRefKey     = (std::string_view::npos == lColon) ? lRef : lRef.substr(lColon + 1U);
+
+        if((std::string_view::npos != lColon) && ("env" == lRefSection)) {
+            const char *lEnv = std::getenv(std::string(lRefKey).c_str());
+            if(nullptr == lEnv) {
+                std::cerr << "[ERROR] <INI::resolve> Unknown environment variable " << lRefKey << std::endl;
+                mInterpolations.erase(&pEntry);
                 return -1;
             }
 
-            /* Save the section in the section order vector */
-            mSectionOrder.push_back(lSection);
+            lValue.append(lEnv);
+            continue;
+        }
+
+        /* Track the dependency, even if the key does not exist yet */
+        mDependents[dependencyName(lRefKey, lRefSection, mSections.key_comp().folds())].insert(lSelf);
+
+        const INIEntry *lRefEntry = findEntry(lRefKey, lRefSection);
+        if(nullptr == lRefEntry) {
+            std::cerr << "[ERROR] <INI::resolve> Unresolved reference ${" << lRef << "} in (" << pSection << ", " << pKey << ")" << std::endl;
+            mInterpolations.erase(&pEntry);
+            return -1;
+        }
+
+        std::string_view lRefValue;
+        if(0 > valueOf(*lRefEntry, lRefKey, lRefSection, lRefValue)) {
+            mInterpolations.erase(&pEntry);
+            return -1;
+        }
 
-            lNewSection = true;
+        lValue.append(lRefValue);
+    }
+
+    lInterpolation.mValue = std::move(lValue);
+    lInterpolation.mState = INI_INTERPOLATION_RESOLVED;
+
+    pOut = lInterpolation.mValue;
+    return 1;
+}
+
+void INI::invalidate(const std::string_view &pKey, const std::string_view &pSection) {
+    if(mDependents.empty()) {
+        /* Nothing was resolved through a reference */
+        return;
+    }
+
+    /* Drop the resolved values depending on this key, transitively */
+    std::vector<std::string> lStack(1U, dependencyName(pKey, pSection, mSections.key_comp().folds()));
+
+    while(!lStack.empty()) {
+        auto lIt = mDependents.find(lStack.back());
+        lStack.pop_back();
+
+        if(mDependents.end() == lIt) {
             continue;
         }
 
-        /* Now, try to extract the name/value pair */
-        std::vector<std::string> lKeyValue = split(lLine, '=');
-
-        if(2U != lKeyValue.size()) {
-            if(1U == lKeyValue.size()) {
-                /* Either the key is empty or the value.
-                 * An empty key is invalid.
-                 * An empty value is tolerated.
-                 */
-                if('=' == lLine.at(0U)) {
-                    /* First char is '=', meanign that the key is empty */
-                    std::cerr << "[ERROR] <INI::parseFile> Empty key at line "
-                              << lLineCount << std::endl;
-                    mFileStream.close();
-                    return -1;
-                } else if('=' == lLine.back()){
-                    /* Value is empty. We tolerate this case
-                     * by adding an empty string for the value
-                     */
-                    lKeyValue.push_back(std::string());
-                    std::cout << "[WARN ] <INI::parseFile> Empty value at line "
-                              << lLineCount << std::endl;
-                } else {
-                    /* There is no equal sign in the string */
-                    std::cerr << "[ERROR] <INI::parseFile> No '=' sign at line "
-                              << lLineCount << std::endl;
-                    mFileStream.close();
-                    return -1;
+        for(const auto &lName : lIt->second) {
+            const size_t lSep = lName.find('\0');
+            const INIEntry *lEntry = findEntry(std::string_view(lName).substr(lSep + 1U),
+                std::string_view(lName).substr(0U, lSep));
+
+            if(nullptr != lEntry) {
+                mInterpolations.erase(lEntry);
+                lEntry->mLists.clear();
+            }
+
+            lStack.push_back(lName);
+        }
+
+        mDependents.erase(lIt);
+    }
+}
+
+INIList *INI::listOf(const std::string_view &pKey,
+    const std::string_view &pSection,
+    const char &pDelim) const
+{
+    const INIEntry *lEntry = findEntry(pKey, pSection);
+    if(nullptr == lEntry) {
+        std::cerr << "[ERROR] <INI::listOf> Key/value pair not found (" << pSection << ", " << pKey << ")" << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::recursive_mutex> lLock(mCacheMutex);
+
+    for(INIList &lList : lEntry->mLists) {
+        if(pDelim == lList.delimiter()) {
+            /* Already split */
+            return &lList;
+        }
+    }
+
+    std::string_view lValue;
+    if(0 > valueOf(*lEntry, pKey, pSection, lValue)) {
+        return nullptr;
+    }
+
+    INIList &lList = lEntry->mLists.emplace_front();
+    lList.assign(lValue, pDelim);
+
+    return &lList;
+}
+
+int INI::resolveAll(void) const {
+    int lResult = 0;
+
+    /* Each value is resolved once, the references
+     * it goes through are memoized on the way */
+    for(const auto &lSection : mSections) {
+        for(const auto &lEntry : lSection.second.mEntries) {
+            std::string_view lValue;
+            if(0 > valueOf(lEntry.second, lEntry.first, lSection.first, lValue)) {
+                lResult = -1;
+            }
+        }
+    }
+
+    return lResult;
+}
+
+
+/* INI document builder class -------------------------- */
+/** @brief Fills an INI document from the parser events,
+ * validating it against a schema if one is given */
+class INIBuilder : public INIParserHandler {
+    public:
+        INIBuilder(INI &pINI,
+            const INIRuntimeSchema *pSchema = nullptr,
+            std::vector<INIViolation> *pViolations = nullptr) :
+            mINI(pINI),
+            mCurrent(nullptr),
+            mSchema(pSchema),
+            mRule(nullptr),
+            mViolations(pViolations)
+        {
+            /* Empty for now */
+        }
+
+        int onSection(const std::string_view &pSection, const uint32_t &pLine) override {
+            /* Save the section, it must not exist already */
+            mCurrent = mINI.insertSection(pSection);
+            if(nullptr == mCurrent) {
+                if(tolerant()) {
+                    /* The entries that follow go to the first definition */
+                    mCurrent = mINI.findSection(pSection);
+                    return onError(INI_PARSE_ERROR_DUPLICATE_SECTION, pLine, 0U);
                 }
-            } else {
-                /* Three strings seperated by an equal sign ?
-                 * TODO : Do we consider the second '=' as
-                 * part of the value string ?
-                 */
-                std::cerr << "[ERROR] <INI::parseFile> Invalid key/name pair at line "
-                        << lLineCount << std::endl;
-                mFileStream.close();
+
+                /* This section already exists ! */
+                std::cerr << "[ERROR] <INI::parseFile> Duplicate Section in INI file at line " << pLine << std::endl;
                 return -1;
             }
+
+            checkSection(pSection, pLine);
+
+            return 0;
         }
 
-        /* We got a valid keyvalue pair */
-        lKey   = lKeyValue[0U];
-        lValue = lKeyValue[1U];
-
-        /* This is commented because we accept spaces in the keyname */
-        // if(std::string::npos != lKey.find(' ')) {
-        //     std::cerr << "[ERROR] <INI::parseFile> Space in key at line "
-        //             << lLineCount << std::endl;
-        //     mFileStream.close();
-        //     return -1;
-        // }
-
-        /* This is commented because we accept spaces in the value */
-        // if(std::string::npos != lValue.find(' ')) {
-        //     std::cerr << "[ERROR] <INI::parseFile> Space in value at line "
-        //             << lLineCount << std::endl;
-        //     mFileStream.close();
-        //     return -1;
-        // }
-
-        /* Does this key exist already ? 
-         * First, we must check if the section exists
-         */
-        if(!lNewSection) {
-            if(keyExists(lKey)) {
+        int onEntry(const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue,
+            const uint32_t &pLine) override
+        {
+            /* Entries found before the first section tag
+             * belong to the default section */
+            if(nullptr == mCurrent) {
+                mCurrent = mINI.findSection(pSection);
+                if(nullptr == mCurrent) {
+                    mCurrent = mINI.insertSection(pSection);
+                }
+
+                checkSection(pSection, pLine);
+            }
+
+            if(pValue.empty() && (0U == (mINI.mMode & INI_MODE_QUIET))) {
+                /* Value is empty. We tolerate this case
+                 * by adding an empty string for the value */
+                std::cout << "[WARN ] <INI::parseFile> Empty value at line "
+                          << pLine << std::endl;
+            }
+
+            /* Save our entry, the key must not exist already */
+            INIEntry *lEntry = mINI.insertEntry(*mCurrent, pKey, pValue);
+            if(nullptr == lEntry) {
+                if(tolerant()) {
+                    /* The first value is kept */
+                    return onError(INI_PARSE_ERROR_DUPLICATE_KEY, pLine, 0U);
+                }
+
                 /* This key already exists ! */
-                std::cerr << "[ERROR] <INI::parseFile> Duplicate Key in INI file at line " << lLineCount << std::endl;
-                mFileStream.close();
+                std::cerr << "[ERROR] <INI::parseFile> Duplicate Key in INI file at line " << pLine << std::endl;
                 return -1;
             }
+
+            if(nullptr != mSchema) {
+                /* Validate and convert the value while it is hot */
+                INIViolationKind lKind = mSchema->checkValue(mRule, pKey, pValue, lEntry->mTyped);
+                if(INI_VIOLATION_NONE != lKind) {
+                    report(lKind, pSection, pKey, pLine);
+                }
+            }
+
+            return 0;
+        }
+
+        int onError(const INIParseError &pError, const uint32_t &pLine, const uint32_t &pColumn) override {
+            if(tolerant()) {
+                /* Collected without logging, the line is skipped */
+                mINI.mDiagnostics.push_back(INIDiagnostic{pLine, pColumn, pError});
+                return 0;
+            }
+
+            switch(pError) {
+                case INI_PARSE_ERROR_UNCLOSED_SECTION:
+                    std::cerr << "[ERROR] <INI::parseFile> Found unclosed section tag at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_EMPTY_KEY:
+                    std::cerr << "[ERROR] <INI::parseFile> Empty key at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_NO_EQUAL_SIGN:
+                    std::cerr << "[ERROR] <INI::parseFile> No '=' sign at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_INVALID_PAIR:
+                    std::cerr << "[ERROR] <INI::parseFile> Invalid key/name pair at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_UNCLOSED_QUOTE:
+                    std::cerr << "[ERROR] <INI::parseFile> Unclosed quoted value at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_INVALID_ESCAPE:
+                    std::cerr << "[ERROR] <INI::parseFile> Invalid escape sequence at line " << pLine << std::endl;
+                    break;
+                case INI_PARSE_ERROR_TEXT_AFTER_QUOTE:
+                    std::cerr << "[ERROR] <INI::parseFile> Text after a quoted value at line " << pLine << std::endl;
+                    break;
+                default:
+                    std::cerr << "[ERROR] <INI::parseFile> Unknown parsing error at line " << pLine << std::endl;
+                    break;
+            }
+
+            return -1;
+        }
+
+        /** @brief Reports the required sections and keys
+         * that were not found in the file */
+        void finish(void) {
+            if(nullptr == mSchema) {
+                return;
+            }
+
+            for(const auto &lRule : mSchema->sections()) {
+                if(!INIPattern::isPattern(lRule.mName)) {
+                    const INISection *lSection = mINI.findSection(lRule.mName);
+                    if(nullptr == lSection) {
+                        if(lRule.mRequired) {
+                            report(INI_VIOLATION_MISSING_SECTION, lRule.mName, std::string_view(), 0U);
+                        }
+                    } else {
+                        checkRequiredKeys(lRule, *lSection);
+                    }
+                    continue;
+                }
+
+                /* Every section matching the pattern must have the required keys */
+                bool lFound = false;
+                for(const auto &lElmt : mINI.mSections) {
+                    if(INIPattern::match(lRule.mName, lElmt.first)) {
+                        lFound = true;
+                        checkRequiredKeys(lRule, lElmt.second);
+                    }
+                }
+
+                if(!lFound && lRule.mRequired) {
+                    report(INI_VIOLATION_MISSING_SECTION, lRule.mName, std::string_view(), 0U);
+                }
+            }
+        }
+
+    private:
+        bool tolerant(void) const {
+            return 0U != (mINI.mMode & INI_MODE_TOLERANT);
         }
 
+        void checkSection(const std::string_view &pSection, const uint32_t &pLine) {
+            if(nullptr == mSchema) {
+                return;
+            }
+
+            if(INI_VIOLATION_NONE != mSchema->checkSection(pSection, mRule)) {
+                report(INI_VIOLATION_UNKNOWN_SECTION, pSection, std::string_view(), pLine);
+            }
+        }
+
+        void checkRequiredKeys(const INISectionRule &pRule, const INISection &pSection) {
+            for(const auto &lKey : pRule.mKeys) {
+                if(lKey.second.mRequired && (pSection.mEntries.end() == pSection.mEntries.find(lKey.first))) {
+                    report(INI_VIOLATION_MISSING_KEY, pSection.mName, lKey.first, 0U);
+                }
+            }
+        }
+
+        void report(const INIViolationKind &pKind,
+            const std::string_view &pSection,
+            const std::string_view &pKey,
+            const uint32_t &pLine)
+        {
+            mViolations->push_back(INIViolation{pKind, std::string(pSection), std::string(pKey), pLine});
+        }
+
+        INI                       &mINI;
+        INISection                *mCurrent;
+        const INIRuntimeSchema    *mSchema;
+        const INISectionRule      *mRule;
+        std::vector<INIViolation> *mViolations;
+};
+
+
+/* INI class ------------------------------------------- */
+INI::INI(const uint32_t &pMode) :
+    mMode(pMode),
+    mPool(0U != (pMode & INI_MODE_INTERNING)),
+    mFileParsed(false),
+    mSections(ININameLess(0U != (pMode & INI_MODE_CASE_INSENSITIVE))),
+    mFingerprint(0U),
+    mTree('.', 0U != (pMode & INI_MODE_CASE_INSENSITIVE))
+{
+    /* Empty document */
+}
+
+INI::INI(const std::string &pFile, const uint32_t &pMode) :
+    mMode(pMode),
+    mPool(0U != (pMode & INI_MODE_INTERNING)),
+    mSections(ININameLess(0U != (pMode & INI_MODE_CASE_INSENSITIVE))),
+    mFingerprint(0U),
+    mTree('.', 0U != (pMode & INI_MODE_CASE_INSENSITIVE))
+{
+    mFileParsed = false;
+
+    int lResult = parseFile(pFile);
+    if(0 != lResult) {
+        std::cerr << "[ERROR] <INI::INI> Failed to parse file " << pFile << std::endl;
+        throw INIException();
+    }
+
+    mFileParsed = true;
+}
+
+INI::~INI() {
+    /* Empty for now */
+}
+
+int INI::parseFile(const std::string &pFile) {
+    INIBuilder lBuilder(*this);
+
+    return parseFile(pFile, lBuilder);
+}
+
+int INI::parseFile(const std::string &pFile,
+    const INIRuntimeSchema &pSchema,
+    std::vector<INIViolation> &pViolations)
+{
+    INIBuilder lBuilder(*this, &pSchema, &pViolations);
+
+    pViolations.clear();
+
+    int lResult = parseFile(pFile, lBuilder);
+    if(0 != lResult) {
+        return lResult;
+    }
+
+    lBuilder.finish();
+
+    if(!pViolations.empty()) {
+        std::cerr << "[ERROR] <INI::parseFile> " << pViolations.size() << " schema violation(s) in INI file " << pFile << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+int INI::parseBuffer(const char *pData, const size_t &pSize) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::parseBuffer> Document is frozen" << std::endl;
+        return -1;
+    }
+
+    if(mFileParsed || !mSections.empty()) {
+        /* Need to flush all data and start over */
+        std::cerr << "[ERROR] <INI::parseBuffer> Ini file is not empty, clearing data" << std::endl;
+        clear();
+    }
+
+    mDiagnostics.clear();
+
+    /* The value index is rebuilt in bulk once parsed */
+    const uint32_t lIndexed = (nullptr != mValueIndex) ? mValueIndex->flags() : INI_VALUE_INDEX_NONE;
+    mValueIndex.reset();
+
+    INIBuilder lBuilder(*this);
+    INIParser  lParser(lBuilder, parserOptions());
+
+    int lResult = 0;
+    if((0 > lParser.feed(pData, pSize)) || (0 > lParser.finish())) {
+        lResult = -1;
+    }
+
+    if(INI_VALUE_INDEX_NONE != lIndexed) {
+        indexValues(lIndexed);
+    }
+
+    return lResult;
+}
 
-        /* Save our entry */
-        mSections[lSection][lKey] = lValue;
+int INI::parseFile(const std::string &pFile, INIBuilder &pBuilder) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::parseFile> Document is frozen" << std::endl;
+        return -1;
+    }
 
-        /* Save the entry in the order vector */
-        mSectionElementOrder[lSection].push_back(lKey);
+    if(mFileParsed || !mSections.empty()) {
+        /* File has already been parsed, need to flush all data and start over */
+        std::cerr << "[ERROR] <INI::parseFile> Ini file is not empty, clearing data" << std::endl;
+        clear();
+    }
 
-        lNewSection = false;
+    mFileStream.open(pFile, std::ios::in | std::ios::binary);
 
-        //std::cout << "[INFO ] <INI::parseFile> [" << lSection << "] " << lKey << " = " << mSections.at(lSection).at(lKey) << std::endl;
+    /* Check if the file was opened correctly */
+    if(!mFileStream.is_open()) {
+        std::cerr << "[ERROR] <INI::parseFile> Failed to open file " << pFile << std::endl;
+        return -1;
     }
 
-    std::cout << "[INFO ] <INI::parseFile> Parsed INI file " << pFile << " successfully !" << std::endl;
+    mFileName = pFile;
+    mDiagnostics.clear();
+
+    /* The value index is rebuilt in bulk once parsed */
+    const uint32_t lIndexed = (nullptr != mValueIndex) ? mValueIndex->flags() : INI_VALUE_INDEX_NONE;
+    mValueIndex.reset();
+
+    /* Parse the INI file */
+    INIParser lParser(pBuilder, parserOptions());
+    const int lResult = lParser.parse(mFileStream);
+
+    if(INI_VALUE_INDEX_NONE != lIndexed) {
+        indexValues(lIndexed);
+    }
+
+    if(0 > lResult) {
+        mFileStream.close();
+        return -1;
+    }
+
+    if(0U != (mMode & INI_MODE_QUIET)) {
+        /* Nothing to report */
+    } else if(!mDiagnostics.empty()) {
+        std::cout << "[WARN ] <INI::parseFile> Parsed INI file " << pFile << " with " << mDiagnostics.size() << " errors" << std::endl;
+    } else {
+        std::cout << "[INFO ] <INI::parseFile> Parsed INI file " << pFile << " successfully !" << std::endl;
+    }
     mFileStream.close();
 
     return 0;
 }
 
+uint32_t INI::parserOptions(void) const {
+    if(0U == (mMode & INI_MODE_MULTILINE)) {
+        return INI_PARSER_STRICT;
+    }
+
+    return (0U != (mMode & INI_MODE_INDENTED)) ? (INI_PARSER_MULTILINE | INI_PARSER_INDENTED) : INI_PARSER_MULTILINE;
+}
+
 std::string INI::fileName(void) const {
     return mFileName;
 }
 
+uint32_t INI::mode(void) const {
+    return mMode;
+}
+
+uint64_t INI::fingerprint(void) const {
+    return mFingerprint;
+}
+
+int INI::fingerprint(const std::string &pSection, uint64_t &pFingerprint) const {
+    auto lIt = mSections.find(pSection);
+    if(mSections.end() == lIt) {
+        return -1;
+    }
+
+    pFingerprint = sectionFingerprint(lIt->second);
+
+    return 0;
+}
+
+const std::vector<INIDiagnostic> &INI::diagnostics(void) const {
+    return mDiagnostics;
+}
+
 int INI::getValue(const std::string &pKey,
     std::string &pOut,
     const std::string &pSection) const
 {
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check that the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            pOut = mSections.at(pSection).at(pKey);
-            return 0;
+    /* Check that the section and the key exist */
+    const INIEntry *lEntry = findEntry(pKey, pSection);
+    if(nullptr != lEntry) {
+        std::string_view lValue;
+        if(0 > valueOf(*lEntry, pKey, pSection, lValue)) {
+            return -1;
         }
+
+        pOut = std::string(lValue);
+        return 0;
     }
 
     return -1;
@@ -358,7 +1008,7 @@ std::vector<std::string> INI::getSections(void) const {
     std::vector<std::string> lSections;
 
     for(const auto &lElmt : mSections) {
-        lSections.push_back(lElmt.first);
+        lSections.push_back(lElmt.first.str());
     }
 
     return lSections;
@@ -367,9 +1017,10 @@ std::vector<std::string> INI::getSections(void) const {
 std::vector<std::string> INI::getKeys(const std::string &pSection) const {
     std::vector<std::string> lKeys;
 
-    if(mSections.end() != mSections.find(pSection)) {
-        for(const auto &lElmt : mSections.at(pSection)) {
-            lKeys.push_back(lElmt.first);
+    const INISection *lSection = findSection(pSection);
+    if(nullptr != lSection) {
+        for(const auto &lElmt : lSection->mEntries) {
+            lKeys.push_back(lElmt.first.str());
         }
     }
 
@@ -379,9 +1030,15 @@ std::vector<std::string> INI::getKeys(const std::string &pSection) const {
 std::vector<std::string> INI::getValues(const std::string &pSection) const {
     std::vector<std::string> lValues;
 
-    if(mSections.end() != mSections.find(pSection)) {
-        for(const auto &lElmt : mSections.at(pSection)) {
-            lValues.push_back(lElmt.second);
+    const INISection *lSection = findSection(pSection);
+    if(nullptr != lSection) {
+        for(const auto &lElmt : lSection->mEntries) {
+            std::string_view lValue;
+            if(0 > valueOf(lElmt.second, lElmt.first, pSection, lValue)) {
+                /* Keep the raw value if it cannot be resolved */
+                lValue = lElmt.second.mValue.view();
+            }
+            lValues.push_back(std::string(lValue));
         }
     }
 
@@ -389,15 +1046,312 @@ std::vector<std::string> INI::getValues(const std::string &pSection) const {
 }
 
 std::map<std::string, std::string> INI::getSectionContents(const std::string &pSection) const {
-    if(sectionExists(pSection)) {
-        return mSections.at(pSection);
-    } else return std::map<std::string, std::string>();
+    std::map<std::string, std::string> lContents;
+
+    const INISection *lSection = findSection(pSection);
+    if(nullptr != lSection) {
+        for(const auto &lElmt : lSection->mEntries) {
+            std::string_view lValue;
+            if(0 > valueOf(lElmt.second, lElmt.first, pSection, lValue)) {
+                /* Keep the raw value if it cannot be resolved */
+                lValue = lElmt.second.mValue.view();
+            }
+            lContents.emplace_hint(lContents.end(), lElmt.first.str(), std::string(lValue));
+        }
+    }
+
+    return lContents;
+}
+
+int INI::extractColumns(const std::string_view &pSelector,
+    const std::vector<INIColumnSpec> &pSpecs,
+    INIColumns &pColumns,
+    const size_t &pThreads) const
+{
+    for(const auto &lSpec : pSpecs) {
+        if((INI_TYPE_INT64 != lSpec.mType)
+            && (INI_TYPE_DOUBLE != lSpec.mType)
+            && (INI_TYPE_BOOLEAN != lSpec.mType)
+            && (INI_TYPE_STRING != lSpec.mType))
+        {
+            std::cerr << "[ERROR] <INI::extractColumns> Unsupported type for column " << lSpec.mKey << std::endl;
+            return -1;
+        }
+    }
+
+    /* Select the rows */
+    std::vector<const INISection *> lSections;
+    pColumns.mSections.clear();
+
+    const INISectionQuery lQuery = querySections(pSelector);
+    for(auto lIt = lQuery.begin(); lIt != lQuery.end(); ++lIt) {
+        pColumns.mSections.push_back(*lIt);
+        lSections.push_back(&lIt.value());
+    }
+
+    const size_t lRows = lSections.size();
+    pColumns.mColumns.resize(pSpecs.size());
+    for(size_t i = 0U; i < pSpecs.size(); ++i) {
+        pColumns.mColumns[i].reset(pSpecs[i], lRows);
+    }
+
+    /* The keys are looked up in name order, in one pass over each section */
+    std::vector<size_t> lOrder(pSpecs.size());
+    for(size_t i = 0U; i < lOrder.size(); ++i) {
+        lOrder[i] = i;
+    }
+    const ININameLess lLess = mSections.key_comp();
+    std::sort(lOrder.begin(), lOrder.end(), [&pSpecs, &lLess](const size_t &pLeft, const size_t &pRight) {
+        return lLess(pSpecs[pLeft].mKey, pSpecs[pRight].mKey);
+    });
+
+    auto lFill = [this, &lSections, &lOrder, &lLess, &pSpecs, &pColumns](const size_t &pFirst, const size_t &pLast) {
+        for(size_t lRow = pFirst; lRow < pLast; ++lRow) {
+            const INISection &lSection = *lSections[lRow];
+            auto lEntry = lSection.mEntries.begin();
+
+            for(const size_t lIndex : lOrder) {
+                const std::string &lKey = pSpecs[lIndex].mKey;
+                while((lSection.mEntries.end() != lEntry) && lLess(lEntry->first, lKey)) {
+                    ++lEntry;
+                }
+
+                if((lSection.mEntries.end() == lEntry) || !lLess.equal(lEntry->first, lKey)) {
+                    /* Missing key, invalid row */
+                    continue;
+                }
+
+                INIColumn &lColumn = pColumns.mColumns[lIndex];
+                int lResult = -1;
+
+                switch(lColumn.mType) {
+                    case INI_TYPE_INT64: {
+                        int64_t lValue = 0;
+                        lResult = convertEntry(lEntry->second, lKey, lSection.mName, lValue);
+                        lColumn.mInt64s[lRow] = (0 == lResult) ? lValue : 0;
+                        break;
+                    }
+                    case INI_TYPE_DOUBLE: {
+                        double lValue = 0.0;
+                        lResult = convertEntry(lEntry->second, lKey, lSection.mName, lValue);
+                        lColumn.mDoubles[lRow] = (0 == lResult) ? lValue : 0.0;
+                        break;
+                    }
+                    case INI_TYPE_BOOLEAN: {
+                        bool lValue = false;
+                        lResult = convertEntry(lEntry->second, lKey, lSection.mName, lValue);
+                        lColumn.mBooleans[lRow] = ((0 == lResult) && lValue) ? 1U : 0U;
+                        break;
+                    }
+                    default:
+                        lResult = valueOf(lEntry->second, lKey, lSection.mName, lColumn.mStrings[lRow]);
+                        break;
+                }
+
+                if(0 <= lResult) {
+                    lColumn.mValidity[lRow / 64U] |= 1ULL << (lRow % 64U);
+                }
+            }
+        }
+    };
+
+    /* Resolving references updates shared state, extract serially then */
+    size_t lThreads = (0U != (mMode & INI_MODE_INTERPOLATION)) ? 1U : pThreads;
+    if(0U == lThreads) {
+        lThreads = std::max<size_t>(1U, std::thread::hardware_concurrency());
+    }
+    lThreads = std::max<size_t>(1U, std::min(lThreads, lRows / INI_COLUMNS_MIN_ROWS));
+
+    /* Chunks are whole validity words, so that no word is shared */
+    const size_t lChunk = ((lRows + lThreads - 1U) / lThreads + 63U) & ~static_cast<size_t>(63U);
+
+    std::vector<std::thread> lWorkers;
+    size_t lFirst = lChunk;
+    try {
+        lWorkers.reserve(lThreads - 1U);
+        for(; lFirst < lRows; lFirst += lChunk) {
+            lWorkers.emplace_back(lFill, lFirst, std::min(lRows, lFirst + lChunk));
+        }
+    } catch(const std::exception &e) {
+        std::cerr << "[WARN ] <INI::extractColumns> Started " << lWorkers.size()
+            << " of " << (lThreads - 1U) << " workers : " << e.what() << std::endl;
+    }
+
+    /* The calling thread takes the first chunk, and those left without a worker */
+    lFill(0U, std::min(lRows, lChunk));
+    if(lFirst < lRows) {
+        lFill(lFirst, lRows);
+    }
+
+    for(auto &lWorker : lWorkers) {
+        lWorker.join();
+    }
+
+    return 0;
+}
+
+int INI::setSeparator(const char &pSeparator) {
+    if(0U == (mMode & INI_MODE_HIERARCHY)) {
+        std::cerr << "[ERROR] <INI::setSeparator> Hierarchy mode is disabled" << std::endl;
+        return -1;
+    }
+
+    /* Rebuild the tree, in file order */
+    mTree.setSeparator(pSeparator);
+    for(const auto &lName : mSectionOrder) {
+        auto lIt = mSections.find(lName);
+        mTree.insert(lIt->first, &lIt->second);
+    }
+
+    return 0;
+}
+
+const INITreeNode *INI::getNode(const std::string &pSection) const {
+    return mTree.find(pSection);
+}
+
+int INI::getInheritedValue(const std::string &pKey,
+    std::string &pOut,
+    const std::string &pSection) const
+{
+    const INITreeNode *lNode = mTree.find(pSection);
+    if(nullptr == lNode) {
+        std::cerr << "[ERROR] <INI::getInheritedValue> Section not found (" << pSection << ")" << std::endl;
+        return -1;
+    }
+
+    /* Walk up the ancestors until one of them has the key */
+    for(; nullptr != lNode; lNode = lNode->mParent) {
+        if(nullptr == lNode->mSection) {
+            continue;
+        }
+
+        auto lIt = lNode->mSection->mEntries.find(pKey);
+        if(lNode->mSection->mEntries.end() != lIt) {
+            std::string_view lValue;
+            if(0 > valueOf(lIt->second, lIt->first, lNode->mPath, lValue)) {
+                return -1;
+            }
+
+            pOut = std::string(lValue);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+INISectionQuery INI::querySections(const std::string_view &pPattern) const {
+    return INISectionQuery(mSections, pPattern);
+}
+
+INIKeyQuery INI::queryKeys(const std::string_view &pPattern, const std::string &pSection) const {
+    const INISection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
+        /* Unknown section, nothing matches */
+        return INIKeyQuery();
+    }
+
+    return INIKeyQuery(lSection->mEntries, pPattern);
+}
+
+int INI::getList(const std::string &pKey,
+    INIArrayView<std::string_view> &pList,
+    const std::string &pSection,
+    const char &pDelim) const
+{
+    const INIList *lList = listOf(pKey, pSection, pDelim);
+    if(nullptr == lList) {
+        return -1;
+    }
+
+    pList = lList->items();
+    return 0;
+}
+
+INIAtom INI::atom(const std::string &pName) const {
+    if(mSections.key_comp().folds()) {
+        /* The sections and entries are indexed by their folded name */
+        return mPool.atom(ININame::folded(pName));
+    }
+
+    return mPool.atom(pName);
+}
+
+int INI::getValue(const INIAtom &pKey, std::string &pOut, const INIAtom &pSection) const {
+    /* Both lookups only hash and compare the atoms */
+    auto lSection = mAtomSections.find(pSection);
+    if(mAtomSections.end() == lSection) {
+        return -1;
+    }
+
+    auto lEntry = lSection->second->mAtomEntries.find(pKey);
+    if(lSection->second->mAtomEntries.end() == lEntry) {
+        return -1;
+    }
+
+    std::string_view lValue;
+    const INIStringNode *lKey = reinterpret_cast<const INIStringNode *>(pKey);
+    if(0 > valueOf(*lEntry->second, std::string_view(lKey->data(), lKey->mSize), lSection->second->mName, lValue)) {
+        return -1;
+    }
+
+    pOut = std::string(lValue);
+    return 0;
+}
+
+int INI::visit(INIParserHandler &pHandler) const {
+    /* For each section, in file order */
+    for(const auto &lName : mSectionOrder) {
+        const INISection *lSection = findSection(lName);
+
+        if(0 > pHandler.onSection(lName, 0U)) {
+            return -1;
+        }
+
+        /* For each key in the section, in file order */
+        for(const auto &lKey : lSection->mOrder) {
+            if(0 > pHandler.onEntry(lName, lKey, lSection->mEntries.find(lKey)->second.mValue, 0U)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+size_t INI::memoryUsage(void) const {
+    /* Approximate size of a tree or hash node, excluding its payload */
+    static const size_t sNodeOverhead = 4U * sizeof(void *);
+
+    size_t lBytes = sizeof(INI) + mPool.memoryUsage();
+
+    lBytes += mSectionOrder.capacity() * sizeof(INIString);
+    lBytes += mDiagnostics.capacity() * sizeof(INIDiagnostic);
+    lBytes += (nullptr != mFrozen) ? mFrozen->memoryUsage() : 0U;
+    lBytes += (nullptr != mValueIndex) ? mValueIndex->memoryUsage() : 0U;
+    lBytes += mAtomSections.size() * (sNodeOverhead + sizeof(INIAtom) + sizeof(INISection *));
+
+    for(const auto &lElmt : mSections) {
+        const INISection &lSection = lElmt.second;
+
+        lBytes += sNodeOverhead + sizeof(INIString) + sizeof(INISection);
+        lBytes += lSection.mEntries.size() * (sNodeOverhead + sizeof(INIString) + sizeof(INIEntry));
+        lBytes += lSection.mOrder.capacity() * sizeof(INIString);
+        lBytes += lSection.mAtomEntries.size() * (sNodeOverhead + sizeof(INIAtom) + sizeof(INIEntry *));
+    }
+
+    return lBytes;
+}
+
+size_t INI::internedBytesSaved(void) const {
+    return mPool.savedBytes();
 }
 
 int INI::getInt64(const std::string &pKey, int64_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -406,21 +1360,13 @@ int INI::getInt64(const std::string &pKey, int64_t &pValue, const std::string &p
     }
 
     /* Cast the value */
-    char *lEnd = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        pValue = strtoll(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        pValue = strtoll(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-
-    return *lEnd == 0 ? 0 : -1;
+    return convertEntry(*lEntry, pKey, pSection, pValue);
 }
 
 int INI::getInt32(const std::string &pKey, int32_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -428,22 +1374,19 @@ int INI::getInt32(const std::string &pKey, int32_t &pValue, const std::string &p
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        pValue = strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        pValue = strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
+        std::cerr << "[ERROR] <INI::getInt32> Value is out of bounds !" << std::endl;
     }
 
-    return *lEnd == 0 ? 0 : -1;
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getInt16(const std::string &pKey, int16_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -451,31 +1394,19 @@ int INI::getInt16(const std::string &pKey, int16_t &pValue, const std::string &p
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    int32_t lTempVal = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        lTempVal = (int16_t)strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        lTempVal = (int16_t)strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-
-    /* Check limits */
-    if(SHRT_MAX < lTempVal || SHRT_MIN > lTempVal) {
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
         std::cerr << "[ERROR] <INI::getInt16> Value is out of bounds !" << std::endl;
-        return -1;
-    } else {
-        pValue = (int16_t)lTempVal;
     }
 
-    return *lEnd == 0 ? 0 : -1;
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getInt8(const std::string &pKey, int8_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -483,31 +1414,19 @@ int INI::getInt8(const std::string &pKey, int8_t &pValue, const std::string &pSe
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    int32_t lTempVal = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        lTempVal = (int16_t)strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        lTempVal = (int16_t)strtol(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-
-    /* Check limits */
-    if(SCHAR_MAX < lTempVal || SCHAR_MIN > lTempVal) {
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
         std::cerr << "[ERROR] <INI::getInt8> Value is out of bounds !" << std::endl;
-        return -1;
-    } else {
-        pValue = (int8_t)lTempVal;
     }
 
-    return *lEnd == 0 ? 0 : -1;
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getUInt64(const std::string &pKey, uint64_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -516,21 +1435,13 @@ int INI::getUInt64(const std::string &pKey, uint64_t &pValue, const std::string
     }
 
     /* Cast the value */
-    char *lEnd = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        pValue = strtoull(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        pValue = strtoull(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-    
-    return *lEnd == 0 ? 0 : -1;
+    return convertEntry(*lEntry, pKey, pSection, pValue);
 }
 
 int INI::getUInt32(const std::string &pKey, uint32_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -538,22 +1449,19 @@ int INI::getUInt32(const std::string &pKey, uint32_t &pValue, const std::string
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        pValue = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        pValue = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
+        std::cerr << "[ERROR] <INI::getUInt32> Value is out of bounds !" << std::endl;
     }
-    
-    return *lEnd == 0 ? 0 : -1;
+
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getUInt16(const std::string &pKey, uint16_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -561,31 +1469,19 @@ int INI::getUInt16(const std::string &pKey, uint16_t &pValue, const std::string
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    uint32_t lTempVal = 0U;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        lTempVal = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        lTempVal = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-
-    /* Check limits */
-    if(USHRT_MAX < lTempVal) {
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
         std::cerr << "[ERROR] <INI::getUInt16> Value is out of bounds !" << std::endl;
-        return -1;
-    } else {
-        pValue = (uint16_t)lTempVal;
     }
-    
-    return *lEnd == 0 ? 0 : -1;
+
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getUInt8(const std::string &pKey, uint8_t &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -593,25 +1489,13 @@ int INI::getUInt8(const std::string &pKey, uint8_t &pValue, const std::string &p
         return -1;
     }
 
-    /* Cast the value */
-    char *lEnd = 0;
-    uint32_t lTempVal = 0U;
-    if(std::string::npos != lVal.find("0x")) {
-        /* Haxadecimal value */
-        lTempVal = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 16);
-    } else {
-        lTempVal = strtoul(mSections.at(pSection).at(pKey).c_str(), &lEnd, 10);
-    }
-
-    /* Check limits */
-    if(UCHAR_MAX < lTempVal) {
-        std::cerr << "[ERROR] <INI::getUInt8> Value is out of bounds !" << std::endl;
-        return -1;
-    } else {
-        pValue = (uint8_t)lTempVal;
+    /* Cast the value, checking its limits */
+    int lResult = convertEntry(*lEntry, pKey, pSection, pValue);
+    if(-2 == lResult) {
+        std::cerr << "[ERROR] <INI::getUInt8> Value is out of bounds !" << std::endl;
     }
-    
-    return *lEnd == 0 ? 0 : -1;
+
+    return 0 > lResult ? -1 : 0;
 }
 
 int INI::getString(const std::string &pKey, std::string &pValue, const std::string &pSection) const {
@@ -619,9 +1503,9 @@ int INI::getString(const std::string &pKey, std::string &pValue, const std::stri
 }
 
 int INI::getBoolean(const std::string &pKey, bool &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -630,28 +1514,13 @@ int INI::getBoolean(const std::string &pKey, bool &pValue, const std::string &pS
     }
 
     /* Cast the value */
-    if(("true" == mSections.at(pSection).at(pKey))
-        || (mSections.at(pSection).at(pKey) == "True")
-        || (mSections.at(pSection).at(pKey) == "1"))
-    {
-        pValue = true;
-    } else if ((mSections.at(pSection).at(pKey) == "false")
-        || (mSections.at(pSection).at(pKey) == "False")
-        || (mSections.at(pSection).at(pKey) == "0"))
-    {
-        pValue = false;
-    } else {
-        /* Unexpected value */
-        return -1;
-    }
-
-    return 0;
+    return convertEntry(*lEntry, pKey, pSection, pValue);
 }
 
 int INI::getDouble(const std::string &pKey, double &pValue, const std::string &pSection) const {
-    std::string lVal;
+    const INIEntry *lEntry = findEntry(pKey, pSection);
 
-    if(0 > getValue(pKey, lVal, pSection)) {
+    if(nullptr == lEntry) {
         /* Key/Value pair not found.
          * This is either because the section is unknown
          * or the key is unknown */
@@ -660,258 +1529,110 @@ int INI::getDouble(const std::string &pKey, double &pValue, const std::string &p
     }
 
     /* Cast the value */
-    char *lEnd = 0;
-    pValue = strtod(mSections.at(pSection).at(pKey).c_str(), &lEnd);
-    return *lEnd == 0 ? 0 : -1;
+    return convertEntry(*lEntry, pKey, pSection, pValue);
 }
 
 
 /* Setters */
 int INI::setInt64(const std::string &pKey, const int64_t &pValue, const std::string &pSection) {
-    std::string lVal = std::to_string(pValue);
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, std::to_string(pValue), pSection);
 }
 
 int INI::setInt32(const std::string &pKey, const int32_t &pValue, const std::string &pSection) {
-    std::string lVal = std::to_string(pValue);
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, std::to_string(pValue), pSection);
 }
 
 int INI::setInt16(const std::string &pKey, const int16_t &pValue, const std::string &pSection) {
-    std::string lVal = std::to_string(pValue);
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, std::to_string(pValue), pSection);
 }
 
 int INI::setInt8(const std::string &pKey, const int8_t &pValue, const std::string &pSection) {
-    std::string lVal = std::to_string(pValue);
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, std::to_string(pValue), pSection);
 }
 
 int INI::setUInt64(const std::string &pKey, const uint64_t &pValue, const std::string &pSection, const int &pBase) {
     std::string lVal;
 
-    if(10 == pBase) {
-        lVal = std::to_string(pValue);
-    } else if (16 == pBase) {
-        char lStr[19U];
-        std::snprintf(lStr, 19U, "0x%016X", pValue);
-        lVal = std::string(lStr);
-    } else {
+    if(0 > toBaseString(pValue, pBase, 16, lVal)) {
         std::cerr << "[ERROR] <INI::setUInt64> Unknown base specified" << std::endl;
         return -1;
     }
 
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, lVal, pSection);
 }
 
 int INI::setUInt32(const std::string &pKey, const uint32_t &pValue, const std::string &pSection, const int &pBase) {
     std::string lVal;
 
-    if(10 == pBase) {
-        lVal = std::to_string(pValue);
-    } else if (16 == pBase) {
-        char lStr[11U];
-        std::snprintf(lStr, 11U, "0x%08X", pValue);
-        lVal = std::string(lStr);
-    } else {
+    if(0 > toBaseString(pValue, pBase, 8, lVal)) {
         std::cerr << "[ERROR] <INI::setUInt32> Unknown base specified" << std::endl;
         return -1;
     }
 
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, lVal, pSection);
 }
 
 int INI::setUInt16(const std::string &pKey, const uint16_t &pValue, const std::string &pSection, const int &pBase) {
     std::string lVal;
 
-    if(10 == pBase) {
-        lVal = std::to_string(pValue);
-    } else if (16 == pBase) {
-        char lStr[7U];
-        std::snprintf(lStr, 7U, "0x%04X", pValue);
-        lVal = std::string(lStr);
-    } else {
+    if(0 > toBaseString(pValue, pBase, 4, lVal)) {
         std::cerr << "[ERROR] <INI::setUInt16> Unknown base specified" << std::endl;
         return -1;
     }
 
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, lVal, pSection);
 }
 
 int INI::setUInt8(const std::string &pKey, const uint8_t &pValue, const std::string &pSection, const int &pBase) {
     std::string lVal;
 
-    if(10 == pBase) {
-        lVal = std::to_string(pValue);
-    } else if (16 == pBase) {
-        char lStr[5U];
-        std::snprintf(lStr, 5U, "0x%02X", pValue);
-        lVal = std::string(lStr);
-    } else {
+    if(0 > toBaseString(pValue, pBase, 2, lVal)) {
         std::cerr << "[ERROR] <INI::setUInt8> Unknown base specified" << std::endl;
         return -1;
     }
 
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, lVal, pSection);
 }
 
 int INI::setString(const std::string &pKey, const std::string &pValue, const std::string &pSection) {
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = pValue;
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::setString> Document is frozen" << std::endl;
+        return -1;
+    }
 
-            return 0;
-        }
+    /* Check that the section and the key exist */
+    INISection *lSection = findSection(pSection);
+    if((nullptr == lSection) || (nullptr == updateEntry(*lSection, pKey, pValue))) {
+        return -1;
     }
 
-    return -1;
+    return 0;
 }
 
 int INI::setBoolean(const std::string &pKey, const bool &pValue, const std::string &pSection) {
-    std::string lVal = pValue ? "true" : "false";
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, pValue ? "true" : "false", pSection);
 }
 
 int INI::setDouble(const std::string &pKey, const double &pValue, const std::string &pSection) {
-    std::string lVal = std::to_string(pValue);
-
-    /* Check if the section exists */
-    if(mSections.end() != mSections.find(pSection)) {
-        /* Check if the key exists */
-        if(mSections.at(pSection).end() != mSections.at(pSection).find(pKey)) {
-            /* The key does exist ! */
-            mSections.at(pSection).at(pKey) = lVal;
-
-            return 0;
-        }
-    }
-
-    return -1;
+    return setString(pKey, std::to_string(pValue), pSection);
 }
 
 
 /* Adders */
 int INI::addSection(const std::string &pSection) {
-    /* Does this section exist already ? */
-    if(sectionExists(pSection)) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::addSection> Document is frozen" << std::endl;
+        return -1;
+    }
+
+    /* Add the section with no keys, it must not exist already */
+    if(nullptr == insertSection(pSection)) {
         /* This section already exists ! */
         std::cerr << "[ERROR] <INI::addSection> Section already exists" << std::endl;
         return -1;
     }
 
-    /* Add the section with no keys */
-    mSections[pSection] = std::map<std::string, std::string>();
-    mSectionOrder.push_back(pSection);
-    mSectionElementOrder[pSection] = std::vector<std::string>();
-
-    return -1;
+    return 0;
 }
 
 int INI::addInt64(const std::string &pKey, const int64_t &pValue, const std::string &pSection) {
@@ -931,76 +1652,70 @@ int INI::addInt8(const std::string &pKey, const int8_t &pValue, const std::strin
 }
 
 int INI::addUInt64(const std::string &pKey, const uint64_t &pValue, const std::string &pSection, const int &pBase) {
-    if(10 == pBase) {
-        return addString(pKey, std::to_string(pValue), pSection);
-    } else if (16 == pBase) {
-        char lStr[19U];
-        std::snprintf(lStr, 19U, "0x%016X", pValue);
-        return addString(pKey, std::string(lStr), pSection);
-    } else {
+    std::string lVal;
+
+    if(0 > toBaseString(pValue, pBase, 16, lVal)) {
         std::cerr << "[ERROR] <INI::addUInt64> Unknown base specified" << std::endl;
         return -1;
     }
+
+    return addString(pKey, lVal, pSection);
 }
 
 int INI::addUInt32(const std::string &pKey, const uint32_t &pValue, const std::string &pSection, const int &pBase) {
-    if(10 == pBase) {
-        return addString(pKey, std::to_string(pValue), pSection);
-    } else if (16 == pBase) {
-        char lStr[11U];
-        std::snprintf(lStr, 11U, "0x%08X", pValue);
-        return addString(pKey, std::string(lStr), pSection);
-    } else {
+    std::string lVal;
+
+    if(0 > toBaseString(pValue, pBase, 8, lVal)) {
         std::cerr << "[ERROR] <INI::addUInt32> Unknown base specified" << std::endl;
         return -1;
     }
+
+    return addString(pKey, lVal, pSection);
 }
 
 int INI::addUInt16(const std::string &pKey, const uint16_t &pValue, const std::string &pSection, const int &pBase) {
-    if(10 == pBase) {
-        return addString(pKey, std::to_string(pValue), pSection);
-    } else if (16 == pBase) {
-        char lStr[7U];
-        std::snprintf(lStr, 7U, "0x%04X", pValue);
-        return addString(pKey, std::string(lStr), pSection);
-    } else {
+    std::string lVal;
+
+    if(0 > toBaseString(pValue, pBase, 4, lVal)) {
         std::cerr << "[ERROR] <INI::addUInt16> Unknown base specified" << std::endl;
         return -1;
     }
+
+    return addString(pKey, lVal, pSection);
 }
 
 int INI::addUInt8(const std::string &pKey, const uint8_t &pValue, const std::string &pSection, const int &pBase) {
-    if(10 == pBase) {
-        return addString(pKey, std::to_string(pValue), pSection);
-    } else if (16 == pBase) {
-        char lStr[5U];
-        std::snprintf(lStr, 5U, "0x%02X", pValue);
-        return addString(pKey, std::string(lStr), pSection);
-    } else {
+    std::string lVal;
+
+    if(0 > toBaseString(pValue, pBase, 2, lVal)) {
         std::cerr << "[ERROR] <INI::addUInt8> Unknown base specified" << std::endl;
         return -1;
     }
+
+    return addString(pKey, lVal, pSection);
 }
 
 int INI::addString(const std::string &pKey, const std::string &pValue, const std::string &pSection) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::addString> Document is frozen" << std::endl;
+        return -1;
+    }
+
     /* Does this section exist ? */
-    if(!sectionExists(pSection)) {
+    INISection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
         /* This section doesn't exist ! */
         std::cerr << "[ERROR] <INI::addString> Section doesn't exist" << std::endl;
         return -1;
     }
 
-    /* Does the key already exist ? */
-    if(keyExists(pKey)) {
+    /* Add the key to the associated section, it must not exist already */
+    if(nullptr == insertEntry(*lSection, pKey, pValue)) {
         /* This key already exists ! */
         std::cerr << "[ERROR] <INI::addString> Key already exists" << std::endl;
         return -1;
     }
 
-    /* Add the key to the associated section */
-    mSections.at(pSection)[pKey] = pValue;
-    mSectionElementOrder.at(pSection).push_back(pKey);
-
     return 0;
 }
 
@@ -1013,6 +1728,11 @@ int INI::addDouble(const std::string &pKey, const double &pValue, const std::str
 }
 
 int INI::removeSection(const std::string &pSection) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::removeSection> Document is frozen" << std::endl;
+        return -1;
+    }
+
     /* Does this section exist ? */
     if(!sectionExists(pSection)) {
         /* This section doesn't exist ! */
@@ -1020,38 +1740,162 @@ int INI::removeSection(const std::string &pSection) {
         return -1;
     }
 
-    mSectionOrder.erase(find(mSectionOrder.begin(), mSectionOrder.end(), pSection));
-    mSections.erase(pSection);
-    mSectionElementOrder.erase(pSection);
+    eraseSection(pSection);
 
     return 0;
 }
 
 int INI::removeKey(const std::string &pSection, const std::string &pKey) {
+    if(frozen()) {
+        std::cerr << "[ERROR] <INI::removeKey> Document is frozen" << std::endl;
+        return -1;
+    }
+
     /* Does this section exist ? */
-    if(!sectionExists(pSection)) {
+    INISection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
         /* This section doesn't exist ! */
         std::cerr << "[ERROR] <INI::removeKey> Section doesn't exist" << std::endl;
         return -1;
     }
 
     /* Does this key exist . */
-    if(!keyExists(pKey, pSection)) {
+    if(lSection->mEntries.end() == lSection->mEntries.find(pKey)) {
         /* This key doesn't exist ! */
         std::cerr << "[ERROR] <INI::removeKey> Key doesn't exist" << std::endl;
         return -1;
     }
 
-    mSections.at(pSection).erase(pKey);
-    std::vector<std::string> *lTempVector = &mSectionElementOrder.at(pSection);
-    lTempVector->erase(find(lTempVector->begin(), lTempVector->end(), pKey));
+    eraseEntry(*lSection, pKey);
     
     return 0;
 }
 
 
+/* Read-only form */
+int INI::freeze(void) {
+    std::vector<INIFrozenItem> lItems;
+    for(const auto &lSection : mSections) {
+        for(const auto &lEntry : lSection.second.mEntries) {
+            /* Map keys, folded in case-insensitive mode */
+            lItems.push_back(INIFrozenItem{lSection.first.view(), lEntry.first.view(), &lEntry.second});
+        }
+    }
+
+    std::unique_ptr<INIFrozenIndex> lIndex = std::make_unique<INIFrozenIndex>(mSections.key_comp().folds());
+    if(0 != lIndex->build(lItems)) {
+        std::cerr << "[ERROR] <INI::freeze> Failed to index the entries" << std::endl;
+        return -1;
+    }
+
+    mFrozen = std::move(lIndex);
+    return 0;
+}
+
+void INI::thaw(void) {
+    mFrozen.reset();
+}
+
+bool INI::frozen(void) const {
+    return nullptr != mFrozen;
+}
+
+/* Value index */
+int INI::indexValues(const uint32_t &pFlags) {
+    if(0U == (pFlags & (INI_VALUE_INDEX_VALUES | INI_VALUE_INDEX_PAIRS))) {
+        std::cerr << "[ERROR] <INI::indexValues> Nothing to index" << std::endl;
+        return -1;
+    }
+
+    std::unique_ptr<INIValueIndex> lIndex(new INIValueIndex(pFlags, mSections.key_comp().folds()));
+
+    size_t lEntries = 0U;
+    for(const auto &lSection : mSections) {
+        lEntries += lSection.second.mEntries.size();
+    }
+
+    lIndex->reserve(lEntries);
+
+    /* With the names as first written */
+    for(const auto &lElmt : mSections) {
+        const INISection &lSection = lElmt.second;
+
+        for(const INIString &lKey : lSection.mOrder) {
+            const INIEntry &lEntry = lSection.mEntries.find(lKey.view())->second;
+            lIndex->insert(INIValueRef{lSection.mName.view(), lKey.view(), lEntry.mValue.view(), &lEntry}, lEntry.hash());
+        }
+    }
+
+    mValueIndex = std::move(lIndex);
+
+    return 0;
+}
+
+void INI::dropValueIndex(void) {
+    mValueIndex.reset();
+}
+
+INIValueQuery INI::findValue(const std::string_view &pValue) const {
+    if((nullptr == mValueIndex) || (0U == (mValueIndex->flags() & INI_VALUE_INDEX_VALUES))) {
+        std::cerr << "[ERROR] <INI::findValue> Values are not indexed" << std::endl;
+        return INIValueQuery();
+    }
+
+    return mValueIndex->find(pValue);
+}
+
+INIValueQuery INI::findValue(const std::string_view &pKey, const std::string_view &pValue) const {
+    if(nullptr == mValueIndex) {
+        std::cerr << "[ERROR] <INI::findValue> Values are not indexed" << std::endl;
+        return INIValueQuery();
+    }
+
+    return mValueIndex->find(pKey, pValue);
+}
+
 /* Generator */
+std::vector<INI::INIGenerateChunk> INI::generateChunks(void) const {
+    std::vector<INIGenerateChunk> lChunks;
+
+    size_t lEntries = INI_GENERATE_CHUNK_ENTRIES;
+    for(const auto &lName : mSectionOrder) {
+        const INISection *lSection = findSection(lName);
+
+        if(INI_GENERATE_CHUNK_ENTRIES <= lEntries) {
+            lChunks.push_back(INIGenerateChunk());
+            lEntries = 0U;
+        }
+
+        lChunks.back().mSections.push_back(lSection);
+        lEntries += lSection->mEntries.size() + 1U;
+    }
+
+    return lChunks;
+}
+
+int INI::generate(std::ostream &pStream) const {
+    const bool lMultiline = 0U != (mMode & INI_MODE_MULTILINE);
+
+    std::string lBuffer;
+    for(const auto &lChunk : generateChunks()) {
+        lBuffer.clear();
+        for(const INISection *lSection : lChunk.mSections) {
+            appendSection(lBuffer, *lSection, lMultiline);
+        }
+
+        pStream.write(lBuffer.data(), static_cast<std::streamsize>(lBuffer.size()));
+    }
+
+    pStream.flush();
+
+    return pStream.good() ? 0 : -1;
+}
+
 int INI::generateFile(const std::string &pDest) const {
+    return generateFile(pDest, 0U);
+}
+
+int INI::generateFile(const std::string &pDest, const size_t &pThreads) const {
     /* Are we overwriting our original INI file ? */
     if(mFileName == pDest) {
         /* Overwrite detected not supported for now */
@@ -1059,29 +1903,180 @@ int INI::generateFile(const std::string &pDest) const {
         return -1;
     }
 
-    std::fstream lOutputFileStream(pDest, std::ios::out);
-    if(!lOutputFileStream.is_open()) {
+    const int lFd = ::open(pDest.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(0 > lFd) {
         std::cerr << "[ERROR] <INI::generateFile> Failed to open file " << pDest << std::endl;
         return -1;
     }
 
-    /* For each section */
-    for(const auto &lSection : mSectionOrder) {
-        /* Write the section name */
-        lOutputFileStream << "[" << lSection << "]" << std::endl;
+    const bool lMultiline = 0U != (mMode & INI_MODE_MULTILINE);
+
+    /* Each worker takes the next chunk, formats it in its own buffer,
+     * and writes it at its offset */
+    std::vector<INIGenerateChunk> lChunks;
+    std::atomic<size_t> lNext(0U);
+    std::atomic<bool>   lFailed(false);
+
+    auto lWrite = [&lChunks, &lNext, &lFailed, lFd, lMultiline](void) {
+        try {
+            std::string lBuffer;
+            for(size_t i = lNext++; (i < lChunks.size()) && !lFailed; i = lNext++) {
+                lBuffer.clear();
+                for(const INISection *lSection : lChunks[i].mSections) {
+                    appendSection(lBuffer, *lSection, lMultiline);
+                }
+
+                if(0 != writeAt(lFd, lBuffer, static_cast<off_t>(lChunks[i].mOffset))) {
+                    lFailed = true;
+                }
+            }
+        } catch(const std::exception &e) {
+            /* Never let an exception end a worker */
+            std::cerr << "[ERROR] <INI::generateFile> " << e.what() << std::endl;
+            lFailed = true;
+        }
+    };
+
+    try {
+        lChunks = generateChunks();
+
+        size_t lThreads = (0U != pThreads) ? pThreads : std::max<size_t>(1U, std::thread::hardware_concurrency());
+        lThreads = std::min(lThreads, lChunks.size());
+
+        if(1U >= lThreads) {
+            /* The offsets follow from the chunks written before */
+            std::string lBuffer;
+            size_t      lOffset = 0U;
+            for(const auto &lChunk : lChunks) {
+                lBuffer.clear();
+                for(const INISection *lSection : lChunk.mSections) {
+                    appendSection(lBuffer, *lSection, lMultiline);
+                }
+
+                if(0 != writeAt(lFd, lBuffer, static_cast<off_t>(lOffset))) {
+                    lFailed = true;
+                    break;
+                }
+
+                lOffset += lBuffer.size();
+            }
+        } else {
+            /* Size the chunks first, so that each one knows where it goes */
+            auto lSize = [&lChunks, &lNext, lMultiline](void) {
+                for(size_t i = lNext++; i < lChunks.size(); i = lNext++) {
+                    for(const INISection *lSection : lChunks[i].mSections) {
+                        lChunks[i].mSize += sectionSize(*lSection, lMultiline);
+                    }
+                }
+            };
+
+            const std::function<void(void)> lPasses[] = {lSize, lWrite};
+            for(const auto &lPass : lPasses) {
+                lNext = 0U;
+
+                /* With fewer workers than asked for, the calling
+                 * thread does the remaining chunks */
+                std::vector<std::thread> lWorkers;
+                try {
+                    lWorkers.reserve(lThreads - 1U);
+                    for(size_t i = 1U; i < lThreads; ++i) {
+                        lWorkers.emplace_back(lPass);
+                    }
+                } catch(const std::exception &e) {
+                    std::cerr << "[WARN ] <INI::generateFile> Started " << lWorkers.size()
+                        << " of " << (lThreads - 1U) << " workers : " << e.what() << std::endl;
+                }
+                lPass();
+
+                for(auto &lWorker : lWorkers) {
+                    lWorker.join();
+                }
+
+                size_t lOffset = 0U;
+                for(auto &lChunk : lChunks) {
+                    lChunk.mOffset = lOffset;
+                    lOffset += lChunk.mSize;
+                }
+            }
+        }
+    } catch(const std::exception &e) {
+        std::cerr << "[ERROR] <INI::generateFile> " << e.what() << std::endl;
+        lFailed = true;
+    }
+
+    if((0 != ::close(lFd)) || lFailed) {
+        std::cerr << "[ERROR] <INI::generateFile> Failed to write file " << pDest << std::endl;
+        return -1;
+    }
+
+    if(0U == (mMode & INI_MODE_QUIET)) {
+        std::cout << "[INFO ] <INI::generateFile> Successfully generated INI file " << pDest << std::endl;
+    }
+
+    return 0;
+}
+
+int INI::exportJson(const INIWriteCallback &pSink, const uint32_t &pFlags) const {
+    const bool lNDJSON = 0U != (pFlags & INI_JSON_NDJSON);
+    const bool lTyped  = 0U != (pFlags & INI_JSON_TYPED);
+
+    INIJsonWriter lWriter(pSink);
+
+    if(!lNDJSON) {
+        lWriter.write("{");
+    }
+
+    bool lFirstSection = true;
+    for(const auto &lName : mSectionOrder) {
+        const INISection *lSection = findSection(lName);
+
+        if(lNDJSON) {
+            lWriter.write("{\"section\":");
+            lWriter.writeString(lName);
+            lWriter.write(",\"values\":{");
+        } else {
+            lWriter.write(lFirstSection ? "" : ",");
+            lWriter.writeString(lName);
+            lWriter.write(":{");
+        }
+        lFirstSection = false;
+
+        bool lFirstKey = true;
+        for(const auto &lKey : lSection->mOrder) {
+            const INIEntry &lEntry = lSection->mEntries.find(lKey)->second;
+
+            std::string_view lValue;
+            if(0 > valueOf(lEntry, lKey, lName, lValue)) {
+                /* Unresolved references are exported as written */
+                lValue = lEntry.mValue.view();
+            }
+
+            lWriter.write(lFirstKey ? "" : ",");
+            lWriter.writeString(lKey);
+            lWriter.write(":");
+            lFirstKey = false;
+
+            if(lTyped) {
+                writeTyped(lWriter, lValue);
+            } else {
+                lWriter.writeString(lValue);
+            }
+        }
 
-        /* For each key in the section */
-        for(const auto &lKey : mSectionElementOrder.at(lSection)) {
-            /* Write the key, the equal sign and the value */
-            lOutputFileStream << lKey << "=" << mSections.at(lSection).at(lKey) << std::endl;
+        if(0 > lWriter.write(lNDJSON ? "}}\n" : "}")) {
+            /* The sink gave up, no need to go on */
+            break;
         }
+    }
+
+    if(!lNDJSON) {
+        lWriter.write("}");
+    }
 
-        /* Add an empty line between sections.
-         * This will also add an empty line at EOF.
-        */
-        lOutputFileStream << std::endl;
+    if(0 > lWriter.flush()) {
+        std::cerr << "[ERROR] <INI::exportJson> The output sink failed" << std::endl;
+        return -1;
     }
 
-    std::cout << "[INFO ] <INI::generateFile> Successfully generated INI file " << pDest << std::endl;
     return 0;
 }
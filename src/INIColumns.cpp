@@ -0,0 +1,98 @@
+/**
+ * @brief INI columnar extraction classes implementation
+ *
+ * @file INIColumns.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIColumns.hpp"
+
+/* C++ System */
+#include <string>
+#include <vector>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI column class ------------------------------------ */
+INIColumn::INIColumn() :
+    mType(INI_TYPE_NONE),
+    mRows(0U)
+{
+    /* Empty for now */
+}
+
+void INIColumn::reset(const INIColumnSpec &pSpec, const size_t &pRows) {
+    mKey  = pSpec.mKey;
+    mType = pSpec.mType;
+    mRows = pRows;
+
+    mValidity.assign((pRows + 63U) / 64U, 0U);
+    mInt64s.clear();
+    mDoubles.clear();
+    mBooleans.clear();
+    mStrings.clear();
+
+    switch(mType) {
+        case INI_TYPE_INT64:
+            mInt64s.assign(pRows, 0);
+            break;
+        case INI_TYPE_DOUBLE:
+            mDoubles.assign(pRows, 0.0);
+            break;
+        case INI_TYPE_BOOLEAN:
+            mBooleans.assign(pRows, 0U);
+            break;
+        case INI_TYPE_STRING:
+            mStrings.assign(pRows, std::string_view());
+            break;
+        default:
+            break;
+    }
+}
+
+const std::string &INIColumn::key(void) const {
+    return mKey;
+}
+
+INIValueType INIColumn::type(void) const {
+    return mType;
+}
+
+size_t INIColumn::size(void) const {
+    return mRows;
+}
+
+bool INIColumn::valid(const size_t &pRow) const {
+    return 0U != (mValidity[pRow / 64U] & (1ULL << (pRow % 64U)));
+}
+
+size_t INIColumn::validCount(void) const {
+    size_t lCount = 0U;
+    for(const uint64_t lWord : mValidity) {
+        lCount += static_cast<size_t>(__builtin_popcountll(lWord));
+    }
+
+    return lCount;
+}
+
+INIArrayView<uint64_t> INIColumn::validity(void) const {
+    return INIArrayView<uint64_t>(mValidity.data(), mValidity.size());
+}
+
+INIArrayView<int64_t> INIColumn::int64s(void) const {
+    return INIArrayView<int64_t>(mInt64s.data(), mInt64s.size());
+}
+
+INIArrayView<double> INIColumn::doubles(void) const {
+    return INIArrayView<double>(mDoubles.data(), mDoubles.size());
+}
+
+INIArrayView<uint8_t> INIColumn::booleans(void) const {
+    return INIArrayView<uint8_t>(mBooleans.data(), mBooleans.size());
+}
+
+INIArrayView<std::string_view> INIColumn::strings(void) const {
+    return INIArrayView<std::string_view>(mStrings.data(), mStrings.size());
+}
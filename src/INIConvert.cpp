@@ -0,0 +1,119 @@
+/**
+ * @brief INI value conversion class implementation
+ *
+ * @file INIConvert.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIConvert.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+
+/* C System */
+#include <cstdlib>
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+/** @brief Values shorter than this are converted without allocating */
+#define INI_CONVERT_BUFFER_SIZE 64U
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+/** @brief strto* need a terminated string, views are not */
+template<typename F>
+static int convert(const std::string_view &pStr, F pConvert) {
+    if(INI_CONVERT_BUFFER_SIZE > pStr.size()) {
+        char lBuf[INI_CONVERT_BUFFER_SIZE];
+        std::memcpy(lBuf, pStr.data(), pStr.size());
+        lBuf[pStr.size()] = '\0';
+
+        return pConvert(lBuf);
+    }
+
+    std::string lStr(pStr);
+    return pConvert(lStr.c_str());
+}
+
+static bool isHex(const std::string_view &pStr) {
+    return std::string_view::npos != pStr.find("0x");
+}
+
+/* INI value conversion class -------------------------- */
+int INIConvert::toInt64(const std::string_view &pStr, int64_t &pValue) {
+    const int lBase = isHex(pStr) ? 16 : 10;
+
+    return convert(pStr, [&pValue, lBase](const char *pBuf) {
+        char *lEnd = nullptr;
+        pValue = strtoll(pBuf, &lEnd, lBase);
+        return *lEnd == 0 ? 0 : -1;
+    });
+}
+
+int INIConvert::toUInt64(const std::string_view &pStr, uint64_t &pValue) {
+    const int lBase = isHex(pStr) ? 16 : 10;
+
+    return convert(pStr, [&pValue, lBase](const char *pBuf) {
+        char *lEnd = nullptr;
+        pValue = strtoull(pBuf, &lEnd, lBase);
+        return *lEnd == 0 ? 0 : -1;
+    });
+}
+
+int INIConvert::toDouble(const std::string_view &pStr, double &pValue) {
+    return convert(pStr, [&pValue](const char *pBuf) {
+        char *lEnd = nullptr;
+        pValue = strtod(pBuf, &lEnd);
+        return *lEnd == 0 ? 0 : -1;
+    });
+}
+
+int INIConvert::toBoolean(const std::string_view &pStr, bool &pValue) {
+    if(("true" == pStr)
+        || ("True" == pStr)
+        || ("1" == pStr))
+    {
+        pValue = true;
+    } else if (("false" == pStr)
+        || ("False" == pStr)
+        || ("0" == pStr))
+    {
+        pValue = false;
+    } else {
+        /* Unexpected value */
+        return -1;
+    }
+
+    return 0;
+}
+
+int INIConvert::toTyped(const std::string_view &pStr, const INIValueType &pType, INITypedValue &pValue) {
+    int lResult = 0;
+
+    switch(pType) {
+        case INI_TYPE_INT64:
+            lResult = toInt64(pStr, pValue.mInt64);
+            break;
+        case INI_TYPE_UINT64:
+            lResult = toUInt64(pStr, pValue.mUInt64);
+            break;
+        case INI_TYPE_DOUBLE:
+            lResult = toDouble(pStr, pValue.mDouble);
+            break;
+        case INI_TYPE_BOOLEAN:
+            lResult = toBoolean(pStr, pValue.mBoolean);
+            break;
+        case INI_TYPE_STRING:
+            /* Nothing to convert */
+            break;
+        default:
+            lResult = -1;
+            break;
+    }
+
+    pValue.mType = (0 == lResult) ? pType : INI_TYPE_NONE;
+
+    return lResult;
+}
@@ -0,0 +1,297 @@
+/**
+ * @brief INI stream decompressor class implementation
+ *
+ * @file INIDecompressor.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIDecompressor.hpp"
+#include "INIParser.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <istream>
+#include <algorithm>
+
+/* C System */
+#include <cstring>
+
+#ifdef INI_HAVE_ZLIB
+#include <zlib.h>
+#endif /* INI_HAVE_ZLIB */
+
+#ifdef INI_HAVE_ZSTD
+#include <zstd.h>
+#endif /* INI_HAVE_ZSTD */
+
+/* Defines --------------------------------------------- */
+/** @brief Window bits of zlib, +16 to only accept gzip headers */
+#define INI_GZIP_WINDOW_BITS (15 + 16)
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static const unsigned char sGzipMagic[] = {0x1FU, 0x8BU};
+static const unsigned char sZstdMagic[] = {0x28U, 0xB5U, 0x2FU, 0xFDU};
+
+static bool startsWith(const char *pData, const size_t &pSize, const unsigned char *pMagic, const size_t &pMagicSize) {
+    return (pMagicSize <= pSize) && (0 == std::memcmp(pData, pMagic, pMagicSize));
+}
+
+static const char *compressionName(const INICompression &pCompression) {
+    switch(pCompression) {
+        case INI_COMPRESSION_GZIP:
+            return "gzip";
+        case INI_COMPRESSION_ZSTD:
+            return "zstd";
+        default:
+            return "none";
+    }
+}
+
+/* INI decompressor class ------------------------------ */
+INIDecompressor::INIDecompressor(std::istream &pStream) :
+    mStream(pStream),
+    mInput(INI_PARSER_CHUNK_SIZE),
+    mBegin(0U),
+    mEnd(0U),
+    mCompression(INI_COMPRESSION_NONE),
+    mStarted(false),
+    mFinished(false),
+    mOutputFull(false),
+    mZlib(nullptr),
+    mZstd(nullptr)
+{
+    /* Empty for now */
+}
+
+INIDecompressor::~INIDecompressor() {
+#ifdef INI_HAVE_ZLIB
+    if(nullptr != mZlib) {
+        inflateEnd(mZlib);
+        delete mZlib;
+    }
+#endif /* INI_HAVE_ZLIB */
+
+#ifdef INI_HAVE_ZSTD
+    if(nullptr != mZstd) {
+        ZSTD_freeDStream(mZstd);
+    }
+#endif /* INI_HAVE_ZSTD */
+}
+
+bool INIDecompressor::supports(const INICompression &pCompression) {
+    switch(pCompression) {
+        case INI_COMPRESSION_NONE:
+            return true;
+#ifdef INI_HAVE_ZLIB
+        case INI_COMPRESSION_GZIP:
+            return true;
+#endif /* INI_HAVE_ZLIB */
+#ifdef INI_HAVE_ZSTD
+        case INI_COMPRESSION_ZSTD:
+            return true;
+#endif /* INI_HAVE_ZSTD */
+        default:
+            return false;
+    }
+}
+
+INICompression INIDecompressor::compression(void) const {
+    return mCompression;
+}
+
+long INIDecompressor::fill(void) {
+    if(mBegin < mEnd) {
+        /* Input left to consume */
+        return static_cast<long>(mEnd - mBegin);
+    }
+
+    mStream.read(mInput.data(), mInput.size());
+    if(mStream.bad()) {
+        /* Reading failed, not just reached EOF */
+        return -1;
+    }
+
+    mBegin = 0U;
+    mEnd   = static_cast<size_t>(mStream.gcount());
+
+    return static_cast<long>(mEnd);
+}
+
+int INIDecompressor::start(void) {
+    mStarted = true;
+
+    if(0 > fill()) {
+        return -1;
+    }
+
+    if(startsWith(mInput.data(), mEnd, sGzipMagic, sizeof(sGzipMagic))) {
+        mCompression = INI_COMPRESSION_GZIP;
+    } else if(startsWith(mInput.data(), mEnd, sZstdMagic, sizeof(sZstdMagic))) {
+        mCompression = INI_COMPRESSION_ZSTD;
+    } else {
+        mCompression = INI_COMPRESSION_NONE;
+        return 0;
+    }
+
+    if(!supports(mCompression)) {
+        std::cerr << "[ERROR] <INIDecompressor::start> " << compressionName(mCompression) << " support is disabled in this build" << std::endl;
+        return -1;
+    }
+
+#ifdef INI_HAVE_ZLIB
+    if(INI_COMPRESSION_GZIP == mCompression) {
+        mZlib = new z_stream();
+        if(Z_OK != inflateInit2(mZlib, INI_GZIP_WINDOW_BITS)) {
+            std::cerr << "[ERROR] <INIDecompressor::start> Failed to initialize zlib" << std::endl;
+            delete mZlib;
+            mZlib = nullptr;
+            return -1;
+        }
+    }
+#endif /* INI_HAVE_ZLIB */
+
+#ifdef INI_HAVE_ZSTD
+    if(INI_COMPRESSION_ZSTD == mCompression) {
+        mZstd = ZSTD_createDStream();
+        if((nullptr == mZstd) || ZSTD_isError(ZSTD_initDStream(mZstd))) {
+            std::cerr << "[ERROR] <INIDecompressor::start> Failed to initialize zstd" << std::endl;
+            return -1;
+        }
+    }
+#endif /* INI_HAVE_ZSTD */
+
+    return 0;
+}
+
+long INIDecompressor::read(char *pOut, const size_t &pSize) {
+    if(!mStarted && (0 > start())) {
+        return -1;
+    }
+
+    switch(mCompression) {
+        case INI_COMPRESSION_GZIP:
+            return readGzip(pOut, pSize);
+        case INI_COMPRESSION_ZSTD:
+            return readZstd(pOut, pSize);
+        default:
+            break;
+    }
+
+    /* Plain text, copied through */
+    long lAvailable = fill();
+    if(0 >= lAvailable) {
+        return lAvailable;
+    }
+
+    const size_t lSize = std::min(pSize, static_cast<size_t>(lAvailable));
+    std::memcpy(pOut, mInput.data() + mBegin, lSize);
+    mBegin += lSize;
+
+    return static_cast<long>(lSize);
+}
+
+long INIDecompressor::readGzip(char *pOut, const size_t &pSize) {
+#ifdef INI_HAVE_ZLIB
+    size_t lProduced = 0U;
+
+    while(0U == lProduced) {
+        if(!mOutputFull) {
+            /* The decoder needs more input */
+            long lAvailable = fill();
+            if(0 > lAvailable) {
+                return -1;
+            }
+
+            if(0 == lAvailable) {
+                if(mFinished) {
+                    return 0;
+                }
+
+                std::cerr << "[ERROR] <INIDecompressor::readGzip> Truncated gzip stream" << std::endl;
+                return -1;
+            }
+
+            if(mFinished) {
+                /* Another member follows (concatenated gzip files) */
+                inflateReset(mZlib);
+                mFinished = false;
+            }
+        }
+
+        mZlib->next_in   = reinterpret_cast<Bytef *>(mInput.data() + mBegin);
+        mZlib->avail_in  = static_cast<uInt>(mEnd - mBegin);
+        mZlib->next_out  = reinterpret_cast<Bytef *>(pOut);
+        mZlib->avail_out = static_cast<uInt>(pSize);
+
+        int lResult = inflate(mZlib, Z_NO_FLUSH);
+
+        mBegin      = mEnd - mZlib->avail_in;
+        lProduced   = pSize - mZlib->avail_out;
+        mOutputFull = (0U == mZlib->avail_out);
+
+        if(Z_STREAM_END == lResult) {
+            mFinished   = true;
+            mOutputFull = false;
+        } else if((Z_OK != lResult) && (Z_BUF_ERROR != lResult)) {
+            std::cerr << "[ERROR] <INIDecompressor::readGzip> Corrupt gzip stream" << std::endl;
+            return -1;
+        }
+    }
+
+    return static_cast<long>(lProduced);
+#else /* INI_HAVE_ZLIB */
+    (void)pOut;
+    (void)pSize;
+    return -1;
+#endif /* INI_HAVE_ZLIB */
+}
+
+long INIDecompressor::readZstd(char *pOut, const size_t &pSize) {
+#ifdef INI_HAVE_ZSTD
+    size_t lProduced = 0U;
+
+    while(0U == lProduced) {
+        if(!mOutputFull) {
+            /* The decoder needs more input */
+            long lAvailable = fill();
+            if(0 > lAvailable) {
+                return -1;
+            }
+
+            if(0 == lAvailable) {
+                if(mFinished) {
+                    return 0;
+                }
+
+                std::cerr << "[ERROR] <INIDecompressor::readZstd> Truncated zstd stream" << std::endl;
+                return -1;
+            }
+        }
+
+        ZSTD_inBuffer  lIn  = {mInput.data() + mBegin, mEnd - mBegin, 0U};
+        ZSTD_outBuffer lOut = {pOut, pSize, 0U};
+
+        /* Concatenated frames are decoded one after the other */
+        size_t lResult = ZSTD_decompressStream(mZstd, &lOut, &lIn);
+        if(ZSTD_isError(lResult)) {
+            std::cerr << "[ERROR] <INIDecompressor::readZstd> Corrupt zstd stream : " << ZSTD_getErrorName(lResult) << std::endl;
+            return -1;
+        }
+
+        mBegin     += lIn.pos;
+        lProduced   = lOut.pos;
+        mOutputFull = (pSize == lOut.pos);
+
+        /* 0 means that a frame is complete and fully flushed */
+        mFinished = (0U == lResult);
+    }
+
+    return static_cast<long>(lProduced);
+#else /* INI_HAVE_ZSTD */
+    (void)pOut;
+    (void)pSize;
+    return -1;
+#endif /* INI_HAVE_ZSTD */
+}
@@ -0,0 +1,331 @@
+/**
+ * @brief INI document diff class implementation
+ *
+ * @file INIDiff.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIDiff.hpp"
+#include "INI.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static bool sameValue(const INIEntry &pLeft, const INIEntry &pRight) {
+    if(pLeft.mValue.atom() == pRight.mValue.atom()) {
+        /* Same interned string */
+        return true;
+    }
+
+    /* Only compare the bytes of values hashing the same */
+    return (pLeft.hash() == pRight.hash()) && (pLeft.mValue.view() == pRight.mValue.view());
+}
+
+static bool sameEdit(const INIEdit &pLeft, const INIEdit &pRight) {
+    return (pLeft.mOp == pRight.mOp) && (pLeft.mValue.view() == pRight.mValue.view());
+}
+
+static bool isSectionEdit(const INIEdit &pEdit) {
+    return (INI_EDIT_ADD_SECTION == pEdit.mOp) || (INI_EDIT_REMOVE_SECTION == pEdit.mOp);
+}
+
+/** @brief Are the names of pDoc compared ignoring case ? */
+static bool folds(const INI &pDoc) {
+    return 0U != (pDoc.mode() & INI_MODE_CASE_INSENSITIVE);
+}
+
+/** @brief End of the edits of the section pFirst belongs to.
+ * The edits of a section may spell its name differently
+ * when folding, e.g. "[Server]" removals and "[server]" additions. */
+static const INIEdit *sectionEnd(const INIEdit *pFirst, const INIEdit *pEnd, const bool &pFold) {
+    const INIEdit *lIt = pFirst;
+    while((pEnd != lIt) && (0 == ININame::compare(lIt->mSection, pFirst->mSection, pFold))) {
+        ++lIt;
+    }
+
+    return lIt;
+}
+
+/** @brief Sections in the order of the walk, by name, folded if pFold.
+ * A case-sensitive document is not in folded order by itself. */
+static std::vector<const INISection *> sortedSections(const INI &pDoc, const bool &pFold) {
+    std::vector<const INISection *> lSections;
+
+    const INISectionQuery lQuery = pDoc.querySections("*");
+    for(auto lIt = lQuery.begin(); lQuery.end() != lIt; ++lIt) {
+        lSections.push_back(&lIt.value());
+    }
+
+    if(pFold && !folds(pDoc)) {
+        std::stable_sort(lSections.begin(), lSections.end(),
+            [](const INISection *pLeft, const INISection *pRight) { return 0 > ININame::compare(pLeft->mName, pRight->mName, true); });
+    }
+
+    return lSections;
+}
+
+/** @brief Entries in the order of the walk, with their keys as first
+ * written : in case-insensitive mode, the map keys are folded */
+static std::vector<std::pair<INIString, const INIEntry *>> sortedEntries(const INISection &pSection, const bool &pFold) {
+    std::vector<std::pair<INIString, const INIEntry *>> lEntries;
+    lEntries.reserve(pSection.mOrder.size());
+
+    for(const INIString &lKey : pSection.mOrder) {
+        lEntries.emplace_back(lKey, &pSection.mEntries.find(lKey.view())->second);
+    }
+
+    std::stable_sort(lEntries.begin(), lEntries.end(),
+        [&pFold](const std::pair<INIString, const INIEntry *> &pLeft, const std::pair<INIString, const INIEntry *> &pRight) {
+            return 0 > ININame::compare(pLeft.first, pRight.first, pFold);
+        });
+
+    return lEntries;
+}
+
+static void diffEntries(const INISection &pFrom, const INISection &pTo, const bool &pFold, std::vector<INIEdit> &pScript) {
+    const std::vector<std::pair<INIString, const INIEntry *>> lFromEntries = sortedEntries(pFrom, pFold);
+    const std::vector<std::pair<INIString, const INIEntry *>> lToEntries   = sortedEntries(pTo, pFold);
+
+    auto lFrom = lFromEntries.begin();
+    auto lTo   = lToEntries.begin();
+
+    while((lFromEntries.end() != lFrom) || (lToEntries.end() != lTo)) {
+        int lOrder = 0;
+        if(lFromEntries.end() == lFrom) {
+            lOrder = 1;
+        } else if(lToEntries.end() == lTo) {
+            lOrder = -1;
+        } else {
+            lOrder = ININame::compare(lFrom->first, lTo->first, pFold);
+        }
+
+        if(0 > lOrder) {
+            pScript.push_back({INI_EDIT_REMOVE_KEY, pFrom.mName, lFrom->first, INIString()});
+            ++lFrom;
+        } else if(0 < lOrder) {
+            pScript.push_back({INI_EDIT_ADD_KEY, pTo.mName, lTo->first, lTo->second->mValue});
+            ++lTo;
+        } else {
+            if(!sameValue(*lFrom->second, *lTo->second)) {
+                pScript.push_back({INI_EDIT_CHANGE_KEY, pTo.mName, lTo->first, lTo->second->mValue});
+            }
+            ++lFrom;
+            ++lTo;
+        }
+    }
+}
+
+/* INI diff class -------------------------------------- */
+int INIDiff::diff(const INI &pFrom, const INI &pTo, std::vector<INIEdit> &pScript) {
+    pScript.clear();
+
+    /* Every entry is compared : equal fingerprints do not prove
+     * equal contents, as sums of hashes they may collide */
+    const bool lFold = folds(pFrom) || folds(pTo);
+
+    const std::vector<const INISection *> lFromSections = sortedSections(pFrom, lFold);
+    const std::vector<const INISection *> lToSections   = sortedSections(pTo, lFold);
+
+    auto lFrom = lFromSections.begin();
+    auto lTo   = lToSections.begin();
+
+    while((lFromSections.end() != lFrom) || (lToSections.end() != lTo)) {
+        int lOrder = 0;
+        if(lFromSections.end() == lFrom) {
+            lOrder = 1;
+        } else if(lToSections.end() == lTo) {
+            lOrder = -1;
+        } else {
+            lOrder = ININame::compare((*lFrom)->mName, (*lTo)->mName, lFold);
+        }
+
+        if(0 > lOrder) {
+            pScript.push_back({INI_EDIT_REMOVE_SECTION, (*lFrom)->mName, INIString(), INIString()});
+            ++lFrom;
+        } else if(0 < lOrder) {
+            const INISection &lSection = **lTo;
+            pScript.push_back({INI_EDIT_ADD_SECTION, lSection.mName, INIString(), INIString()});
+            for(const auto &lEntry : sortedEntries(lSection, lFold)) {
+                pScript.push_back({INI_EDIT_ADD_KEY, lSection.mName, lEntry.first, lEntry.second->mValue});
+            }
+            ++lTo;
+        } else {
+            diffEntries(**lFrom, **lTo, lFold, pScript);
+            ++lFrom;
+            ++lTo;
+        }
+    }
+
+    return 0;
+}
+
+int INIDiff::merge(const INI &pBase,
+    const INI &pOurs,
+    const INI &pTheirs,
+    std::vector<INIEdit> &pScript,
+    std::vector<INIConflict> &pConflicts)
+{
+    std::vector<INIEdit> lOurs;
+    std::vector<INIEdit> lTheirs;
+
+    pScript.clear();
+    pConflicts.clear();
+
+    const bool lFold = folds(pBase) || folds(pOurs) || folds(pTheirs);
+
+    diff(pBase, pOurs, lOurs);
+    diff(pBase, pTheirs, lTheirs);
+
+    /* Walk both scripts, one section at a time */
+    const INIEdit *lOursIt     = lOurs.data();
+    const INIEdit *lOursEnd    = lOurs.data() + lOurs.size();
+    const INIEdit *lTheirsIt   = lTheirs.data();
+    const INIEdit *lTheirsEnd  = lTheirs.data() + lTheirs.size();
+
+    while((lOursEnd != lOursIt) || (lTheirsEnd != lTheirsIt)) {
+        int lOrder = 0;
+        if(lOursEnd == lOursIt) {
+            lOrder = 1;
+        } else if(lTheirsEnd == lTheirsIt) {
+            lOrder = -1;
+        } else {
+            lOrder = ININame::compare(lOursIt->mSection, lTheirsIt->mSection, lFold);
+        }
+
+        if(0 > lOrder) {
+            /* Only changed on our side, nothing to bring */
+            lOursIt = sectionEnd(lOursIt, lOursEnd, lFold);
+        } else if(0 < lOrder) {
+            /* Only changed on their side */
+            const INIEdit *lEnd = sectionEnd(lTheirsIt, lTheirsEnd, lFold);
+            pScript.insert(pScript.end(), lTheirsIt, lEnd);
+            lTheirsIt = lEnd;
+        } else {
+            const INIEdit *lOursSectionEnd   = sectionEnd(lOursIt, lOursEnd, lFold);
+            const INIEdit *lTheirsSectionEnd = sectionEnd(lTheirsIt, lTheirsEnd, lFold);
+            mergeSection(lOursIt, lOursSectionEnd, lTheirsIt, lTheirsSectionEnd, lFold, pScript, pConflicts);
+            lOursIt   = lOursSectionEnd;
+            lTheirsIt = lTheirsSectionEnd;
+        }
+    }
+
+    if(!pConflicts.empty()) {
+        std::cerr << "[ERROR] <INIDiff::merge> " << pConflicts.size() << " conflict(s)" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+void INIDiff::mergeSection(const INIEdit *pOurs, const INIEdit *pOursEnd,
+    const INIEdit *pTheirs, const INIEdit *pTheirsEnd,
+    const bool &pFold,
+    std::vector<INIEdit> &pScript,
+    std::vector<INIConflict> &pConflicts)
+{
+    /* The section edit, if any, comes first */
+    const INIEdit *lOursSection   = isSectionEdit(*pOurs) ? pOurs++ : nullptr;
+    const INIEdit *lTheirsSection = isSectionEdit(*pTheirs) ? pTheirs++ : nullptr;
+
+    if((nullptr != lTheirsSection) && (INI_EDIT_REMOVE_SECTION == lTheirsSection->mOp)) {
+        if((nullptr != lOursSection) && (INI_EDIT_REMOVE_SECTION == lOursSection->mOp)) {
+            /* Removed on both sides */
+            return;
+        }
+
+        /* We changed keys of a section they removed,
+         * our removals agree with theirs */
+        const size_t lConflicts = pConflicts.size();
+        for(; pOursEnd != pOurs; ++pOurs) {
+            if(INI_EDIT_REMOVE_KEY != pOurs->mOp) {
+                pConflicts.push_back({*pOurs, *lTheirsSection});
+            }
+        }
+
+        if(lConflicts == pConflicts.size()) {
+            pScript.push_back(*lTheirsSection);
+        }
+        return;
+    }
+
+    if((nullptr != lOursSection) && (INI_EDIT_REMOVE_SECTION == lOursSection->mOp)) {
+        /* They changed keys of a section we removed */
+        for(; pTheirsEnd != pTheirs; ++pTheirs) {
+            if(INI_EDIT_REMOVE_KEY != pTheirs->mOp) {
+                pConflicts.push_back({*lOursSection, *pTheirs});
+            }
+        }
+        return;
+    }
+
+    if((nullptr != lTheirsSection) && (nullptr == lOursSection)) {
+        pScript.push_back(*lTheirsSection);
+    }
+
+    /* Merge the key edits */
+    while((pOursEnd != pOurs) || (pTheirsEnd != pTheirs)) {
+        int lOrder = 0;
+        if(pOursEnd == pOurs) {
+            lOrder = 1;
+        } else if(pTheirsEnd == pTheirs) {
+            lOrder = -1;
+        } else {
+            lOrder = ININame::compare(pOurs->mKey, pTheirs->mKey, pFold);
+        }
+
+        if(0 > lOrder) {
+            ++pOurs;
+        } else if(0 < lOrder) {
+            pScript.push_back(*pTheirs);
+            ++pTheirs;
+        } else {
+            if(!sameEdit(*pOurs, *pTheirs)) {
+                pConflicts.push_back({*pOurs, *pTheirs});
+            }
+            ++pOurs;
+            ++pTheirs;
+        }
+    }
+}
+
+int INIDiff::apply(INI &pDoc, const std::vector<INIEdit> &pScript) {
+    for(const auto &lEdit : pScript) {
+        int lResult = -1;
+
+        switch(lEdit.mOp) {
+            case INI_EDIT_ADD_SECTION:
+                lResult = pDoc.addSection(lEdit.mSection.str());
+                break;
+            case INI_EDIT_REMOVE_SECTION:
+                lResult = pDoc.removeSection(lEdit.mSection.str());
+                break;
+            case INI_EDIT_ADD_KEY:
+                lResult = pDoc.addString(lEdit.mKey.str(), lEdit.mValue.str(), lEdit.mSection.str());
+                break;
+            case INI_EDIT_REMOVE_KEY:
+                lResult = pDoc.removeKey(lEdit.mSection.str(), lEdit.mKey.str());
+                break;
+            case INI_EDIT_CHANGE_KEY:
+                lResult = pDoc.setString(lEdit.mKey.str(), lEdit.mValue.str(), lEdit.mSection.str());
+                break;
+            default:
+                break;
+        }
+
+        if(0 != lResult) {
+            std::cerr << "[ERROR] <INIDiff::apply> Failed to apply the edit of (" << lEdit.mSection.view() << ", " << lEdit.mKey.view() << ")" << std::endl;
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @brief INI frozen index class implementation
+ *
+ * @file INIFrozen.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIFrozen.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+/* C System */
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+/** @brief Displacements tried for a bucket before changing the seed */
+#define INI_FROZEN_MAX_DISPLACEMENT (1U << 20U)
+
+/** @brief Seeds tried before giving up */
+#define INI_FROZEN_MAX_SEEDS 16U
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+
+/* INI frozen index class ------------------------------ */
+INIFrozenIndex::INIFrozenIndex(const bool &pFold) :
+    mFold(pFold),
+    mSeed(0U)
+{
+    /* Empty for now */
+}
+
+int INIFrozenIndex::build(const std::vector<INIFrozenItem> &pItems) {
+    mDisplacements.clear();
+    mSlots.clear();
+
+    if(pItems.empty()) {
+        return 0;
+    }
+
+    if(UINT32_MAX <= pItems.size()) {
+        std::cerr << "[ERROR] <INIFrozenIndex::build> Too many entries" << std::endl;
+        return -1;
+    }
+
+    std::vector<uint64_t>              lHashes(pItems.size());
+    std::vector<std::vector<uint32_t>> lBuckets;
+    std::vector<uint32_t>              lOrder;
+    std::vector<bool>                  lTaken;
+    std::vector<size_t>                lSlots;
+
+    for(uint64_t lSeed = 0U; lSeed < INI_FROZEN_MAX_SEEDS; ++lSeed) {
+        mSeed = lSeed * 0x9E3779B97F4A7C15ULL;
+        mDisplacements.assign((pItems.size() + INI_FROZEN_BUCKET_SIZE - 1U) / INI_FROZEN_BUCKET_SIZE, 0U);
+        mSlots.assign(pItems.size(), INIFrozenSlot{0U, std::string_view(), std::string_view(), nullptr});
+
+        /* Hash every pair into its bucket */
+        lBuckets.assign(mDisplacements.size(), std::vector<uint32_t>());
+        for(size_t i = 0U; i < pItems.size(); ++i) {
+            lHashes[i] = hash(pItems[i].mSection, pItems[i].mKey);
+            lBuckets[bucket(lHashes[i])].push_back(static_cast<uint32_t>(i));
+        }
+
+        /* Place the largest buckets first, while most slots are free */
+        lOrder.resize(lBuckets.size());
+        std::iota(lOrder.begin(), lOrder.end(), 0U);
+        std::stable_sort(lOrder.begin(), lOrder.end(),
+            [&lBuckets](const uint32_t &pLeft, const uint32_t &pRight) { return lBuckets[pLeft].size() > lBuckets[pRight].size(); });
+
+        lTaken.assign(pItems.size(), false);
+
+        bool lPlaced = true;
+        for(const uint32_t &lBucket : lOrder) {
+            const std::vector<uint32_t> &lItems = lBuckets[lBucket];
+            if(lItems.empty()) {
+                /* Buckets are sorted, the others are empty too */
+                break;
+            }
+
+            /* Find a displacement sending every key of the bucket to a distinct free slot */
+            uint32_t lDisplacement = 0U;
+            for(; lDisplacement < INI_FROZEN_MAX_DISPLACEMENT; ++lDisplacement) {
+                lSlots.clear();
+                for(const uint32_t &lItem : lItems) {
+                    const size_t lSlot = slot(lHashes[lItem], lDisplacement);
+                    if(lTaken[lSlot] || (lSlots.end() != std::find(lSlots.begin(), lSlots.end(), lSlot))) {
+                        break;
+                    }
+
+                    lSlots.push_back(lSlot);
+                }
+
+                if(lSlots.size() == lItems.size()) {
+                    break;
+                }
+            }
+
+            if(INI_FROZEN_MAX_DISPLACEMENT == lDisplacement) {
+                /* Most likely two pairs with the same hash, try another seed */
+                lPlaced = false;
+                break;
+            }
+
+            mDisplacements[lBucket] = lDisplacement;
+            for(size_t i = 0U; i < lItems.size(); ++i) {
+                const INIFrozenItem &lItem = pItems[lItems[i]];
+
+                lTaken[lSlots[i]] = true;
+                mSlots[lSlots[i]] = INIFrozenSlot{lHashes[lItems[i]], lItem.mSection, lItem.mKey, lItem.mEntry};
+            }
+        }
+
+        if(lPlaced) {
+            return 0;
+        }
+    }
+
+    std::cerr << "[ERROR] <INIFrozenIndex::build> Failed to build the hash" << std::endl;
+    mDisplacements.clear();
+    mSlots.clear();
+
+    return -1;
+}
+
+size_t INIFrozenIndex::size(void) const {
+    return mSlots.size();
+}
+
+size_t INIFrozenIndex::memoryUsage(void) const {
+    return sizeof(INIFrozenIndex)
+        + mDisplacements.capacity() * sizeof(uint32_t)
+        + mSlots.capacity() * sizeof(INIFrozenSlot);
+}
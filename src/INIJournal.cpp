@@ -0,0 +1,591 @@
+/**
+ * @brief INI change journal class implementation
+ *
+ * @file INIJournal.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIJournal.hpp"
+#include "INI.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <thread>
+
+/* C System */
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Defines --------------------------------------------- */
+/** @brief Magic and version */
+#define INI_JOURNAL_HEADER_SIZE 8U
+
+/** @brief Operation, then the section, key and value sizes */
+#define INI_JOURNAL_RECORD_HEAD_SIZE 13U
+
+/** @brief Checksum closing each record */
+#define INI_JOURNAL_RECORD_TAIL_SIZE 4U
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+/** @brief FNV-1a, enough to detect a torn record */
+static uint32_t checksum(const char *pData, const size_t &pSize) {
+    uint32_t lHash = 2166136261U;
+    for(size_t i = 0U; i < pSize; ++i) {
+        lHash ^= static_cast<uint8_t>(pData[i]);
+        lHash *= 16777619U;
+    }
+
+    return lHash;
+}
+
+static void putU32(std::string &pOut, const uint32_t &pValue) {
+    char lBytes[sizeof(uint32_t)];
+    std::memcpy(lBytes, &pValue, sizeof(lBytes));
+    pOut.append(lBytes, sizeof(lBytes));
+}
+
+static uint32_t getU32(const char *pData) {
+    uint32_t lValue = 0U;
+    std::memcpy(&lValue, pData, sizeof(lValue));
+    return lValue;
+}
+
+static int writeAll(const int &pFd, const char *pData, size_t pSize) {
+    while(0U < pSize) {
+        ssize_t lWritten = write(pFd, pData, pSize);
+        if(0 > lWritten) {
+            if(EINTR == errno) {
+                continue;
+            }
+            return -1;
+        }
+
+        pData += lWritten;
+        pSize -= static_cast<size_t>(lWritten);
+    }
+
+    return 0;
+}
+
+static int syncFile(const std::string &pPath) {
+    int lFd = ::open(pPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if(0 > lFd) {
+        return -1;
+    }
+
+    int lResult = fsync(lFd);
+    ::close(lFd);
+
+    return lResult;
+}
+
+static std::string directoryOf(const std::string &pPath) {
+    size_t lSlash = pPath.rfind('/');
+    if(std::string::npos == lSlash) {
+        return ".";
+    }
+
+    return (0U == lSlash) ? "/" : pPath.substr(0U, lSlash);
+}
+
+static std::string journalHeader(void) {
+    std::string lHeader;
+    putU32(lHeader, INI_JOURNAL_MAGIC);
+    putU32(lHeader, INI_JOURNAL_VERSION);
+
+    return lHeader;
+}
+
+/* INI journal class ----------------------------------- */
+INIJournal::INIJournal(INI &pINI, const std::string &pPath, const size_t &pThreshold) :
+    mINI(pINI),
+    mPath(pPath.empty() ? pINI.fileName() + ".journal" : pPath),
+    mThreshold(pThreshold),
+    mFd(-1),
+    mAppended(0U),
+    mDurable(0U),
+    mSyncing(false),
+    mCompacting(false),
+    mFailed(false),
+    mSize(0U)
+{
+    /* Empty for now */
+}
+
+INIJournal::~INIJournal() {
+    close();
+}
+
+int INIJournal::open(void) {
+    close();
+
+    std::lock_guard<std::mutex> lLock(mMutex);
+    mFailed = false;
+
+    /* Read the existing journal, if any */
+    std::string lData;
+    {
+        std::ifstream lStream(mPath, std::ios::in | std::ios::binary);
+        if(lStream.is_open()) {
+            std::ostringstream lContents;
+            lContents << lStream.rdbuf();
+            lData = lContents.str();
+        }
+    }
+
+    mFd = ::open(mPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(0 > mFd) {
+        std::cerr << "[ERROR] <INIJournal::open> Failed to open journal " << mPath << std::endl;
+        return -1;
+    }
+
+    if(lData.size() < INI_JOURNAL_HEADER_SIZE) {
+        /* New (or unusable) journal, start it over */
+        const std::string lHeader = journalHeader();
+        if((0 != ftruncate(mFd, 0)) || (0 > writeAll(mFd, lHeader.data(), lHeader.size())) || (0 != fdatasync(mFd))) {
+            std::cerr << "[ERROR] <INIJournal::open> Failed to initialize journal " << mPath << std::endl;
+            ::close(mFd);
+            mFd = -1;
+            return -1;
+        }
+
+        mSize = lHeader.size();
+        return 0;
+    }
+
+    if((INI_JOURNAL_MAGIC != getU32(lData.data())) || (INI_JOURNAL_VERSION != getU32(lData.data() + 4U))) {
+        std::cerr << "[ERROR] <INIJournal::open> " << mPath << " is not a journal" << std::endl;
+        ::close(mFd);
+        mFd = -1;
+        return -1;
+    }
+
+    size_t lValid = INI_JOURNAL_HEADER_SIZE;
+    if(0 > replay(lData, lValid)) {
+        ::close(mFd);
+        mFd = -1;
+        return -1;
+    }
+
+    if(lValid < lData.size()) {
+        /* Drop the record torn by a crash */
+        std::cerr << "[WARN ] <INIJournal::open> Dropping " << (lData.size() - lValid) << " bytes of incomplete record(s)" << std::endl;
+        if(0 != ftruncate(mFd, static_cast<off_t>(lValid))) {
+            ::close(mFd);
+            mFd = -1;
+            return -1;
+        }
+    }
+
+    mSize = lValid;
+    return 0;
+}
+
+void INIJournal::close(void) {
+    std::thread lCompactor;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        lCompactor.swap(mCompactor);
+    }
+
+    if(lCompactor.joinable()) {
+        lCompactor.join();
+    }
+
+    std::unique_lock<std::mutex> lLock(mMutex);
+    mCondition.wait(lLock, [this]() { return !mSyncing; });
+
+    if(0 <= mFd) {
+        if(!mPending.empty() && !mFailed) {
+            (void)writeAll(mFd, mPending.data(), mPending.size());
+            (void)fdatasync(mFd);
+        }
+
+        ::close(mFd);
+        mFd = -1;
+    }
+
+    mPending.clear();
+    if(!mFailed) {
+        mDurable = mAppended;
+    }
+}
+
+int INIJournal::replay(const std::string &pData, size_t &pValid) {
+    size_t lPos = INI_JOURNAL_HEADER_SIZE;
+
+    while(INI_JOURNAL_RECORD_HEAD_SIZE <= (pData.size() - lPos)) {
+        const char *lRecord = pData.data() + lPos;
+        const uint64_t lSectionSize = getU32(lRecord + 1U);
+        const uint64_t lKeySize     = getU32(lRecord + 5U);
+        const uint64_t lValueSize   = getU32(lRecord + 9U);
+        const uint64_t lSize        = INI_JOURNAL_RECORD_HEAD_SIZE + lSectionSize + lKeySize + lValueSize;
+
+        if((lSize + INI_JOURNAL_RECORD_TAIL_SIZE) > (pData.size() - lPos)) {
+            /* Incomplete record */
+            break;
+        }
+
+        if(checksum(lRecord, lSize) != getU32(lRecord + lSize)) {
+            /* Torn record */
+            break;
+        }
+
+        const char *lStrings = lRecord + INI_JOURNAL_RECORD_HEAD_SIZE;
+        if(0 > apply(static_cast<INIJournalOp>(lRecord[0U]),
+            std::string_view(lStrings, lSectionSize),
+            std::string_view(lStrings + lSectionSize, lKeySize),
+            std::string_view(lStrings + lSectionSize + lKeySize, lValueSize)))
+        {
+            std::cerr << "[ERROR] <INIJournal::replay> Failed to replay the record at offset " << lPos << std::endl;
+            return -1;
+        }
+
+        lPos   += lSize + INI_JOURNAL_RECORD_TAIL_SIZE;
+        pValid  = lPos;
+    }
+
+    return 0;
+}
+
+int INIJournal::apply(const INIJournalOp &pOp,
+    const std::string_view &pSection,
+    const std::string_view &pKey,
+    const std::string_view &pValue)
+{
+    const std::string lSection(pSection);
+    const std::string lKey(pKey);
+
+    switch(pOp) {
+        case INI_JOURNAL_OP_PUT:
+            if(!mINI.sectionExists(lSection) && (0 != mINI.addSection(lSection))) {
+                return -1;
+            }
+
+            if(mINI.keyExists(lKey, lSection)) {
+                return mINI.setString(lKey, std::string(pValue), lSection);
+            }
+
+            return mINI.addString(lKey, std::string(pValue), lSection);
+        case INI_JOURNAL_OP_REMOVE_KEY:
+            return mINI.keyExists(lKey, lSection) ? mINI.removeKey(lSection, lKey) : 0;
+        case INI_JOURNAL_OP_ADD_SECTION:
+            return mINI.sectionExists(lSection) ? 0 : mINI.addSection(lSection);
+        case INI_JOURNAL_OP_REMOVE_SECTION:
+            return mINI.sectionExists(lSection) ? mINI.removeSection(lSection) : 0;
+        default:
+            return -1;
+    }
+}
+
+uint64_t INIJournal::append(const INIJournalOp &pOp,
+    const std::string_view &pSection,
+    const std::string_view &pKey,
+    const std::string_view &pValue)
+{
+    const size_t lStart = mPending.size();
+
+    mPending.push_back(static_cast<char>(pOp));
+    putU32(mPending, static_cast<uint32_t>(pSection.size()));
+    putU32(mPending, static_cast<uint32_t>(pKey.size()));
+    putU32(mPending, static_cast<uint32_t>(pValue.size()));
+    mPending.append(pSection);
+    mPending.append(pKey);
+    mPending.append(pValue);
+    putU32(mPending, checksum(mPending.data() + lStart, mPending.size() - lStart));
+
+    mSize += mPending.size() - lStart;
+
+    return ++mAppended;
+}
+
+int INIJournal::fail(const char *pFunction) {
+    std::cerr << "[ERROR] <" << pFunction << "> Failed to write journal " << mPath << ", no longer journaling" << std::endl;
+
+    /* The records not written yet will never be */
+    mFailed = true;
+    mPending.clear();
+    mCondition.notify_all();
+
+    return -1;
+}
+
+int INIJournal::commit(const uint64_t &pSequence) {
+    std::unique_lock<std::mutex> lLock(mMutex);
+
+    while(mDurable < pSequence) {
+        if(mFailed) {
+            /* Our record was in a failed batch, or queued behind it */
+            return -1;
+        }
+
+        if(mSyncing) {
+            /* Another setter is writing, our record may be in its batch */
+            mCondition.wait(lLock);
+            continue;
+        }
+
+        /* Write every pending record at once */
+        std::string lBatch;
+        lBatch.swap(mPending);
+        const uint64_t lTarget = mAppended;
+        mSyncing = true;
+
+        lLock.unlock();
+        int lResult = writeAll(mFd, lBatch.data(), lBatch.size());
+        if(0 == lResult) {
+            lResult = fdatasync(mFd);
+        }
+        lLock.lock();
+
+        mSyncing = false;
+        mCondition.notify_all();
+
+        if(0 != lResult) {
+            return fail("INIJournal::commit");
+        }
+
+        mDurable = lTarget;
+    }
+
+    if((mSize > mThreshold) && !mCompacting) {
+        mCompacting = true;
+        lLock.unlock();
+        startCompaction();
+    }
+
+    return 0;
+}
+
+int INIJournal::setString(const std::string &pKey, const std::string &pValue, const std::string &pSection) {
+    uint64_t lSequence = 0U;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        if((0 > mFd) || mFailed || (0 != mINI.setString(pKey, pValue, pSection))) {
+            return -1;
+        }
+
+        lSequence = append(INI_JOURNAL_OP_PUT, pSection, pKey, pValue);
+    }
+
+    return commit(lSequence);
+}
+
+int INIJournal::setInt64(const std::string &pKey, const int64_t &pValue, const std::string &pSection) {
+    return setString(pKey, std::to_string(pValue), pSection);
+}
+
+int INIJournal::setUInt64(const std::string &pKey, const uint64_t &pValue, const std::string &pSection) {
+    return setString(pKey, std::to_string(pValue), pSection);
+}
+
+int INIJournal::addString(const std::string &pKey, const std::string &pValue, const std::string &pSection) {
+    uint64_t lSequence = 0U;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        if((0 > mFd) || mFailed || (0 != mINI.addString(pKey, pValue, pSection))) {
+            return -1;
+        }
+
+        lSequence = append(INI_JOURNAL_OP_PUT, pSection, pKey, pValue);
+    }
+
+    return commit(lSequence);
+}
+
+int INIJournal::addSection(const std::string &pSection) {
+    uint64_t lSequence = 0U;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        if((0 > mFd) || mFailed || (0 != mINI.addSection(pSection))) {
+            return -1;
+        }
+
+        lSequence = append(INI_JOURNAL_OP_ADD_SECTION, pSection, std::string_view(), std::string_view());
+    }
+
+    return commit(lSequence);
+}
+
+int INIJournal::removeKey(const std::string &pSection, const std::string &pKey) {
+    uint64_t lSequence = 0U;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        if((0 > mFd) || mFailed || (0 != mINI.removeKey(pSection, pKey))) {
+            return -1;
+        }
+
+        lSequence = append(INI_JOURNAL_OP_REMOVE_KEY, pSection, pKey, std::string_view());
+    }
+
+    return commit(lSequence);
+}
+
+int INIJournal::removeSection(const std::string &pSection) {
+    uint64_t lSequence = 0U;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        if((0 > mFd) || mFailed || (0 != mINI.removeSection(pSection))) {
+            return -1;
+        }
+
+        lSequence = append(INI_JOURNAL_OP_REMOVE_SECTION, pSection, std::string_view(), std::string_view());
+    }
+
+    return commit(lSequence);
+}
+
+void INIJournal::startCompaction(void) {
+    std::thread lPrevious;
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        lPrevious.swap(mCompactor);
+
+        mCompactor = std::thread([this]() {
+            std::unique_lock<std::mutex> lLock(mMutex);
+            (void)compactLocked(lLock);
+        });
+    }
+
+    if(lPrevious.joinable()) {
+        /* The previous compaction is over, mCompacting was cleared */
+        lPrevious.join();
+    }
+}
+
+int INIJournal::compact(void) {
+    std::unique_lock<std::mutex> lLock(mMutex);
+    mCondition.wait(lLock, [this]() { return !mCompacting; });
+    mCompacting = true;
+
+    return compactLocked(lLock);
+}
+
+int INIJournal::compactLocked(std::unique_lock<std::mutex> &pLock) {
+    int lResult = -1;
+
+    do {
+        const std::string lFile = mINI.fileName();
+        if((0 > mFd) || lFile.empty()) {
+            std::cerr << "[ERROR] <INIJournal::compact> The document has no file to be compacted into" << std::endl;
+            break;
+        }
+
+        if(mFailed) {
+            /* The document holds changes the setters were told failed */
+            std::cerr << "[ERROR] <INIJournal::compact> The journal failed, the document cannot be compacted" << std::endl;
+            break;
+        }
+
+        /* Snapshot the document in memory, and the journal size it includes */
+        std::ostringstream lSnapshot;
+        if(0 != mINI.generate(lSnapshot)) {
+            break;
+        }
+        const std::string lContents = lSnapshot.str();
+        const size_t lIncluded = mSize;
+
+        /* Write and replace the file without blocking the setters.
+         * Until the journal is truncated, replaying it over
+         * the new file is harmless. */
+        const std::string lTemp = lFile + ".compact";
+        pLock.unlock();
+        bool lReplaced = false;
+        int lTempFd = ::open(lTemp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(0 <= lTempFd) {
+            lReplaced = (0 == writeAll(lTempFd, lContents.data(), lContents.size()))
+                && (0 == fsync(lTempFd));
+            ::close(lTempFd);
+        }
+        lReplaced = lReplaced
+            && (0 == std::rename(lTemp.c_str(), lFile.c_str()))
+            && (0 == syncFile(directoryOf(lFile)));
+        pLock.lock();
+
+        if(!lReplaced) {
+            std::cerr << "[ERROR] <INIJournal::compact> Failed to replace " << lFile << std::endl;
+            std::remove(lTemp.c_str());
+            break;
+        }
+
+        /* Flush the records appended meanwhile, then keep only them */
+        mCondition.wait(pLock, [this]() { return !mSyncing; });
+        if(mFailed) {
+            break;
+        }
+
+        if(!mPending.empty()) {
+            if((0 > writeAll(mFd, mPending.data(), mPending.size())) || (0 != fdatasync(mFd))) {
+                (void)fail("INIJournal::compact");
+                break;
+            }
+            mPending.clear();
+            mDurable = mAppended;
+            mCondition.notify_all();
+        }
+
+        std::string lTail;
+        {
+            std::ifstream lStream(mPath, std::ios::in | std::ios::binary);
+            lStream.seekg(static_cast<std::streamoff>(lIncluded));
+            std::ostringstream lContents;
+            lContents << lStream.rdbuf();
+            lTail = lContents.str();
+        }
+
+        const std::string lJournal = journalHeader() + lTail;
+        const std::string lJournalTemp = mPath + ".compact";
+        int lFd = ::open(lJournalTemp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(0 > lFd) {
+            break;
+        }
+
+        if((0 > writeAll(lFd, lJournal.data(), lJournal.size()))
+            || (0 != fdatasync(lFd))
+            || (0 != std::rename(lJournalTemp.c_str(), mPath.c_str())))
+        {
+            ::close(lFd);
+            std::remove(lJournalTemp.c_str());
+            break;
+        }
+        ::close(lFd);
+
+        /* Append to the new journal from now on */
+        ::close(mFd);
+        mFd   = ::open(mPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        mSize = lJournal.size();
+        (void)syncFile(directoryOf(mPath));
+
+        lResult = (0 > mFd) ? -1 : 0;
+    } while(false);
+
+    mCompacting = false;
+    mCondition.notify_all();
+
+    return lResult;
+}
+
+const std::string &INIJournal::path(void) const {
+    return mPath;
+}
+
+size_t INIJournal::size(void) const {
+    std::lock_guard<std::mutex> lLock(mMutex);
+    return mSize;
+}
+
+bool INIJournal::failed(void) const {
+    std::lock_guard<std::mutex> lLock(mMutex);
+    return mFailed;
+}
@@ -0,0 +1,160 @@
+/**
+ * @brief INI JSON writer class implementation
+ *
+ * @file INIJson.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIJson.hpp"
+
+/* C++ System */
+#include <string_view>
+#include <algorithm>
+
+/* C System */
+#include <cstdint>
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+#define INI_JSON_ONES 0x0101010101010101ULL
+#define INI_JSON_HIGH 0x8080808080808080ULL
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static bool isEscaped(const unsigned char &pChar) {
+    return (0x20U > pChar) || ('"' == pChar) || ('\\' == pChar);
+}
+
+/** @brief Does one of the eight bytes of a word need escaping ? */
+static bool hasEscaped(const uint64_t &pWord) {
+    const uint64_t lQuote     = pWord ^ ('"' * INI_JSON_ONES);
+    const uint64_t lBackslash = pWord ^ ('\\' * INI_JSON_ONES);
+
+    /* A byte below 0x20, or a zero byte once XOR'ed */
+    const uint64_t lControl  = (pWord - (0x20ULL * INI_JSON_ONES)) & ~pWord;
+    const uint64_t lQuotes   = (lQuote - INI_JSON_ONES) & ~lQuote;
+    const uint64_t lSlashes  = (lBackslash - INI_JSON_ONES) & ~lBackslash;
+
+    return 0U != ((lControl | lQuotes | lSlashes) & INI_JSON_HIGH);
+}
+
+/** @brief Position of the next byte to escape, pSize if there is none */
+static size_t nextEscaped(const char *pData, size_t pPos, const size_t &pSize) {
+    for(; (pPos + sizeof(uint64_t)) <= pSize; pPos += sizeof(uint64_t)) {
+        uint64_t lWord;
+        std::memcpy(&lWord, pData + pPos, sizeof(lWord));
+        if(hasEscaped(lWord)) {
+            break;
+        }
+    }
+
+    for(; pPos < pSize; ++pPos) {
+        if(isEscaped(static_cast<unsigned char>(pData[pPos]))) {
+            break;
+        }
+    }
+
+    return pPos;
+}
+
+/* INI JSON writer class ------------------------------- */
+INIJsonWriter::INIJsonWriter(const INIWriteCallback &pSink, const size_t &pChunkSize) :
+    mSink(pSink),
+    mBuffer(std::max<size_t>(pChunkSize, 1U)),
+    mSize(0U),
+    mFailed(false)
+{
+    /* Empty for now */
+}
+
+int INIJsonWriter::write(const std::string_view &pText) {
+    const char *lData = pText.data();
+    size_t      lLeft = pText.size();
+
+    while(0U < lLeft) {
+        if(mFailed) {
+            return -1;
+        }
+
+        const size_t lSize = std::min(lLeft, mBuffer.size() - mSize);
+        std::memcpy(mBuffer.data() + mSize, lData, lSize);
+        mSize += lSize;
+        lData += lSize;
+        lLeft -= lSize;
+
+        if((mBuffer.size() == mSize) && (0 > flush())) {
+            return -1;
+        }
+    }
+
+    return mFailed ? -1 : 0;
+}
+
+int INIJsonWriter::writeString(const std::string_view &pStr) {
+    static const char sHex[] = "0123456789abcdef";
+
+    write("\"");
+
+    size_t lPos = 0U;
+    while(lPos < pStr.size()) {
+        /* Copy the run of plain bytes at once */
+        const size_t lNext = nextEscaped(pStr.data(), lPos, pStr.size());
+        write(pStr.substr(lPos, lNext - lPos));
+
+        if(pStr.size() == lNext) {
+            break;
+        }
+
+        const char lChar = pStr[lNext];
+        switch(lChar) {
+            case '"':
+                write("\\\"");
+                break;
+            case '\\':
+                write("\\\\");
+                break;
+            case '\n':
+                write("\\n");
+                break;
+            case '\r':
+                write("\\r");
+                break;
+            case '\t':
+                write("\\t");
+                break;
+            case '\b':
+                write("\\b");
+                break;
+            case '\f':
+                write("\\f");
+                break;
+            default: {
+                const char lEscape[] = {'\\', 'u', '0', '0', sHex[(lChar >> 4) & 0xF], sHex[lChar & 0xF]};
+                write(std::string_view(lEscape, sizeof(lEscape)));
+                break;
+            }
+        }
+
+        lPos = lNext + 1U;
+    }
+
+    return write("\"");
+}
+
+int INIJsonWriter::flush(void) {
+    if(mFailed) {
+        return -1;
+    }
+
+    if(0U < mSize) {
+        if(0 > mSink(mBuffer.data(), mSize)) {
+            mFailed = true;
+            return -1;
+        }
+
+        mSize = 0U;
+    }
+
+    return 0;
+}
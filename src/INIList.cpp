@@ -0,0 +1,77 @@
+/**
+ * @brief INI list value class implementation
+ *
+ * @file INIList.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIList.hpp"
+
+/* C++ System */
+#include <string_view>
+#include <vector>
+
+/* C System */
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static bool isBlank(const char pChar) {
+    return (' ' == pChar) || ('\t' == pChar) || ('\r' == pChar) || ('\f' == pChar) || ('\v' == pChar);
+}
+
+/* INI list class -------------------------------------- */
+INIList::INIList() :
+    mDelim(',')
+{
+    /* Empty for now */
+}
+
+int INIList::assign(const std::string_view &pValue, const char &pDelim) {
+    mItems.clear();
+    mArrays.clear();
+    mDelim = pDelim;
+
+    const char *lCursor = pValue.data();
+    const char *lEnd    = pValue.data() + pValue.size();
+
+    while(lCursor < lEnd) {
+        /* memchr scans a word or more at a time */
+        const char *lDelim = static_cast<const char *>(std::memchr(lCursor, pDelim, lEnd - lCursor));
+        if(nullptr == lDelim) {
+            lDelim = lEnd;
+        }
+
+        /* Like split, an empty element ends the list */
+        if(lDelim == lCursor) {
+            break;
+        }
+
+        /* Remove the whitespaces around the element */
+        const char *lFirst = lCursor;
+        const char *lLast  = lDelim;
+        while((lFirst < lLast) && isBlank(*lFirst)) {
+            ++lFirst;
+        }
+        while((lFirst < lLast) && isBlank(*(lLast - 1))) {
+            --lLast;
+        }
+
+        mItems.emplace_back(lFirst, lLast - lFirst);
+
+        lCursor = lDelim + 1;
+    }
+
+    return 0;
+}
+
+char INIList::delimiter(void) const {
+    return mDelim;
+}
+
+INIArrayView<std::string_view> INIList::items(void) const {
+    return INIArrayView<std::string_view>(mItems.data(), mItems.size());
+}
@@ -0,0 +1,118 @@
+/**
+ * @brief INI asynchronous loader class implementation
+ *
+ * @file INILoader.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INILoader.hpp"
+#include "INI.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <exception>
+#include <utility>
+
+/* C System */
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI loader class ------------------------------------ */
+INILoader::INILoader(const size_t &pWorkers) :
+    mPrefetcher(1U),
+    mPool(pWorkers)
+{
+    /* Empty for now */
+}
+
+INILoader::~INILoader() {
+    /* The pool runs the pending loads before joining */
+}
+
+void INILoader::prefetch(const std::string &pFile) {
+    int lFd = open(pFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if(0 > lFd) {
+        /* The worker will report the error */
+        return;
+    }
+
+    /* Start reading the whole file in the background,
+     * the page cache keeps it once the descriptor is closed */
+    (void)posix_fadvise(lFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    (void)posix_fadvise(lFd, 0, 0, POSIX_FADV_WILLNEED);
+
+    close(lFd);
+}
+
+void INILoader::submit(const std::string &pFile, const uint32_t &pMode, INILoadHandler pHandler) {
+    mPrefetcher.submit([pFile]() {
+        prefetch(pFile);
+    });
+
+    mPool.submit([pFile, pHandler, pMode]() {
+        std::unique_ptr<INI> lINI;
+        std::exception_ptr   lError;
+        int lResult = -1;
+
+        try {
+            lINI.reset(new INI(pMode));
+
+            lResult = lINI->parseFile(pFile);
+        } catch(...) {
+            lError  = std::current_exception();
+            lResult = -1;
+        }
+
+        if(0 != lResult) {
+            lINI.reset();
+        }
+
+        pHandler(pFile, lResult, std::move(lINI), lError);
+    });
+}
+
+void INILoader::load(const std::string &pFile, INILoadCallback pCallback, const uint32_t &pMode) {
+    submit(pFile, pMode, [pCallback](const std::string &pName, int pResult, std::unique_ptr<INI> pINI, std::exception_ptr pError) {
+        (void)pError;
+
+        pCallback(pName, pResult, std::move(pINI));
+    });
+}
+
+std::future<std::unique_ptr<INI>> INILoader::load(const std::string &pFile, const uint32_t &pMode) {
+    std::shared_ptr<std::promise<std::unique_ptr<INI>>> lPromise = std::make_shared<std::promise<std::unique_ptr<INI>>>();
+    std::future<std::unique_ptr<INI>> lFuture = lPromise->get_future();
+
+    submit(pFile, pMode, [lPromise](const std::string &pName, int pResult, std::unique_ptr<INI> pINI, std::exception_ptr pError) {
+        if(0 != pResult) {
+            std::cerr << "[ERROR] <INILoader::load> Failed to load file " << pName << std::endl;
+            lPromise->set_exception((nullptr != pError) ? pError : std::make_exception_ptr(INIException()));
+            return;
+        }
+
+        lPromise->set_value(std::move(pINI));
+    });
+
+    return lFuture;
+}
+
+std::vector<std::future<std::unique_ptr<INI>>> INILoader::load(const std::vector<std::string> &pFiles, const uint32_t &pMode) {
+    std::vector<std::future<std::unique_ptr<INI>>> lFutures;
+    lFutures.reserve(pFiles.size());
+
+    /* Each read is requested on submission, while the workers
+     * are already parsing the first files */
+    for(const auto &lFile : pFiles) {
+        lFutures.push_back(load(lFile, pMode));
+    }
+
+    return lFutures;
+}
@@ -0,0 +1,78 @@
+/**
+ * @brief INI name comparison class implementation
+ *
+ * @file ININame.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "ININame.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <algorithm>
+
+/* C System */
+#include <cstdint>
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+
+/* INI name class -------------------------------------- */
+void ININame::fold(char *pData, const size_t &pSize) {
+    size_t i = 0U;
+    for(; (i + sizeof(uint64_t)) <= pSize; i += sizeof(uint64_t)) {
+        uint64_t lWord;
+        std::memcpy(&lWord, pData + i, sizeof(lWord));
+        lWord = foldWord(lWord);
+        std::memcpy(pData + i, &lWord, sizeof(lWord));
+    }
+
+    for(; i < pSize; ++i) {
+        pData[i] = fold(pData[i]);
+    }
+}
+
+std::string ININame::folded(const std::string_view &pName) {
+    std::string lName(pName);
+    fold(&lName[0U], lName.size());
+
+    return lName;
+}
+
+int ININame::compare(const std::string_view &pLeft, const std::string_view &pRight, const bool &pFold) {
+    if(!pFold) {
+        return pLeft.compare(pRight);
+    }
+
+    const size_t lSize = std::min(pLeft.size(), pRight.size());
+    size_t i = 0U;
+
+    /* Skip the equal words, then find the first differing byte */
+    for(; (i + sizeof(uint64_t)) <= lSize; i += sizeof(uint64_t)) {
+        uint64_t lLeft, lRight;
+        std::memcpy(&lLeft, pLeft.data() + i, sizeof(lLeft));
+        std::memcpy(&lRight, pRight.data() + i, sizeof(lRight));
+        if(foldWord(lLeft) != foldWord(lRight)) {
+            break;
+        }
+    }
+
+    for(; i < lSize; ++i) {
+        const unsigned char lLeft  = static_cast<unsigned char>(fold(pLeft[i]));
+        const unsigned char lRight = static_cast<unsigned char>(fold(pRight[i]));
+        if(lLeft != lRight) {
+            return (lLeft < lRight) ? -1 : 1;
+        }
+    }
+
+    if(pLeft.size() == pRight.size()) {
+        return 0;
+    }
+
+    return (pLeft.size() < pRight.size()) ? -1 : 1;
+}
@@ -0,0 +1,407 @@
+/**
+ * @brief INI streaming parser class implementation
+ *
+ * @file INIParser.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIParser.hpp"
+#include "INIDecompressor.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <istream>
+#include <vector>
+
+/* C System */
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+/** @brief States of the value being parsed, in multi-line mode */
+enum {
+    INI_VALUE_NONE = 0U,
+    INI_VALUE_PLAIN,            /**< May go on with indented lines */
+    INI_VALUE_JOINED,           /**< Ended with '\\', goes on with the next line */
+    INI_VALUE_QUOTED,           /**< Inside quotes, goes on with the next line */
+    INI_VALUE_QUOTED_JOINED,    /**< Inside quotes, ended with '\\' */
+};
+
+/* Helper functions ------------------------------------ */
+static const char *sBlanks = " \t\r\f\v";
+
+static std::string_view trim(const std::string_view &pStr) {
+    size_t lStart = pStr.find_first_not_of(sBlanks);
+    if(std::string_view::npos == lStart) {
+        return std::string_view();
+    }
+
+    size_t lEnd = pStr.find_last_not_of(sBlanks);
+    return pStr.substr(lStart, lEnd - lStart + 1U);
+}
+
+/* INI parser class ------------------------------------ */
+INIParser::INIParser(INIParserHandler &pHandler, const uint32_t &pOptions) :
+    mHandler(pHandler),
+    mOptions(pOptions),
+    mSection("default"),
+    mLine(0U),
+    mStopped(false),
+    mLineBegin(nullptr),
+    mValueLine(0U),
+    mValueColumn(0U),
+    mValueState(INI_VALUE_NONE)
+{
+    /* Empty for now */
+}
+
+INIParser::~INIParser() {
+    /* Empty for now */
+}
+
+void INIParser::reset(void) {
+    mPending.clear();
+    mSection = "default";
+    mLine    = 0U;
+    mStopped = false;
+
+    mKey.clear();
+    mValue.clear();
+    mValueLine   = 0U;
+    mValueColumn = 0U;
+    mValueState  = INI_VALUE_NONE;
+}
+
+uint32_t INIParser::line(void) const {
+    return mLine;
+}
+
+const std::string &INIParser::section(void) const {
+    return mSection;
+}
+
+const char *INIParser::errorName(const INIParseError &pError) {
+    switch(pError) {
+        case INI_PARSE_ERROR_UNCLOSED_SECTION:
+            return "unclosed section tag";
+        case INI_PARSE_ERROR_EMPTY_KEY:
+            return "empty key";
+        case INI_PARSE_ERROR_NO_EQUAL_SIGN:
+            return "no '=' sign";
+        case INI_PARSE_ERROR_INVALID_PAIR:
+            return "invalid key/value pair";
+        case INI_PARSE_ERROR_UNCLOSED_QUOTE:
+            return "unclosed quoted value";
+        case INI_PARSE_ERROR_INVALID_ESCAPE:
+            return "invalid escape sequence";
+        case INI_PARSE_ERROR_TEXT_AFTER_QUOTE:
+            return "text after a quoted value";
+        case INI_PARSE_ERROR_DUPLICATE_SECTION:
+            return "duplicate section";
+        case INI_PARSE_ERROR_DUPLICATE_KEY:
+            return "duplicate key";
+        default:
+            return "unknown error";
+    }
+}
+
+uint32_t INIParser::columnOf(const char *pChar) const {
+    return static_cast<uint32_t>(pChar - mLineBegin) + 1U;
+}
+
+int INIParser::feed(const char *pData, const size_t &pSize) {
+    if(mStopped) {
+        return -1;
+    }
+
+    const char *lCursor = pData;
+    const char *lEnd    = pData + pSize;
+
+    while(lCursor < lEnd) {
+        const char *lEOL = static_cast<const char *>(std::memchr(lCursor, '\n', lEnd - lCursor));
+        if(nullptr == lEOL) {
+            /* Keep the incomplete line for the next chunk */
+            mPending.append(lCursor, lEnd - lCursor);
+            break;
+        }
+
+        int lResult = 0;
+        if(mPending.empty()) {
+            /* The whole line is in this chunk, parse it in place */
+            lResult = parseLine(std::string_view(lCursor, lEOL - lCursor));
+        } else {
+            mPending.append(lCursor, lEOL - lCursor);
+            lResult = parseLine(mPending);
+            mPending.clear();
+        }
+
+        if(0 > lResult) {
+            mStopped = true;
+            return -1;
+        }
+
+        lCursor = lEOL + 1;
+    }
+
+    return 0;
+}
+
+int INIParser::finish(void) {
+    if(mStopped) {
+        return -1;
+    }
+
+    /* The last line may not be terminated */
+    if(!mPending.empty()) {
+        int lResult = parseLine(mPending);
+        mPending.clear();
+
+        if(0 > lResult) {
+            mStopped = true;
+            return -1;
+        }
+    }
+
+    /* The last value may still be open */
+    int lResult = 0;
+    if((INI_VALUE_QUOTED == mValueState) || (INI_VALUE_QUOTED_JOINED == mValueState)) {
+        mValueState = INI_VALUE_NONE;
+        lResult = mHandler.onError(INI_PARSE_ERROR_UNCLOSED_QUOTE, mValueLine, mValueColumn);
+    } else {
+        lResult = flushValue();
+    }
+
+    if(0 > lResult) {
+        mStopped = true;
+        return -1;
+    }
+
+    return 0;
+}
+
+int INIParser::parse(std::istream &pStream) {
+    /* gzip and zstd streams are decompressed one chunk at a time */
+    INIDecompressor   lInput(pStream);
+    std::vector<char> lChunk(INI_PARSER_CHUNK_SIZE);
+
+    long lSize = 0;
+    while(0 < (lSize = lInput.read(lChunk.data(), lChunk.size()))) {
+        if(0 > feed(lChunk.data(), static_cast<size_t>(lSize))) {
+            return -1;
+        }
+    }
+
+    if(0 > lSize) {
+        /* Reading or decompressing failed */
+        return -1;
+    }
+
+    return finish();
+}
+
+int INIParser::parseLine(std::string_view pLine) {
+    ++mLine;
+    mLineBegin = pLine.data();
+
+    if(0U != (mOptions & INI_PARSER_MULTILINE)) {
+        int lResult = 0;
+        if(continueValue(pLine, lResult)) {
+            return lResult;
+        }
+
+        /* This line starts something else */
+        lResult = flushValue();
+        if(0 > lResult) {
+            return lResult;
+        }
+    }
+
+    /* Remove prefix and trailing whitespaces */
+    pLine = trim(pLine);
+
+    /* Check if there is something on this line */
+    if(pLine.empty()) {
+        return 0;
+    }
+
+    /* Check if this line is a comment */
+    if('#' == pLine[0U] || ';' == pLine[0U]) {
+        return 0;
+    }
+
+    /* Check if the is a section name */
+    if('[' == pLine[0U]) {
+        /* The section tag is [tag] */
+        size_t lPos = pLine.find(']');
+        if(std::string_view::npos == lPos) {
+            /* End of tag not found, this INI file is corrupt */
+            return mHandler.onError(INI_PARSE_ERROR_UNCLOSED_SECTION, mLine, columnOf(pLine.data()));
+        }
+
+        mSection.assign(pLine.data() + 1U, lPos - 1U);
+
+        return mHandler.onSection(mSection, mLine);
+    }
+
+    /* Now, try to extract the name/value pair */
+    size_t lEq = pLine.find('=');
+    if(std::string_view::npos == lEq) {
+        /* There is no equal sign in the string */
+        return mHandler.onError(INI_PARSE_ERROR_NO_EQUAL_SIGN, mLine, columnOf(pLine.data()));
+    }
+
+    if(0U == lEq) {
+        /* First char is '=', meaning that the key is empty */
+        return mHandler.onError(INI_PARSE_ERROR_EMPTY_KEY, mLine, columnOf(pLine.data()));
+    }
+
+    std::string_view lValue = pLine.substr(lEq + 1U);
+    if(0U != (mOptions & INI_PARSER_MULTILINE)) {
+        /* The value may go on with the next lines */
+        return beginValue(pLine.substr(0U, lEq), lValue);
+    }
+
+    const size_t lSecondEq = lValue.find('=');
+    if(std::string_view::npos != lSecondEq) {
+        /* Three strings seperated by an equal sign */
+        return mHandler.onError(INI_PARSE_ERROR_INVALID_PAIR, mLine, columnOf(lValue.data() + lSecondEq));
+    }
+
+    /* We got a valid key/value pair.
+     * Spaces around the '=' sign are part of the key and value. */
+    return mHandler.onEntry(mSection, pLine.substr(0U, lEq), lValue, mLine);
+}
+
+bool INIParser::continueValue(const std::string_view &pLine, int &pResult) {
+    std::string_view lLine = pLine;
+    if(!lLine.empty() && ('\r' == lLine.back())) {
+        lLine.remove_suffix(1U);
+    }
+
+    pResult = 0;
+
+    switch(mValueState) {
+        case INI_VALUE_QUOTED:
+            /* The line break is part of the value */
+            mValue.push_back('\n');
+            pResult = appendQuoted(lLine);
+            return true;
+        case INI_VALUE_QUOTED_JOINED:
+            mValueState = INI_VALUE_QUOTED;
+            pResult = appendQuoted(lLine);
+            return true;
+        case INI_VALUE_JOINED:
+            appendPlain(trim(lLine));
+            return true;
+        case INI_VALUE_PLAIN:
+            if((0U != (mOptions & INI_PARSER_INDENTED))
+                && !lLine.empty() && ((' ' == lLine[0U]) || ('\t' == lLine[0U])) && !trim(lLine).empty())
+            {
+                /* Indented line, the value goes on on a new line */
+                mValue.push_back('\n');
+                appendPlain(trim(lLine));
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+int INIParser::beginValue(const std::string_view &pKey, const std::string_view &pValue) {
+    mKey.assign(pKey.data(), pKey.size());
+    mValue.clear();
+    mValueLine = mLine;
+
+    const std::string_view lValue = trim(pValue);
+    if(!lValue.empty() && ('"' == lValue[0U])) {
+        mValueState  = INI_VALUE_QUOTED;
+        mValueColumn = columnOf(lValue.data());
+        return appendQuoted(lValue.substr(1U));
+    }
+
+    appendPlain(pValue);
+    return 0;
+}
+
+void INIParser::appendPlain(const std::string_view &pText) {
+    if(!pText.empty() && ('\\' == pText.back())) {
+        mValue.append(pText.data(), pText.size() - 1U);
+        mValueState = INI_VALUE_JOINED;
+    } else {
+        mValue.append(pText.data(), pText.size());
+        mValueState = INI_VALUE_PLAIN;
+    }
+}
+
+int INIParser::appendQuoted(const std::string_view &pText) {
+    size_t lPos = 0U;
+
+    while(lPos < pText.size()) {
+        const size_t lSpecial = pText.find_first_of("\\\"", lPos);
+        if(std::string_view::npos == lSpecial) {
+            mValue.append(pText.data() + lPos, pText.size() - lPos);
+            break;
+        }
+
+        mValue.append(pText.data() + lPos, lSpecial - lPos);
+        lPos = lSpecial + 1U;
+
+        if('"' == pText[lSpecial]) {
+            /* Closing quote, only a comment may follow */
+            const std::string_view lRest = trim(pText.substr(lPos));
+            if(!lRest.empty() && ('#' != lRest[0U]) && (';' != lRest[0U])) {
+                mValueState = INI_VALUE_NONE;
+                return mHandler.onError(INI_PARSE_ERROR_TEXT_AFTER_QUOTE, mLine, columnOf(lRest.data()));
+            }
+
+            return flushValue();
+        }
+
+        if(pText.size() == lPos) {
+            /* Escaped line break, the next line is joined */
+            mValueState = INI_VALUE_QUOTED_JOINED;
+            return 0;
+        }
+
+        switch(pText[lPos]) {
+            case 'n':
+                mValue.push_back('\n');
+                break;
+            case 't':
+                mValue.push_back('\t');
+                break;
+            case 'r':
+                mValue.push_back('\r');
+                break;
+            case '\\':
+            case '"':
+                mValue.push_back(pText[lPos]);
+                break;
+            default:
+                mValueState = INI_VALUE_NONE;
+                return mHandler.onError(INI_PARSE_ERROR_INVALID_ESCAPE, mLine, columnOf(pText.data() + lSpecial));
+        }
+
+        ++lPos;
+    }
+
+    return 0;
+}
+
+int INIParser::flushValue(void) {
+    if(INI_VALUE_NONE == mValueState) {
+        return 0;
+    }
+
+    mValueState = INI_VALUE_NONE;
+
+    /* The buffers are cleared, not released */
+    int lResult = mHandler.onEntry(mSection, mKey, mValue, mValueLine);
+    mKey.clear();
+    mValue.clear();
+
+    return lResult;
+}
@@ -0,0 +1,108 @@
+/**
+ * @brief INI name pattern class implementation
+ *
+ * @file INIPattern.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIPattern.hpp"
+
+/* C++ System */
+#include <string_view>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static const char *sWildcards = "*?[";
+
+/* INI pattern class ----------------------------------- */
+bool INIPattern::isPattern(const std::string_view &pPattern) {
+    return std::string_view::npos != pPattern.find_first_of(sWildcards);
+}
+
+std::string_view INIPattern::prefix(const std::string_view &pPattern) {
+    /* Literal characters before the first wildcard */
+    return pPattern.substr(0U, pPattern.find_first_of(sWildcards));
+}
+
+bool INIPattern::matchOne(const std::string_view &pPattern, size_t &pPos, const char &pChar) {
+    const char lFirst = pPattern[pPos];
+
+    if('?' == lFirst) {
+        ++pPos;
+        return true;
+    }
+
+    if('[' == lFirst) {
+        size_t lEnd = pPattern.find(']', pPos + 2U);
+        if(std::string_view::npos != lEnd) {
+            size_t lPos     = pPos + 1U;
+            bool   lNegated = false;
+            bool   lFound   = false;
+
+            if(('!' == pPattern[lPos]) || ('^' == pPattern[lPos])) {
+                lNegated = true;
+                ++lPos;
+            }
+
+            for(; lPos < lEnd; ++lPos) {
+                if((lPos + 2U < lEnd) && ('-' == pPattern[lPos + 1U])) {
+                    /* Character range */
+                    lFound = lFound || ((pPattern[lPos] <= pChar) && (pChar <= pPattern[lPos + 2U]));
+                    lPos += 2U;
+                } else {
+                    lFound = lFound || (pPattern[lPos] == pChar);
+                }
+            }
+
+            pPos = lEnd + 1U;
+            return lFound != lNegated;
+        }
+
+        /* No closing bracket, '[' is a literal */
+    }
+
+    ++pPos;
+    return lFirst == pChar;
+}
+
+bool INIPattern::match(const std::string_view &pPattern, const std::string_view &pStr) {
+    size_t lPat = 0U, lStr = 0U;
+
+    /* Position of the last '*' and of the string when it was met,
+     * to backtrack when the rest of the pattern does not match */
+    size_t lStarPat = std::string_view::npos, lStarStr = 0U;
+
+    while(lStr < pStr.size()) {
+        if((lPat < pPattern.size()) && ('*' == pPattern[lPat])) {
+            lStarPat = lPat++;
+            lStarStr = lStr;
+            continue;
+        }
+
+        size_t lNext = lPat;
+        if((lPat < pPattern.size()) && matchOne(pPattern, lNext, pStr[lStr])) {
+            lPat = lNext;
+            ++lStr;
+            continue;
+        }
+
+        if(std::string_view::npos != lStarPat) {
+            /* Let the last '*' absorb one more character */
+            lPat = lStarPat + 1U;
+            lStr = ++lStarStr;
+            continue;
+        }
+
+        return false;
+    }
+
+    /* Trailing '*' match the empty string */
+    while((lPat < pPattern.size()) && ('*' == pPattern[lPat])) {
+        ++lPat;
+    }
+
+    return lPat == pPattern.size();
+}
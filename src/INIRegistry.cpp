@@ -0,0 +1,281 @@
+/**
+ * @brief INI document registry class implementation
+ *
+ * @file INIRegistry.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIRegistry.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+
+/* C System */
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+typedef std::map<std::string, INIRegistrySlot, std::less<>>::iterator INIRegistrySlotIt;
+
+/* Helper functions ------------------------------------ */
+static std::unique_ptr<INI> loadFile(const std::string &pName) {
+    std::unique_ptr<INI> lINI = std::make_unique<INI>();
+
+    if(0 != lINI->parseFile(pName)) {
+        std::cerr << "[ERROR] <INIRegistry::load> Failed to parse " << pName << std::endl;
+        return nullptr;
+    }
+
+    return lINI;
+}
+
+/* INI registry class ---------------------------------- */
+INIRegistry::INIRegistry(const size_t &pBudget, const INIRegistryLoader &pLoader, const size_t &pShards) :
+    mBudget(pBudget),
+    mLoader(pLoader ? pLoader : INIRegistryLoader(loadFile)),
+    mUsage(0U),
+    mNextShard(0U)
+{
+    mShards.resize(std::max<size_t>(pShards, 1U));
+    for(std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        lShard = std::make_unique<INIRegistryShard>();
+        lShard->mHand = lShard->mSlots.end();
+        lShard->mHits = 0U;
+        lShard->mMisses = 0U;
+        lShard->mWaits = 0U;
+        lShard->mEvictions = 0U;
+    }
+}
+
+INIRegistry::~INIRegistry() {
+    /* Empty for now */
+}
+
+INIRegistryShard &INIRegistry::shard(const std::string_view &pName) {
+    return *mShards[std::hash<std::string_view>()(pName) % mShards.size()];
+}
+
+std::shared_ptr<const INI> INIRegistry::get(const std::string_view &pName) {
+    INIRegistryShard &lShard = shard(pName);
+
+    {
+        std::shared_lock<std::shared_mutex> lLock(lShard.mMutex);
+
+        INIRegistrySlotIt lIt = lShard.mSlots.find(pName);
+        if((lShard.mSlots.end() != lIt) && lIt->second.mLoaded) {
+            lIt->second.mReferenced.store(true, std::memory_order_relaxed);
+            lShard.mHits.fetch_add(1U, std::memory_order_relaxed);
+            return lIt->second.mDocument.get();
+        }
+    }
+
+    return load(lShard, pName);
+}
+
+std::shared_ptr<const INI> INIRegistry::load(INIRegistryShard &pShard, const std::string_view &pName) {
+    std::promise<std::shared_ptr<const INI>> lPromise;
+
+    {
+        std::unique_lock<std::shared_mutex> lLock(pShard.mMutex);
+
+        INIRegistrySlotIt lIt = pShard.mSlots.find(pName);
+        if(pShard.mSlots.end() != lIt) {
+            /* Loaded in the meantime, or being loaded by another thread */
+            std::shared_future<std::shared_ptr<const INI>> lFuture = lIt->second.mDocument;
+            lIt->second.mReferenced.store(true, std::memory_order_relaxed);
+            if(lIt->second.mLoaded) {
+                pShard.mHits.fetch_add(1U, std::memory_order_relaxed);
+            } else {
+                pShard.mWaits.fetch_add(1U, std::memory_order_relaxed);
+            }
+
+            lLock.unlock();
+            return lFuture.get();
+        }
+
+        lIt = pShard.mSlots.emplace(std::piecewise_construct, std::forward_as_tuple(pName), std::forward_as_tuple()).first;
+        lIt->second.mDocument = lPromise.get_future().share();
+        lIt->second.mBytes    = 0U;
+        lIt->second.mLoaded   = false;
+        lIt->second.mReferenced.store(true, std::memory_order_relaxed);
+
+        pShard.mMisses.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    /* Only this thread loads the name, the others wait on the future */
+    std::shared_ptr<const INI> lDocument;
+    try {
+        lDocument = mLoader(std::string(pName));
+    } catch(const std::exception &e) {
+        std::cerr << "[ERROR] <INIRegistry::load> Loader failed for " << pName << " : " << e.what() << std::endl;
+        lDocument = nullptr;
+    } catch(...) {
+        std::cerr << "[ERROR] <INIRegistry::load> Loader failed for " << pName << std::endl;
+        lDocument = nullptr;
+    }
+
+    const size_t lBytes = (nullptr != lDocument) ? lDocument->memoryUsage() : 0U;
+
+    lPromise.set_value(lDocument);
+
+    {
+        std::unique_lock<std::shared_mutex> lLock(pShard.mMutex);
+
+        /* Slots being loaded are neither erased nor evicted */
+        INIRegistrySlotIt lIt = pShard.mSlots.find(pName);
+        if(nullptr == lDocument) {
+            /* Not cached, the next lookup tries again */
+            erase(pShard, lIt);
+        } else {
+            lIt->second.mBytes  = lBytes;
+            lIt->second.mLoaded = true;
+            mUsage.fetch_add(lBytes);
+        }
+    }
+
+    if((nullptr != lDocument) && (0U < mBudget)) {
+        evict();
+    }
+
+    return lDocument;
+}
+
+void INIRegistry::erase(const std::string_view &pName) {
+    INIRegistryShard &lShard = shard(pName);
+    std::unique_lock<std::shared_mutex> lLock(lShard.mMutex);
+
+    INIRegistrySlotIt lIt = lShard.mSlots.find(pName);
+    if((lShard.mSlots.end() != lIt) && lIt->second.mLoaded) {
+        mUsage.fetch_sub(lIt->second.mBytes);
+        erase(lShard, lIt);
+    }
+}
+
+void INIRegistry::clear(void) {
+    for(std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        std::unique_lock<std::shared_mutex> lLock(lShard->mMutex);
+
+        INIRegistrySlotIt lIt = lShard->mSlots.begin();
+        while(lShard->mSlots.end() != lIt) {
+            INIRegistrySlotIt lNext = std::next(lIt);
+            if(lIt->second.mLoaded) {
+                mUsage.fetch_sub(lIt->second.mBytes);
+                erase(*lShard, lIt);
+            }
+            lIt = lNext;
+        }
+    }
+}
+
+void INIRegistry::erase(INIRegistryShard &pShard, INIRegistrySlotIt pIt) {
+    /* Keep the clock hand valid */
+    if(pShard.mHand == pIt) {
+        ++pShard.mHand;
+    }
+
+    pShard.mSlots.erase(pIt);
+}
+
+void INIRegistry::evict(void) {
+    while(mUsage.load() > mBudget) {
+        /* One victim per shard in turn, approximating a global clock */
+        size_t lFreed = 0U;
+        for(size_t i = 0U; (i < mShards.size()) && (0U == lFreed); ++i) {
+            INIRegistryShard &lShard = *mShards[mNextShard.fetch_add(1U) % mShards.size()];
+            lFreed = sweep(lShard);
+        }
+
+        if(0U == lFreed) {
+            /* Everything left is being loaded */
+            break;
+        }
+    }
+}
+
+size_t INIRegistry::sweep(INIRegistryShard &pShard) {
+    std::unique_lock<std::shared_mutex> lLock(pShard.mMutex);
+
+    /* Two turns at most : the first one may only clear the referenced bits */
+    const size_t lSteps = 2U * pShard.mSlots.size();
+    for(size_t i = 0U; i < lSteps; ++i) {
+        if(pShard.mSlots.end() == pShard.mHand) {
+            pShard.mHand = pShard.mSlots.begin();
+        }
+
+        INIRegistrySlot &lSlot = pShard.mHand->second;
+        if(!lSlot.mLoaded) {
+            ++pShard.mHand;
+        } else if(lSlot.mReferenced.exchange(false, std::memory_order_relaxed)) {
+            /* Second chance */
+            ++pShard.mHand;
+        } else {
+            const size_t lBytes = lSlot.mBytes;
+
+            mUsage.fetch_sub(lBytes);
+            pShard.mEvictions.fetch_add(1U, std::memory_order_relaxed);
+            erase(pShard, pShard.mHand);
+
+            /* An empty document still counts as progress */
+            return std::max<size_t>(lBytes, 1U);
+        }
+    }
+
+    return 0U;
+}
+
+size_t INIRegistry::budget(void) const {
+    return mBudget;
+}
+
+size_t INIRegistry::usage(void) const {
+    return mUsage.load();
+}
+
+size_t INIRegistry::size(void) const {
+    size_t lSize = 0U;
+    for(const std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        std::shared_lock<std::shared_mutex> lLock(lShard->mMutex);
+        lSize += lShard->mSlots.size();
+    }
+
+    return lSize;
+}
+
+uint64_t INIRegistry::hits(void) const {
+    uint64_t lHits = 0U;
+    for(const std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        lHits += lShard->mHits.load(std::memory_order_relaxed);
+    }
+
+    return lHits;
+}
+
+uint64_t INIRegistry::misses(void) const {
+    uint64_t lMisses = 0U;
+    for(const std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        lMisses += lShard->mMisses.load(std::memory_order_relaxed);
+    }
+
+    return lMisses;
+}
+
+uint64_t INIRegistry::waits(void) const {
+    uint64_t lWaits = 0U;
+    for(const std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        lWaits += lShard->mWaits.load(std::memory_order_relaxed);
+    }
+
+    return lWaits;
+}
+
+uint64_t INIRegistry::evictions(void) const {
+    uint64_t lEvictions = 0U;
+    for(const std::unique_ptr<INIRegistryShard> &lShard : mShards) {
+        lEvictions += lShard->mEvictions.load(std::memory_order_relaxed);
+    }
+
+    return lEvictions;
+}
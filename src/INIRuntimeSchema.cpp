@@ -0,0 +1,225 @@
+/**
+ * @brief INI runtime schema class implementation
+ *
+ * @file INIRuntimeSchema.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIRuntimeSchema.hpp"
+#include "INIPattern.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <string>
+#include <string_view>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI runtime schema class ---------------------------- */
+INIRuntimeSchema::INIRuntimeSchema() :
+    mAllowUnknownSections(false),
+    mAllowUnknownKeys(false)
+{
+    /* Empty for now */
+}
+
+INIRuntimeSchema::~INIRuntimeSchema() {
+    /* Empty for now */
+}
+
+int INIRuntimeSchema::addSection(const std::string &pSection, const bool &pRequired) {
+    if(mSectionIndex.end() != mSectionIndex.find(pSection)) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::addSection> Section already declared" << std::endl;
+        return -1;
+    }
+
+    if(INIPattern::isPattern(pSection)) {
+        mPatternSections.push_back(mSections.size());
+    }
+
+    mSectionIndex.emplace(pSection, mSections.size());
+    mSections.push_back(INISectionRule{pSection, pRequired, {}});
+
+    return 0;
+}
+
+int INIRuntimeSchema::addKey(const std::string &pSection,
+    const std::string &pKey,
+    const INIValueType &pType,
+    const bool &pRequired)
+{
+    auto lIt = mSectionIndex.find(pSection);
+    if(mSectionIndex.end() == lIt) {
+        /* Declaring a key declares its section */
+        addSection(pSection);
+        lIt = mSectionIndex.find(pSection);
+    }
+
+    INIKeyRule lRule;
+    lRule.mType     = pType;
+    lRule.mRequired = pRequired;
+    lRule.mHasRange = false;
+
+    if(!mSections[lIt->second].mKeys.emplace(pKey, lRule).second) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::addKey> Key already declared" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+INIKeyRule *INIRuntimeSchema::findKey(const std::string &pSection, const std::string &pKey) {
+    auto lSection = mSectionIndex.find(pSection);
+    if(mSectionIndex.end() == lSection) {
+        return nullptr;
+    }
+
+    auto lKey = mSections[lSection->second].mKeys.find(pKey);
+    return (mSections[lSection->second].mKeys.end() == lKey) ? nullptr : &lKey->second;
+}
+
+int INIRuntimeSchema::setIntRange(const std::string &pSection, const std::string &pKey, const int64_t &pMin, const int64_t &pMax) {
+    INIKeyRule *lRule = findKey(pSection, pKey);
+    if((nullptr == lRule) || (INI_TYPE_INT64 != lRule->mType)) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::setIntRange> No such INT64 key" << std::endl;
+        return -1;
+    }
+
+    lRule->mHasRange     = true;
+    lRule->mMin.mInt64   = pMin;
+    lRule->mMax.mInt64   = pMax;
+
+    return 0;
+}
+
+int INIRuntimeSchema::setUIntRange(const std::string &pSection, const std::string &pKey, const uint64_t &pMin, const uint64_t &pMax) {
+    INIKeyRule *lRule = findKey(pSection, pKey);
+    if((nullptr == lRule) || (INI_TYPE_UINT64 != lRule->mType)) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::setUIntRange> No such UINT64 key" << std::endl;
+        return -1;
+    }
+
+    lRule->mHasRange     = true;
+    lRule->mMin.mUInt64  = pMin;
+    lRule->mMax.mUInt64  = pMax;
+
+    return 0;
+}
+
+int INIRuntimeSchema::setDoubleRange(const std::string &pSection, const std::string &pKey, const double &pMin, const double &pMax) {
+    INIKeyRule *lRule = findKey(pSection, pKey);
+    if((nullptr == lRule) || (INI_TYPE_DOUBLE != lRule->mType)) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::setDoubleRange> No such DOUBLE key" << std::endl;
+        return -1;
+    }
+
+    lRule->mHasRange     = true;
+    lRule->mMin.mDouble  = pMin;
+    lRule->mMax.mDouble  = pMax;
+
+    return 0;
+}
+
+int INIRuntimeSchema::setPattern(const std::string &pSection, const std::string &pKey, const std::string &pPattern) {
+    INIKeyRule *lRule = findKey(pSection, pKey);
+    if(nullptr == lRule) {
+        std::cerr << "[ERROR] <INIRuntimeSchema::setPattern> No such key" << std::endl;
+        return -1;
+    }
+
+    lRule->mPattern = pPattern;
+
+    return 0;
+}
+
+void INIRuntimeSchema::allowUnknownSections(const bool &pAllow) {
+    mAllowUnknownSections = pAllow;
+}
+
+void INIRuntimeSchema::allowUnknownKeys(const bool &pAllow) {
+    mAllowUnknownKeys = pAllow;
+}
+
+const std::vector<INISectionRule> &INIRuntimeSchema::sections(void) const {
+    return mSections;
+}
+
+const INISectionRule *INIRuntimeSchema::findSection(const std::string_view &pSection) const {
+    /* Literal names first */
+    auto lIt = mSectionIndex.find(pSection);
+    if((mSectionIndex.end() != lIt) && !INIPattern::isPattern(lIt->first)) {
+        return &mSections[lIt->second];
+    }
+
+    /* Then patterns, in declaration order */
+    for(const size_t &lIndex : mPatternSections) {
+        if(INIPattern::match(mSections[lIndex].mName, pSection)) {
+            return &mSections[lIndex];
+        }
+    }
+
+    return nullptr;
+}
+
+INIViolationKind INIRuntimeSchema::checkSection(const std::string_view &pSection, const INISectionRule *&pRule) const {
+    pRule = findSection(pSection);
+
+    if((nullptr == pRule) && !mAllowUnknownSections) {
+        return INI_VIOLATION_UNKNOWN_SECTION;
+    }
+
+    return INI_VIOLATION_NONE;
+}
+
+INIViolationKind INIRuntimeSchema::checkValue(const INISectionRule *pRule,
+    const std::string_view &pKey,
+    const std::string_view &pValue,
+    INITypedValue &pTyped) const
+{
+    if(nullptr == pRule) {
+        /* Unknown section, already reported */
+        return INI_VIOLATION_NONE;
+    }
+
+    auto lIt = pRule->mKeys.find(pKey);
+    if(pRule->mKeys.end() == lIt) {
+        return mAllowUnknownKeys ? INI_VIOLATION_NONE : INI_VIOLATION_UNKNOWN_KEY;
+    }
+
+    const INIKeyRule &lRule = lIt->second;
+
+    /* Convert the value once, the document keeps it */
+    if(0 != INIConvert::toTyped(pValue, lRule.mType, pTyped)) {
+        return INI_VIOLATION_INVALID_TYPE;
+    }
+
+    if(lRule.mHasRange) {
+        bool lInRange = true;
+
+        switch(lRule.mType) {
+            case INI_TYPE_INT64:
+                lInRange = (lRule.mMin.mInt64 <= pTyped.mInt64) && (pTyped.mInt64 <= lRule.mMax.mInt64);
+                break;
+            case INI_TYPE_UINT64:
+                lInRange = (lRule.mMin.mUInt64 <= pTyped.mUInt64) && (pTyped.mUInt64 <= lRule.mMax.mUInt64);
+                break;
+            case INI_TYPE_DOUBLE:
+                lInRange = (lRule.mMin.mDouble <= pTyped.mDouble) && (pTyped.mDouble <= lRule.mMax.mDouble);
+                break;
+            default:
+                break;
+        }
+
+        if(!lInRange) {
+            return INI_VIOLATION_OUT_OF_RANGE;
+        }
+    }
+
+    if(!lRule.mPattern.empty() && !INIPattern::match(lRule.mPattern, pValue)) {
+        return INI_VIOLATION_PATTERN_MISMATCH;
+    }
+
+    return INI_VIOLATION_NONE;
+}
@@ -0,0 +1,502 @@
+/**
+ * @brief INI shared memory image class implementation
+ *
+ * @file INIShared.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIShared.hpp"
+#include "INI.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+/* C System */
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Defines --------------------------------------------- */
+/** @brief Attempts to map the current image while it is being replaced */
+#define INI_SHARED_ATTACH_RETRIES 8U
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+static std::string imageName(const std::string &pName, const uint64_t &pGeneration) {
+    return pName + "." + std::to_string(pGeneration);
+}
+
+static int mapSegment(const std::string &pName, const int &pFlags, const size_t &pSize, void *&pAddr, size_t &pMapped) {
+    int lFd = shm_open(pName.c_str(), pFlags, 0644);
+    if(0 > lFd) {
+        return -1;
+    }
+
+    /* A segment created here is removed again on failure */
+    const bool lCreated = (O_CREAT | O_EXCL) == (pFlags & (O_CREAT | O_EXCL));
+    const bool lWrite   = (0 != (pFlags & O_RDWR));
+    size_t lSize = pSize;
+
+    if(lWrite) {
+        if(0 != ftruncate(lFd, static_cast<off_t>(lSize))) {
+            close(lFd);
+            if(lCreated) {
+                shm_unlink(pName.c_str());
+            }
+            return -1;
+        }
+    } else {
+        struct stat lStat;
+        if((0 != fstat(lFd, &lStat)) || (0 == lStat.st_size)) {
+            close(lFd);
+            return -1;
+        }
+
+        lSize = static_cast<size_t>(lStat.st_size);
+    }
+
+    pAddr = mmap(nullptr, lSize, lWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, lFd, 0);
+    close(lFd);
+
+    if(MAP_FAILED == pAddr) {
+        pAddr = nullptr;
+        if(lCreated) {
+            shm_unlink(pName.c_str());
+        }
+        return -1;
+    }
+
+    pMapped = lSize;
+    return 0;
+}
+
+/** @brief The count elements of pSize bytes at pOffset fit between pFirst and pEnd */
+static bool fits(const uint64_t &pOffset, const uint64_t &pCount, const size_t &pSize, const size_t &pAlign, const uint64_t &pFirst, const uint64_t &pEnd) {
+    return (pFirst <= pOffset)
+        && (pEnd >= pOffset)
+        && (0U == (pOffset % pAlign))
+        && (pCount <= (pEnd - pOffset) / pSize);
+}
+
+/* INI shared configuration class ---------------------- */
+INISharedConfig::INISharedConfig() :
+    mControl(nullptr),
+    mHeader(nullptr),
+    mMapped(0U),
+    mSections(nullptr),
+    mEntries(nullptr),
+    mStrings(nullptr)
+{
+    /* Empty for now */
+}
+
+INISharedConfig::~INISharedConfig() {
+    detach();
+}
+
+int INISharedConfig::serialize(const INI &pINI, std::string &pImage) {
+    /* Lay out the image : header, sections, entries, strings */
+    std::vector<INISharedSection> lSections;
+    std::vector<INISharedEntry>   lEntries;
+    std::string                   lStrings;
+
+    auto lAddString = [&lStrings](const std::string_view &pStr) {
+        INISharedString lString = {static_cast<uint32_t>(lStrings.size()), static_cast<uint32_t>(pStr.size())};
+        lStrings.append(pStr);
+        lStrings.push_back('\0');
+        return lString;
+    };
+
+    const INISectionQuery lQuery = pINI.querySections("*");
+    for(auto lIt = lQuery.begin(); lIt != lQuery.end(); ++lIt) {
+        const INISection &lSection = lIt.value();
+
+        INISharedSection lShared;
+        lShared.mName       = lAddString(*lIt);
+        lShared.mFirstEntry = static_cast<uint32_t>(lEntries.size());
+        lShared.mEntryCount = static_cast<uint32_t>(lSection.mEntries.size());
+        lSections.push_back(lShared);
+
+        for(const auto &lEntry : lSection.mEntries) {
+            lEntries.push_back({lAddString(lEntry.first), lAddString(lEntry.second.mValue)});
+        }
+    }
+
+    if(UINT32_MAX < lStrings.size()) {
+        std::cerr << "[ERROR] <INISharedConfig::serialize> Document is too large for an image" << std::endl;
+        return -1;
+    }
+
+    INISharedHeader lHeader;
+    std::memset(&lHeader, 0, sizeof(lHeader));
+    lHeader.mMagic          = INI_SHARED_MAGIC;
+    lHeader.mVersion        = INI_SHARED_VERSION;
+    lHeader.mFlags          = (0U != (pINI.mode() & INI_MODE_CASE_INSENSITIVE)) ? INI_SHARED_FLAG_FOLDED : 0U;
+    lHeader.mSectionCount   = static_cast<uint32_t>(lSections.size());
+    lHeader.mEntryCount     = static_cast<uint32_t>(lEntries.size());
+    lHeader.mSectionsOffset = sizeof(INISharedHeader);
+    lHeader.mEntriesOffset  = lHeader.mSectionsOffset + lSections.size() * sizeof(INISharedSection);
+    lHeader.mStringsOffset  = lHeader.mEntriesOffset + lEntries.size() * sizeof(INISharedEntry);
+    lHeader.mSize           = lHeader.mStringsOffset + lStrings.size();
+
+    pImage.clear();
+    pImage.reserve(lHeader.mSize);
+    pImage.append(reinterpret_cast<const char *>(&lHeader), sizeof(lHeader));
+    pImage.append(reinterpret_cast<const char *>(lSections.data()), lSections.size() * sizeof(INISharedSection));
+    pImage.append(reinterpret_cast<const char *>(lEntries.data()), lEntries.size() * sizeof(INISharedEntry));
+    pImage.append(lStrings);
+
+    return 0;
+}
+
+int INISharedConfig::deserialize(const std::string_view &pImage, INI &pINI) {
+    /* The image may come from anywhere, check every reference first */
+    if(0 != check(pImage)) {
+        std::cerr << "[ERROR] <INISharedConfig::deserialize> Invalid image" << std::endl;
+        return -1;
+    }
+
+    INISharedHeader lHeader;
+    std::memcpy(&lHeader, pImage.data(), sizeof(lHeader));
+
+    const char *lStrings = pImage.data() + lHeader.mStringsOffset;
+    auto lString = [lStrings](const INISharedString &pString, std::string &pOut) {
+        pOut.assign(lStrings + pString.mOffset, pString.mSize);
+    };
+
+    std::string lName;
+    std::string lKey;
+    std::string lValue;
+    for(uint32_t i = 0U; i < lHeader.mSectionCount; ++i) {
+        INISharedSection lSection;
+        std::memcpy(&lSection, pImage.data() + lHeader.mSectionsOffset + uint64_t(i) * sizeof(INISharedSection), sizeof(lSection));
+
+        lString(lSection.mName, lName);
+        if(!pINI.sectionExists(lName) && (0 != pINI.addSection(lName))) {
+            return -1;
+        }
+
+        for(uint32_t j = 0U; j < lSection.mEntryCount; ++j) {
+            INISharedEntry lEntry;
+            std::memcpy(&lEntry, pImage.data() + lHeader.mEntriesOffset + (uint64_t(lSection.mFirstEntry) + j) * sizeof(INISharedEntry), sizeof(lEntry));
+
+            lString(lEntry.mKey, lKey);
+            lString(lEntry.mValue, lValue);
+            if(0 != pINI.addString(lKey, lValue, lName)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int INISharedConfig::check(const std::string_view &pImage) {
+    INISharedHeader lHeader;
+    if(sizeof(lHeader) > pImage.size()) {
+        return -1;
+    }
+
+    std::memcpy(&lHeader, pImage.data(), sizeof(lHeader));
+    if((INI_SHARED_MAGIC != lHeader.mMagic)
+        || (INI_SHARED_VERSION != lHeader.mVersion)
+        || (pImage.size() < lHeader.mSize)
+        || (sizeof(lHeader) > lHeader.mSize))
+    {
+        return -1;
+    }
+
+    /* Each table follows the previous one, the counts are
+     * checked by division so that nothing can wrap */
+    const uint64_t lSectionsEnd = lHeader.mSectionsOffset + uint64_t(lHeader.mSectionCount) * sizeof(INISharedSection);
+    const uint64_t lEntriesEnd  = lHeader.mEntriesOffset + uint64_t(lHeader.mEntryCount) * sizeof(INISharedEntry);
+    if(!fits(lHeader.mSectionsOffset, lHeader.mSectionCount, sizeof(INISharedSection), alignof(INISharedSection), sizeof(lHeader), lHeader.mSize)
+        || !fits(lHeader.mEntriesOffset, lHeader.mEntryCount, sizeof(INISharedEntry), alignof(INISharedEntry), lSectionsEnd, lHeader.mSize)
+        || !fits(lHeader.mStringsOffset, 0U, 1U, 1U, lEntriesEnd, lHeader.mSize))
+    {
+        return -1;
+    }
+
+    const uint64_t lStringsSize = lHeader.mSize - lHeader.mStringsOffset;
+    const char    *lStrings     = pImage.data() + lHeader.mStringsOffset;
+
+    /* Strings must hold their terminating '\0' */
+    auto lString = [lStrings, lStringsSize](const INISharedString &pString) {
+        return (uint64_t(pString.mOffset) + pString.mSize < lStringsSize)
+            && ('\0' == lStrings[uint64_t(pString.mOffset) + pString.mSize]);
+    };
+
+    for(uint32_t i = 0U; i < lHeader.mSectionCount; ++i) {
+        INISharedSection lSection;
+        std::memcpy(&lSection, pImage.data() + lHeader.mSectionsOffset + uint64_t(i) * sizeof(INISharedSection), sizeof(lSection));
+
+        if(!lString(lSection.mName)
+            || (uint64_t(lSection.mFirstEntry) + lSection.mEntryCount > lHeader.mEntryCount))
+        {
+            return -1;
+        }
+    }
+
+    for(uint32_t i = 0U; i < lHeader.mEntryCount; ++i) {
+        INISharedEntry lEntry;
+        std::memcpy(&lEntry, pImage.data() + lHeader.mEntriesOffset + uint64_t(i) * sizeof(INISharedEntry), sizeof(lEntry));
+
+        if(!lString(lEntry.mKey) || !lString(lEntry.mValue)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int INISharedConfig::publish(const INI &pINI, const std::string &pName) {
+    std::string lImage;
+    if(0 != serialize(pINI, lImage)) {
+        std::cerr << "[ERROR] <INISharedConfig::publish> Failed to build the image of " << pName << std::endl;
+        return -1;
+    }
+
+    INISharedHeader lHeader;
+    std::memcpy(&lHeader, lImage.data(), sizeof(lHeader));
+
+    /* Get the control segment, creating it on the first publication */
+    void  *lAddr   = nullptr;
+    size_t lMapped = 0U;
+    if(0 > mapSegment(pName, O_RDWR | O_CREAT, sizeof(INISharedControl), lAddr, lMapped)) {
+        std::cerr << "[ERROR] <INISharedConfig::publish> Failed to open control segment " << pName << std::endl;
+        return -1;
+    }
+
+    /* A new segment is zero-filled, which is generation 0 */
+    INISharedControl *lControl = static_cast<INISharedControl *>(lAddr);
+    uint64_t lPrevious = lControl->mGeneration.load(std::memory_order_acquire);
+
+    /* Write the new image next to the current one. A segment
+     * of the next generation may be left over by a publisher
+     * that died, or be in the making by another one : it is
+     * never replaced, the generation after it is tried instead */
+    std::string lName;
+    void  *lSegment       = nullptr;
+    size_t lSegmentMapped = 0U;
+    for(uint32_t i = 1U; (nullptr == lSegment) && (INI_SHARED_ATTACH_RETRIES >= i); ++i) {
+        lHeader.mGeneration = lPrevious + i;
+        lName = imageName(pName, lHeader.mGeneration);
+
+        if((0 > mapSegment(lName, O_RDWR | O_CREAT | O_EXCL, lHeader.mSize, lSegment, lSegmentMapped))
+            && (EEXIST != errno))
+        {
+            break;
+        }
+    }
+
+    if(nullptr == lSegment) {
+        std::cerr << "[ERROR] <INISharedConfig::publish> Failed to create image segment " << lName << std::endl;
+        munmap(lAddr, lMapped);
+        return -1;
+    }
+
+    std::memcpy(lSegment, &lHeader, sizeof(lHeader));
+    std::memcpy(static_cast<char *>(lSegment) + sizeof(lHeader), lImage.data() + sizeof(lHeader), lImage.size() - sizeof(lHeader));
+    munmap(lSegment, lSegmentMapped);
+
+    /* Switch the workers to the new image, unless another
+     * publication got there first */
+    const bool lSwitched = lControl->mGeneration.compare_exchange_strong(lPrevious, lHeader.mGeneration, std::memory_order_acq_rel);
+    munmap(lAddr, lMapped);
+
+    if(!lSwitched) {
+        std::cerr << "[ERROR] <INISharedConfig::publish> Concurrent publication of " << pName << std::endl;
+        shm_unlink(lName.c_str());
+        return -1;
+    }
+
+    if(0U != lPrevious) {
+        shm_unlink(imageName(pName, lPrevious).c_str());
+    }
+
+    return 0;
+}
+
+int INISharedConfig::unlink(const std::string &pName) {
+    void  *lAddr   = nullptr;
+    size_t lMapped = 0U;
+    if(0 > mapSegment(pName, O_RDONLY, 0U, lAddr, lMapped)) {
+        return -1;
+    }
+
+    const uint64_t lGeneration = static_cast<INISharedControl *>(lAddr)->mGeneration.load(std::memory_order_acquire);
+    munmap(lAddr, lMapped);
+
+    if(0U != lGeneration) {
+        shm_unlink(imageName(pName, lGeneration).c_str());
+    }
+
+    return shm_unlink(pName.c_str());
+}
+
+int INISharedConfig::attach(const std::string &pName) {
+    detach();
+
+    void  *lAddr   = nullptr;
+    size_t lMapped = 0U;
+    if(0 > mapSegment(pName, O_RDONLY, 0U, lAddr, lMapped)) {
+        std::cerr << "[ERROR] <INISharedConfig::attach> Failed to open control segment " << pName << std::endl;
+        return -1;
+    }
+
+    mName    = pName;
+    mControl = static_cast<const INISharedControl *>(lAddr);
+
+    if(0 > refresh()) {
+        detach();
+        return -1;
+    }
+
+    return 0;
+}
+
+int INISharedConfig::refresh(void) {
+    if(nullptr == mControl) {
+        return -1;
+    }
+
+    for(uint32_t i = 0U; i < INI_SHARED_ATTACH_RETRIES; ++i) {
+        const uint64_t lGeneration = mControl->mGeneration.load(std::memory_order_acquire);
+        if((nullptr != mHeader) && (mHeader->mGeneration == lGeneration)) {
+            /* Already on the current image */
+            return 0;
+        }
+
+        if(0U == lGeneration) {
+            std::cerr << "[ERROR] <INISharedConfig::refresh> Nothing published under " << mName << std::endl;
+            return -1;
+        }
+
+        /* The image may be unlinked by a newer publication
+         * before we open it, then try the newer one */
+        if(0 == map(lGeneration)) {
+            return 1;
+        }
+
+        if(lGeneration == mControl->mGeneration.load(std::memory_order_acquire)) {
+            /* Still the current image, it is invalid */
+            break;
+        }
+    }
+
+    std::cerr << "[ERROR] <INISharedConfig::refresh> Failed to map the image of " << mName << std::endl;
+    return -1;
+}
+
+void INISharedConfig::detach(void) {
+    unmap();
+
+    if(nullptr != mControl) {
+        munmap(const_cast<INISharedControl *>(mControl), sizeof(INISharedControl));
+        mControl = nullptr;
+    }
+
+    mName.clear();
+}
+
+int INISharedConfig::map(const uint64_t &pGeneration) {
+    void  *lAddr   = nullptr;
+    size_t lMapped = 0U;
+    if(0 > mapSegment(imageName(mName, pGeneration), O_RDONLY, 0U, lAddr, lMapped)) {
+        return -1;
+    }
+
+    const INISharedHeader *lHeader = static_cast<const INISharedHeader *>(lAddr);
+    if(0 != check(std::string_view(static_cast<const char *>(lAddr), lMapped))) {
+        std::cerr << "[ERROR] <INISharedConfig::map> Invalid image " << imageName(mName, pGeneration) << std::endl;
+        munmap(lAddr, lMapped);
+        return -1;
+    }
+
+    unmap();
+
+    const char *lBytes = static_cast<const char *>(lAddr);
+    mHeader   = lHeader;
+    mMapped   = lMapped;
+    mSections = reinterpret_cast<const INISharedSection *>(lBytes + lHeader->mSectionsOffset);
+    mEntries  = reinterpret_cast<const INISharedEntry *>(lBytes + lHeader->mEntriesOffset);
+    mStrings  = lBytes + lHeader->mStringsOffset;
+
+    return 0;
+}
+
+void INISharedConfig::unmap(void) {
+    if(nullptr != mHeader) {
+        munmap(const_cast<INISharedHeader *>(mHeader), mMapped);
+    }
+
+    mHeader   = nullptr;
+    mMapped   = 0U;
+    mSections = nullptr;
+    mEntries  = nullptr;
+    mStrings  = nullptr;
+}
+
+uint64_t INISharedConfig::generation(void) const {
+    return (nullptr == mHeader) ? 0U : mHeader->mGeneration;
+}
+
+size_t INISharedConfig::sectionCount(void) const {
+    return (nullptr == mHeader) ? 0U : mHeader->mSectionCount;
+}
+
+std::string_view INISharedConfig::string(const INISharedString &pString) const {
+    return std::string_view(mStrings + pString.mOffset, pString.mSize);
+}
+
+const INISharedSection *INISharedConfig::findSection(const std::string_view &pSection) const {
+    if(nullptr == mHeader) {
+        return nullptr;
+    }
+
+    const bool lFold = 0U != (mHeader->mFlags & INI_SHARED_FLAG_FOLDED);
+
+    const INISharedSection *lEnd = mSections + mHeader->mSectionCount;
+    const INISharedSection *lIt  = std::lower_bound(mSections, lEnd, pSection,
+        [this, lFold](const INISharedSection &pElmt, const std::string_view &pName) { return 0 > ININame::compare(string(pElmt.mName), pName, lFold); });
+
+    if((lEnd == lIt) || (0 != ININame::compare(string(lIt->mName), pSection, lFold))) {
+        return nullptr;
+    }
+
+    return lIt;
+}
+
+int INISharedConfig::getValue(const std::string_view &pKey,
+    std::string_view &pOut,
+    const std::string_view &pSection) const
+{
+    const INISharedSection *lSection = findSection(pSection);
+    if(nullptr == lSection) {
+        return -1;
+    }
+
+    const bool lFold = 0U != (mHeader->mFlags & INI_SHARED_FLAG_FOLDED);
+
+    const INISharedEntry *lFirst = mEntries + lSection->mFirstEntry;
+    const INISharedEntry *lEnd   = lFirst + lSection->mEntryCount;
+    const INISharedEntry *lIt    = std::lower_bound(lFirst, lEnd, pKey,
+        [this, lFold](const INISharedEntry &pElmt, const std::string_view &pName) { return 0 > ININame::compare(string(pElmt.mKey), pName, lFold); });
+
+    if((lEnd == lIt) || (0 != ININame::compare(string(lIt->mKey), pKey, lFold))) {
+        return -1;
+    }
+
+    pOut = string(lIt->mValue);
+    return 0;
+}
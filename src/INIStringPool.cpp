@@ -0,0 +1,183 @@
+/**
+ * @brief INI string pool class implementation
+ *
+ * @file INIStringPool.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIStringPool.hpp"
+
+/* C++ System */
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
+/* C System */
+#include <cstring>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI string class ------------------------------------ */
+INIString::INIString() : mNode(nullptr) {
+    /* Empty for now */
+}
+
+INIString::INIString(INIStringNode *pNode) : mNode(pNode) {
+    /* The reference was taken by the pool */
+}
+
+INIString::INIString(const INIString &pOther) : mNode(pOther.mNode) {
+    if(nullptr != mNode) {
+        mNode->mPool->ref(mNode);
+    }
+}
+
+INIString::INIString(INIString &&pOther) noexcept : mNode(pOther.mNode) {
+    pOther.mNode = nullptr;
+}
+
+INIString::~INIString() {
+    if(nullptr != mNode) {
+        mNode->mPool->unref(mNode);
+    }
+}
+
+INIString &INIString::operator=(const INIString &pOther) {
+    if(mNode != pOther.mNode) {
+        if(nullptr != pOther.mNode) {
+            pOther.mNode->mPool->ref(pOther.mNode);
+        }
+        if(nullptr != mNode) {
+            mNode->mPool->unref(mNode);
+        }
+        mNode = pOther.mNode;
+    }
+
+    return *this;
+}
+
+INIString &INIString::operator=(INIString &&pOther) noexcept {
+    if(this != &pOther) {
+        if(nullptr != mNode) {
+            mNode->mPool->unref(mNode);
+        }
+        mNode = pOther.mNode;
+        pOther.mNode = nullptr;
+    }
+
+    return *this;
+}
+
+/* INI string pool class ------------------------------- */
+INIStringPool::INIStringPool(const bool &pDeduplicate) :
+    mDeduplicate(pDeduplicate),
+    mCount(0U),
+    mStoredBytes(0U),
+    mReferencedBytes(0U)
+{
+    /* Empty for now */
+}
+
+INIStringPool::~INIStringPool() {
+    /* Nodes are owned by their handles,
+     * which must not outlive the pool */
+}
+
+size_t INIStringPool::nodeBytes(const INIStringNode *pNode) {
+    return sizeof(INIStringNode) + pNode->mSize + 1U;
+}
+
+INIString INIStringPool::acquire(const std::string_view &pStr) {
+    if(mDeduplicate) {
+        /* Is this string already interned ? */
+        auto lIt = mIndex.find(pStr);
+        if(mIndex.end() != lIt) {
+            ref(lIt->second);
+            return INIString(lIt->second);
+        }
+    }
+
+    /* Allocate the node and its characters in one block */
+    void *lMem = ::operator new(sizeof(INIStringNode) + pStr.size() + 1U);
+    INIStringNode *lNode = new(lMem) INIStringNode;
+    lNode->mPool = this;
+    lNode->mRefs = 1U;
+    lNode->mSize = pStr.size();
+
+    char *lData = const_cast<char *>(lNode->data());
+    std::memcpy(lData, pStr.data(), pStr.size());
+    lData[pStr.size()] = '\0';
+
+    if(mDeduplicate) {
+        mIndex.emplace(std::string_view(lNode->data(), lNode->mSize), lNode);
+    }
+
+    ++mCount;
+    mStoredBytes     += nodeBytes(lNode);
+    mReferencedBytes += nodeBytes(lNode);
+
+    return INIString(lNode);
+}
+
+void INIStringPool::ref(INIStringNode *pNode) {
+    pNode->mRefs.fetch_add(1U, std::memory_order_relaxed);
+    mReferencedBytes.fetch_add(nodeBytes(pNode), std::memory_order_relaxed);
+}
+
+void INIStringPool::unref(INIStringNode *pNode) {
+    mReferencedBytes.fetch_sub(nodeBytes(pNode), std::memory_order_relaxed);
+
+    if(1U < pNode->mRefs.fetch_sub(1U, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    /* Last reference dropped, release the node */
+    if(mDeduplicate) {
+        mIndex.erase(std::string_view(pNode->data(), pNode->mSize));
+    }
+
+    --mCount;
+    mStoredBytes -= nodeBytes(pNode);
+
+    pNode->~INIStringNode();
+    ::operator delete(static_cast<void *>(pNode));
+}
+
+bool INIStringPool::deduplicates(void) const {
+    return mDeduplicate;
+}
+
+INIAtom INIStringPool::atom(const std::string_view &pStr) const {
+    if(!mDeduplicate) {
+        /* Without deduplication, a string has no unique identity */
+        return 0U;
+    }
+
+    auto lIt = mIndex.find(pStr);
+    return (mIndex.end() == lIt) ? 0U : reinterpret_cast<INIAtom>(lIt->second);
+}
+
+size_t INIStringPool::count(void) const {
+    return mCount;
+}
+
+size_t INIStringPool::storedBytes(void) const {
+    return mStoredBytes;
+}
+
+size_t INIStringPool::referencedBytes(void) const {
+    return mReferencedBytes;
+}
+
+size_t INIStringPool::savedBytes(void) const {
+    return mReferencedBytes - mStoredBytes;
+}
+
+size_t INIStringPool::memoryUsage(void) const {
+    /* Nodes, plus the deduplication index buckets and nodes */
+    return mStoredBytes
+        + (mIndex.bucket_count() * sizeof(void *))
+        + (mIndex.size() * (2U * sizeof(void *) + sizeof(std::string_view) + sizeof(INIStringNode *)));
+}
@@ -0,0 +1,90 @@
+/**
+ * @brief INI worker thread pool class implementation
+ *
+ * @file INIThreadPool.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIThreadPool.hpp"
+
+/* C++ System */
+#include <iostream>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <utility>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI thread pool class ------------------------------- */
+INIThreadPool::INIThreadPool(const size_t &pWorkers) :
+    mStopping(false)
+{
+    size_t lWorkers = pWorkers;
+    if(0U == lWorkers) {
+        lWorkers = std::thread::hardware_concurrency();
+    }
+    if(0U == lWorkers) {
+        /* Unknown hardware */
+        lWorkers = 1U;
+    }
+
+    mWorkers.reserve(lWorkers);
+    for(size_t i = 0U; i < lWorkers; ++i) {
+        mWorkers.emplace_back(&INIThreadPool::run, this);
+    }
+}
+
+INIThreadPool::~INIThreadPool() {
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+
+    for(auto &lWorker : mWorkers) {
+        lWorker.join();
+    }
+}
+
+void INIThreadPool::submit(std::function<void(void)> pTask) {
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+        mTasks.push_back(std::move(pTask));
+    }
+    mCondition.notify_one();
+}
+
+size_t INIThreadPool::workers(void) const {
+    return mWorkers.size();
+}
+
+void INIThreadPool::run(void) {
+    while(true) {
+        std::function<void(void)> lTask;
+
+        {
+            std::unique_lock<std::mutex> lLock(mMutex);
+            mCondition.wait(lLock, [this]() { return mStopping || !mTasks.empty(); });
+
+            if(mTasks.empty()) {
+                /* Stopping, and nothing left to run */
+                return;
+            }
+
+            lTask = std::move(mTasks.front());
+            mTasks.pop_front();
+        }
+
+        try {
+            lTask();
+        } catch(const std::exception &e) {
+            std::cerr << "[ERROR] <INIThreadPool::run> Task failed : " << e.what() << std::endl;
+        } catch(...) {
+            std::cerr << "[ERROR] <INIThreadPool::run> Task failed" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @brief INI section tree class implementation
+ *
+ * @file INITree.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INITree.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+#include <algorithm>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* INI tree class -------------------------------------- */
+INITree::INITree(const char &pSeparator, const bool &pFold) :
+    mSeparator(pSeparator),
+    mRoot{std::string_view(), std::string_view(), nullptr, nullptr, {}},
+    mNodes(ININameLess(pFold))
+{
+    /* Empty for now */
+}
+
+char INITree::separator(void) const {
+    return mSeparator;
+}
+
+void INITree::setSeparator(const char &pSeparator) {
+    /* The names have to be split again */
+    clear();
+    mSeparator = pSeparator;
+}
+
+INITreeNode *INITree::node(const std::string_view &pPath) {
+    auto lIt = mNodes.find(pPath);
+    if(mNodes.end() != lIt) {
+        return lIt->second.get();
+    }
+
+    /* Link the new node to its parent, creating it if needed */
+    size_t lSep = pPath.rfind(mSeparator);
+    INITreeNode *lParent = (std::string_view::npos == lSep) ? &mRoot : node(pPath.substr(0U, lSep));
+
+    lIt = mNodes.emplace(std::string(pPath), std::unique_ptr<INITreeNode>(new INITreeNode())).first;
+
+    INITreeNode *lNode = lIt->second.get();
+    lNode->mPath    = lIt->first;
+    lNode->mName    = (std::string_view::npos == lSep) ? lNode->mPath : lNode->mPath.substr(lSep + 1U);
+    lNode->mSection = nullptr;
+    lNode->mParent  = lParent;
+    lParent->mChildren.push_back(lNode);
+
+    return lNode;
+}
+
+INITreeNode *INITree::insert(const std::string_view &pPath, INISection *pSection) {
+    INITreeNode *lNode = node(pPath);
+    lNode->mSection = pSection;
+
+    return lNode;
+}
+
+void INITree::erase(const std::string_view &pPath) {
+    auto lIt = mNodes.find(pPath);
+    if(mNodes.end() == lIt) {
+        return;
+    }
+
+    INITreeNode *lNode = lIt->second.get();
+    lNode->mSection = nullptr;
+
+    /* Remove the nodes left without a section nor children */
+    while((&mRoot != lNode) && (nullptr == lNode->mSection) && lNode->mChildren.empty()) {
+        INITreeNode *lParent = lNode->mParent;
+        lParent->mChildren.erase(std::find(lParent->mChildren.begin(), lParent->mChildren.end(), lNode));
+
+        mNodes.erase(mNodes.find(lNode->mPath));
+        lNode = lParent;
+    }
+}
+
+void INITree::clear(void) {
+    mRoot.mChildren.clear();
+    mNodes.clear();
+}
+
+const INITreeNode *INITree::root(void) const {
+    return &mRoot;
+}
+
+const INITreeNode *INITree::find(const std::string_view &pPath) const {
+    auto lIt = mNodes.find(pPath);
+    if(mNodes.end() == lIt) {
+        return nullptr;
+    }
+
+    return lIt->second.get();
+}
+
+size_t INITree::count(void) const {
+    return mNodes.size();
+}
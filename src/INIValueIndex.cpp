@@ -0,0 +1,133 @@
+/**
+ * @brief INI value index class implementation
+ *
+ * @file INIValueIndex.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INIValueIndex.hpp"
+#include "INIFrozen.hpp"
+
+/* C++ System */
+#include <algorithm>
+
+/* C System */
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+
+/* INI value index class ------------------------------- */
+INIValueIndex::INIValueIndex(const uint32_t &pFlags, const bool &pFold) :
+    mFlags(pFlags),
+    mFold(pFold)
+{
+    /* Empty for now */
+}
+
+uint32_t INIValueIndex::flags(void) const {
+    return mFlags;
+}
+
+uint64_t INIValueIndex::pairHash(const std::string_view &pKey, const uint64_t &pHash) const {
+    return INIFrozenIndex::hash(pKey, pHash, mFold);
+}
+
+void INIValueIndex::insert(const INIValueRef &pRef, const uint64_t &pHash) {
+    if(0U != (mFlags & INI_VALUE_INDEX_VALUES)) {
+        mValues[pHash].push_back(pRef);
+    }
+
+    if(0U != (mFlags & INI_VALUE_INDEX_PAIRS)) {
+        mPairs[pairHash(pRef.mKey, pHash)].push_back(pRef);
+    }
+}
+
+void INIValueIndex::erase(std::unordered_map<uint64_t, INIValuePostings> &pMap,
+    const uint64_t &pHash,
+    const INIEntry *pEntry)
+{
+    auto lIt = pMap.find(pHash);
+    if(pMap.end() == lIt) {
+        return;
+    }
+
+    INIValuePostings &lPostings = lIt->second;
+
+    auto lRef = std::find_if(lPostings.begin(), lPostings.end(),
+        [pEntry](const INIValueRef &pRef) { return pEntry == pRef.mEntry; });
+    if(lPostings.end() == lRef) {
+        return;
+    }
+
+    /* The order of the postings does not matter */
+    *lRef = lPostings.back();
+    lPostings.pop_back();
+
+    if(lPostings.empty()) {
+        pMap.erase(lIt);
+    }
+}
+
+void INIValueIndex::erase(const INIValueRef &pRef, const uint64_t &pHash) {
+    if(0U != (mFlags & INI_VALUE_INDEX_VALUES)) {
+        erase(mValues, pHash, pRef.mEntry);
+    }
+
+    if(0U != (mFlags & INI_VALUE_INDEX_PAIRS)) {
+        erase(mPairs, pairHash(pRef.mKey, pHash), pRef.mEntry);
+    }
+}
+
+void INIValueIndex::reserve(const size_t &pEntries) {
+    if(0U != (mFlags & INI_VALUE_INDEX_VALUES)) {
+        mValues.reserve(pEntries);
+    }
+
+    if(0U != (mFlags & INI_VALUE_INDEX_PAIRS)) {
+        mPairs.reserve(pEntries);
+    }
+}
+
+void INIValueIndex::clear(void) {
+    mValues.clear();
+    mPairs.clear();
+}
+
+INIValueQuery INIValueIndex::find(const std::string_view &pValue) const {
+    auto lIt = mValues.find(hash(pValue));
+
+    return INIValueQuery((mValues.end() == lIt) ? nullptr : &lIt->second, pValue, nullptr, mFold);
+}
+
+INIValueQuery INIValueIndex::find(const std::string_view &pKey, const std::string_view &pValue) const {
+    if(0U == (mFlags & INI_VALUE_INDEX_PAIRS)) {
+        /* Entries holding the value, filtered on the key */
+        auto lIt = mValues.find(hash(pValue));
+
+        return INIValueQuery((mValues.end() == lIt) ? nullptr : &lIt->second, pValue, &pKey, mFold);
+    }
+
+    auto lIt = mPairs.find(pairHash(pKey, hash(pValue)));
+
+    return INIValueQuery((mPairs.end() == lIt) ? nullptr : &lIt->second, pValue, &pKey, mFold);
+}
+
+size_t INIValueIndex::memoryUsage(void) const {
+    /* Approximate size of a hash node, excluding its payload */
+    static const size_t sNodeOverhead = 2U * sizeof(void *);
+
+    size_t lBytes = sizeof(INIValueIndex);
+
+    for(const auto *lMap : {&mValues, &mPairs}) {
+        lBytes += lMap->bucket_count() * sizeof(void *);
+        for(const auto &lElmt : *lMap) {
+            lBytes += sNodeOverhead + sizeof(lElmt) + lElmt.second.capacity() * sizeof(INIValueRef);
+        }
+    }
+
+    return lBytes;
+}
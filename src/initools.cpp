@@ -0,0 +1,375 @@
+/**
+ * @brief initools C API implementation
+ *
+ * @file initools.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "initools.h"
+#include "INI.hpp"
+#include "INIConvert.hpp"
+
+/* C++ System */
+#include <string>
+#include <string_view>
+
+/* C System */
+#include <cstddef>
+#include <cstdint>
+
+/* Defines --------------------------------------------- */
+#define INI_C_DEFAULT_SECTION "default"
+
+/* Type definitions ------------------------------------ */
+
+/* Helper functions ------------------------------------ */
+/* The handle is the document itself */
+static INI *toINI(ini_document_t *pDoc) {
+    return reinterpret_cast<INI *>(pDoc);
+}
+
+static const INI *toINI(const ini_document_t *pDoc) {
+    return reinterpret_cast<const INI *>(pDoc);
+}
+
+static ini_document_t *toDoc(INI *pINI) {
+    return reinterpret_cast<ini_document_t *>(pINI);
+}
+
+static const char *sectionOf(const char *pSection) {
+    return (nullptr == pSection) ? INI_C_DEFAULT_SECTION : pSection;
+}
+
+/** @brief Value of a key. A key that exists but whose
+ * references cannot be resolved is invalid, not missing. */
+static int lookup(const INI &pINI, const char *pSection, const char *pKey, std::string_view &pValue) {
+    if(0 <= pINI.getView(pKey, pValue, sectionOf(pSection))) {
+        return INI_STATUS_OK;
+    }
+
+    return pINI.keyExists(pKey, sectionOf(pSection)) ? INI_STATUS_INVALID : INI_STATUS_NOT_FOUND;
+}
+
+/** @brief Looks a value up and converts it, keeping the INIConvert codes */
+template<typename T>
+static int getTyped(const ini_document_t *pDoc, const char *pSection, const char *pKey, T &pValue) {
+    if((nullptr == pDoc) || (nullptr == pKey)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        std::string_view lValue;
+        const int lResult = lookup(*toINI(pDoc), pSection, pKey, lValue);
+        if(INI_STATUS_OK != lResult) {
+            return lResult;
+        }
+
+        return INIConvert::to(lValue, pValue);
+    } catch(...) {
+        /* No exception crosses the C boundary */
+        return INI_STATUS_INVALID;
+    }
+}
+
+/* Documents ------------------------------------------- */
+ini_document_t *ini_new(uint32_t pMode) {
+    try {
+        return toDoc(new INI(pMode));
+    } catch(...) {
+        return nullptr;
+    }
+}
+
+ini_document_t *ini_open(const char *pFile, uint32_t pMode) {
+    if(nullptr == pFile) {
+        return nullptr;
+    }
+
+    INI *lINI = nullptr;
+    try {
+        lINI = new INI(pMode);
+        if(0 != lINI->parseFile(pFile)) {
+            delete lINI;
+            return nullptr;
+        }
+    } catch(...) {
+        delete lINI;
+        return nullptr;
+    }
+
+    return toDoc(lINI);
+}
+
+ini_document_t *ini_parse(const char *pData, size_t pSize, uint32_t pMode) {
+    if((nullptr == pData) && (0U != pSize)) {
+        return nullptr;
+    }
+
+    INI *lINI = nullptr;
+    try {
+        lINI = new INI(pMode);
+        if(0 != lINI->parseBuffer(pData, pSize)) {
+            delete lINI;
+            return nullptr;
+        }
+    } catch(...) {
+        delete lINI;
+        return nullptr;
+    }
+
+    return toDoc(lINI);
+}
+
+void ini_free(ini_document_t *pDoc) {
+    delete toINI(pDoc);
+}
+
+int ini_write(const ini_document_t *pDoc, const char *pFile) {
+    if((nullptr == pDoc) || (nullptr == pFile)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->generateFile(pFile)) ? INI_STATUS_OK : INI_STATUS_INVALID;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+size_t ini_diagnostic_count(const ini_document_t *pDoc) {
+    return (nullptr == pDoc) ? 0U : toINI(pDoc)->diagnostics().size();
+}
+
+uint64_t ini_fingerprint(const ini_document_t *pDoc) {
+    return (nullptr == pDoc) ? 0U : toINI(pDoc)->fingerprint();
+}
+
+int ini_section_fingerprint(const ini_document_t *pDoc, const char *pSection, uint64_t *pFingerprint) {
+    if((nullptr == pDoc) || (nullptr == pFingerprint)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->fingerprint(sectionOf(pSection), *pFingerprint)) ? INI_STATUS_OK : INI_STATUS_NOT_FOUND;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_diagnostic(const ini_document_t *pDoc, size_t pIndex,
+    uint32_t *pLine, uint32_t *pColumn, uint32_t *pKind)
+{
+    if((nullptr == pDoc) || (nullptr == pLine) || (nullptr == pColumn) || (nullptr == pKind)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    const std::vector<INIDiagnostic> &lDiagnostics = toINI(pDoc)->diagnostics();
+    if(lDiagnostics.size() <= pIndex) {
+        return INI_STATUS_NOT_FOUND;
+    }
+
+    *pLine   = lDiagnostics[pIndex].mLine;
+    *pColumn = lDiagnostics[pIndex].mColumn;
+    *pKind   = lDiagnostics[pIndex].mKind;
+
+    return INI_STATUS_OK;
+}
+
+/* Lookups --------------------------------------------- */
+int ini_get(const ini_document_t *pDoc, const char *pSection, const char *pKey,
+    const char **pValue, size_t *pSize)
+{
+    if((nullptr == pDoc) || (nullptr == pKey) || (nullptr == pValue)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        std::string_view lValue;
+        const int lResult = lookup(*toINI(pDoc), pSection, pKey, lValue);
+        if(INI_STATUS_OK != lResult) {
+            return lResult;
+        }
+
+        *pValue = lValue.data();
+        if(nullptr != pSize) {
+            *pSize = lValue.size();
+        }
+
+        return INI_STATUS_OK;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_get_int64(const ini_document_t *pDoc, const char *pSection, const char *pKey, int64_t *pValue) {
+    if(nullptr == pValue) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    return getTyped(pDoc, pSection, pKey, *pValue);
+}
+
+int ini_get_uint64(const ini_document_t *pDoc, const char *pSection, const char *pKey, uint64_t *pValue) {
+    if(nullptr == pValue) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    return getTyped(pDoc, pSection, pKey, *pValue);
+}
+
+int ini_get_double(const ini_document_t *pDoc, const char *pSection, const char *pKey, double *pValue) {
+    if(nullptr == pValue) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    return getTyped(pDoc, pSection, pKey, *pValue);
+}
+
+int ini_get_bool(const ini_document_t *pDoc, const char *pSection, const char *pKey, int *pValue) {
+    if(nullptr == pValue) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    bool lValue = false;
+    int lResult = getTyped(pDoc, pSection, pKey, lValue);
+    if(INI_STATUS_OK == lResult) {
+        *pValue = lValue ? 1 : 0;
+    }
+
+    return lResult;
+}
+
+int ini_has_section(const ini_document_t *pDoc, const char *pSection) {
+    if(nullptr == pDoc) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return toINI(pDoc)->sectionExists(sectionOf(pSection)) ? 1 : 0;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_has_key(const ini_document_t *pDoc, const char *pSection, const char *pKey) {
+    if((nullptr == pDoc) || (nullptr == pKey)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return toINI(pDoc)->keyExists(pKey, sectionOf(pSection)) ? 1 : 0;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+/* Iteration ------------------------------------------- */
+int ini_foreach_section(const ini_document_t *pDoc, ini_section_cb_t pCallback, void *pUser) {
+    if((nullptr == pDoc) || (nullptr == pCallback)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        const INISectionQuery lQuery = toINI(pDoc)->querySections("*");
+        for(const std::string_view &lName : lQuery) {
+            if(0 != pCallback(lName.data(), lName.size(), pUser)) {
+                break;
+            }
+        }
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+
+    return INI_STATUS_OK;
+}
+
+int ini_foreach_entry(const ini_document_t *pDoc, const char *pSection, ini_entry_cb_t pCallback, void *pUser) {
+    if((nullptr == pDoc) || (nullptr == pCallback)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        const INI *lINI = toINI(pDoc);
+        const char *lSection = sectionOf(pSection);
+        if(!lINI->sectionExists(lSection)) {
+            return INI_STATUS_NOT_FOUND;
+        }
+
+        const INIKeyQuery lQuery = lINI->queryKeys("*", lSection);
+        for(const std::string_view &lKey : lQuery) {
+            std::string_view lValue;
+            if(0 > lINI->getView(lKey, lValue, lSection)) {
+                return INI_STATUS_INVALID;
+            }
+
+            if(0 != pCallback(lKey.data(), lKey.size(), lValue.data(), lValue.size(), pUser)) {
+                break;
+            }
+        }
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+
+    return INI_STATUS_OK;
+}
+
+/* Modifiers ------------------------------------------- */
+int ini_set(ini_document_t *pDoc, const char *pSection, const char *pKey, const char *pValue) {
+    if((nullptr == pDoc) || (nullptr == pKey) || (nullptr == pValue)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->setString(pKey, pValue, sectionOf(pSection))) ? INI_STATUS_OK : INI_STATUS_NOT_FOUND;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_add(ini_document_t *pDoc, const char *pSection, const char *pKey, const char *pValue) {
+    if((nullptr == pDoc) || (nullptr == pKey) || (nullptr == pValue)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->addString(pKey, pValue, sectionOf(pSection))) ? INI_STATUS_OK : INI_STATUS_INVALID;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_add_section(ini_document_t *pDoc, const char *pSection) {
+    if((nullptr == pDoc) || (nullptr == pSection)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->addSection(pSection)) ? INI_STATUS_OK : INI_STATUS_INVALID;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_remove_key(ini_document_t *pDoc, const char *pSection, const char *pKey) {
+    if((nullptr == pDoc) || (nullptr == pKey)) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->removeKey(sectionOf(pSection), pKey)) ? INI_STATUS_OK : INI_STATUS_NOT_FOUND;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
+
+int ini_remove_section(ini_document_t *pDoc, const char *pSection) {
+    if(nullptr == pDoc) {
+        return INI_STATUS_ARGUMENT;
+    }
+
+    try {
+        return (0 == toINI(pDoc)->removeSection(sectionOf(pSection))) ? INI_STATUS_OK : INI_STATUS_NOT_FOUND;
+    } catch(...) {
+        return INI_STATUS_INVALID;
+    }
+}
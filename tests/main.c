@@ -10,11 +10,23 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "initools.h"
+
 /* Defines --------------------------------------------- */
 
 /* Notes ----------------------------------------------- */
 
 /* Variable declaration -------------------------------- */
+static const char sDocument[] =
+    "; Test document\n"
+    "name=initools\n"
+    "[server]\n"
+    "port=8080\n"
+    "ratio=0.5\n"
+    "enabled=true\n"
+    "offset=-12\n"
+    "[client]\n"
+    "retries=300\n";
 
 /* Type definitions ------------------------------------ */
 
@@ -23,6 +35,293 @@ static void print_usage(const char * const pProgName)
 {
     printf("[USAGE] %s test#\n", pProgName);
     printf("        Test -1 : default/no test\n");
+    printf("        Test  0 : C API lookups\n");
+    printf("        Test  1 : C API typed getters\n");
+    printf("        Test  2 : C API iteration\n");
+    printf("        Test  3 : C API modifiers\n");
+    printf("        Test  4 : C API tolerant parsing\n");
+    printf("        Test  5 : C API fingerprints\n");
+}
+
+static int count_cb(const char *pName, size_t pSize, void *pUser) {
+    (void)pName;
+    (void)pSize;
+    ++*(int *)pUser;
+    return 0;
+}
+
+static int entry_cb(const char *pKey, size_t pKeySize, const char *pValue, size_t pValueSize, void *pUser) {
+    (void)pKey;
+    (void)pValue;
+    *(size_t *)pUser += pKeySize + pValueSize;
+    return 0;
+}
+
+static int test_lookups(void) {
+    const char *lValue = NULL;
+    size_t lSize = 0U;
+    ini_document_t *lDoc = ini_parse(sDocument, sizeof(sDocument) - 1U, INI_C_MODE_DEFAULT);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if((INI_STATUS_OK != ini_get(lDoc, NULL, "name", &lValue, &lSize))
+        || (8U != lSize)
+        || (0 != strcmp("initools", lValue))
+        || (INI_STATUS_OK != ini_get(lDoc, "server", "port", &lValue, &lSize))
+        || (0 != strcmp("8080", lValue))
+        || (INI_STATUS_NOT_FOUND != ini_get(lDoc, "server", "missing", &lValue, &lSize))
+        || (INI_STATUS_NOT_FOUND != ini_get(lDoc, "missing", "port", &lValue, &lSize))
+        || (1 != ini_has_section(lDoc, "client"))
+        || (0 != ini_has_key(lDoc, "client", "port")))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+
+    /* Keys whose references cannot be resolved exist, but are invalid */
+    static const char sBroken[] = "[s]\nbroken=${missing}\n";
+    int64_t lInt = 0;
+    lDoc = ini_parse(sBroken, sizeof(sBroken) - 1U, INI_C_MODE_INTERPOLATION);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if((1 != ini_has_key(lDoc, "s", "broken"))
+        || (0 != ini_has_key(lDoc, "s", "missing"))
+        || (INI_STATUS_INVALID != ini_get(lDoc, "s", "broken", &lValue, &lSize))
+        || (INI_STATUS_INVALID != ini_get_int64(lDoc, "s", "broken", &lInt))
+        || (INI_STATUS_NOT_FOUND != ini_get_int64(lDoc, "s", "missing", &lInt)))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+    return 0;
+}
+
+static int test_typed(void) {
+    int64_t lInt = 0;
+    uint64_t lUInt = 0U;
+    double lDouble = 0.0;
+    int lBool = 0;
+    ini_document_t *lDoc = ini_parse(sDocument, sizeof(sDocument) - 1U, INI_C_MODE_INTERNING);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if((INI_STATUS_OK != ini_get_uint64(lDoc, "server", "port", &lUInt)) || (8080U != lUInt)
+        || (INI_STATUS_OK != ini_get_int64(lDoc, "server", "offset", &lInt)) || (-12 != lInt)
+        || (INI_STATUS_OK != ini_get_double(lDoc, "server", "ratio", &lDouble)) || (0.5 != lDouble)
+        || (INI_STATUS_OK != ini_get_bool(lDoc, "server", "enabled", &lBool)) || (1 != lBool)
+        || (INI_STATUS_INVALID != ini_get_int64(lDoc, NULL, "name", &lInt))
+        || (INI_STATUS_ARGUMENT != ini_get_int64(lDoc, NULL, "name", NULL)))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+    return 0;
+}
+
+static int test_iteration(void) {
+    int lSections = 0;
+    size_t lBytes = 0U;
+    ini_document_t *lDoc = ini_parse(sDocument, sizeof(sDocument) - 1U, INI_C_MODE_DEFAULT);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if((INI_STATUS_OK != ini_foreach_section(lDoc, count_cb, &lSections))
+        || (3 != lSections)
+        || (INI_STATUS_OK != ini_foreach_entry(lDoc, "client", entry_cb, &lBytes))
+        || (10U != lBytes)
+        || (INI_STATUS_NOT_FOUND != ini_foreach_entry(lDoc, "missing", entry_cb, &lBytes)))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+    return 0;
+}
+
+static int test_modifiers(void) {
+    uint64_t lUInt = 0U;
+    ini_document_t *lDoc = ini_new(INI_C_MODE_DEFAULT);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if((INI_STATUS_OK != ini_add_section(lDoc, "counters"))
+        || (INI_STATUS_OK != ini_add(lDoc, "counters", "hits", "1"))
+        || (INI_STATUS_OK != ini_set(lDoc, "counters", "hits", "2"))
+        || (INI_STATUS_OK != ini_get_uint64(lDoc, "counters", "hits", &lUInt)) || (2U != lUInt)
+        || (INI_STATUS_NOT_FOUND != ini_set(lDoc, "counters", "misses", "0"))
+        || (INI_STATUS_OK != ini_remove_key(lDoc, "counters", "hits"))
+        || (0 != ini_has_key(lDoc, "counters", "hits"))
+        || (INI_STATUS_NOT_FOUND != ini_remove_key(lDoc, "counters", "hits"))
+        || (INI_STATUS_NOT_FOUND != ini_remove_key(lDoc, "missing", "hits"))
+        || (INI_STATUS_ARGUMENT != ini_remove_key(lDoc, "counters", NULL))
+        || (INI_STATUS_OK != ini_remove_section(lDoc, "counters"))
+        || (0 != ini_has_section(lDoc, "counters"))
+        || (INI_STATUS_NOT_FOUND != ini_remove_section(lDoc, "counters"))
+        || (INI_STATUS_ARGUMENT != ini_remove_section(NULL, "counters")))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+    return 0;
+}
+
+static int test_tolerant(void) {
+    static const char sBroken[] =
+        "[server\n"
+        "port=8080\n"
+        "[client]\n"
+        "=orphan\n"
+        "  no equal sign\n"
+        "retries=3\n"
+        "retries=4\n"
+        "[client]\n"
+        "timeout=5\n";
+
+    /* Expected line, column and kind of each diagnostic */
+    static const uint32_t sExpected[][3U] = {
+        {1U, 1U, 1U},   /* Unclosed section */
+        {4U, 1U, 2U},   /* Empty key */
+        {5U, 3U, 3U},   /* No equal sign */
+        {7U, 0U, 9U},   /* Duplicate key */
+        {8U, 0U, 8U},   /* Duplicate section */
+    };
+
+    uint32_t lLine, lColumn, lKind;
+    size_t   i;
+
+    ini_document_t *lDoc = ini_parse(sBroken, sizeof(sBroken) - 1U, INI_C_MODE_TOLERANT);
+    if(NULL == lDoc) {
+        return -1;
+    }
+
+    if(5U != ini_diagnostic_count(lDoc)) {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    for(i = 0U; i < 5U; ++i) {
+        if((INI_STATUS_OK != ini_diagnostic(lDoc, i, &lLine, &lColumn, &lKind))
+            || (sExpected[i][0U] != lLine)
+            || (sExpected[i][1U] != lColumn)
+            || (sExpected[i][2U] != lKind))
+        {
+            ini_free(lDoc);
+            return -1;
+        }
+    }
+
+    /* The usable parts are kept, the first value wins */
+    uint64_t lUInt = 0U;
+    if((INI_STATUS_OK != ini_get_uint64(lDoc, NULL, "port", &lUInt)) || (8080U != lUInt)
+        || (INI_STATUS_OK != ini_get_uint64(lDoc, "client", "retries", &lUInt)) || (3U != lUInt)
+        || (INI_STATUS_OK != ini_get_uint64(lDoc, "client", "timeout", &lUInt)) || (5U != lUInt)
+        || (INI_STATUS_NOT_FOUND != ini_diagnostic(lDoc, 5U, &lLine, &lColumn, &lKind)))
+    {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    ini_free(lDoc);
+
+    /* Strict parsing still stops at the first error */
+    lDoc = ini_parse(sBroken, sizeof(sBroken) - 1U, INI_C_MODE_DEFAULT);
+    if(NULL != lDoc) {
+        ini_free(lDoc);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_fingerprints(void) {
+    static const char sFirst[] =
+        "[server]\n"
+        "host=localhost\n"
+        "port=8080\n"
+        "[client]\n"
+        "retries=3\n";
+
+    /* Same contents, other order */
+    static const char sSecond[] =
+        "[client]\n"
+        "retries=3\n"
+        "[server]\n"
+        "port=8080\n"
+        "host=localhost\n";
+
+    uint64_t lBefore = 0U;
+    uint64_t lAfter  = 0U;
+    uint64_t lOther  = 0U;
+    int      lResult = -1;
+
+    ini_document_t *lFirst  = ini_parse(sFirst, sizeof(sFirst) - 1U, INI_C_MODE_DEFAULT);
+    ini_document_t *lSecond = ini_parse(sSecond, sizeof(sSecond) - 1U, INI_C_MODE_DEFAULT);
+    if((NULL == lFirst) || (NULL == lSecond)) {
+        ini_free(lFirst);
+        ini_free(lSecond);
+        return -1;
+    }
+
+    do {
+        if((ini_fingerprint(lFirst) != ini_fingerprint(lSecond))
+            || (INI_STATUS_OK != ini_section_fingerprint(lFirst, "server", &lBefore))
+            || (INI_STATUS_OK != ini_section_fingerprint(lSecond, "server", &lOther)) || (lBefore != lOther)
+            || (INI_STATUS_NOT_FOUND != ini_section_fingerprint(lFirst, "nothing", &lOther)))
+        {
+            break;
+        }
+
+        /* A change shows in the section and in the document, undoing it restores both */
+        if((INI_STATUS_OK != ini_set(lFirst, "server", "port", "8081"))
+            || (INI_STATUS_OK != ini_section_fingerprint(lFirst, "server", &lAfter)) || (lBefore == lAfter)
+            || (ini_fingerprint(lFirst) == ini_fingerprint(lSecond))
+            || (INI_STATUS_OK != ini_set(lFirst, "server", "port", "8080"))
+            || (ini_fingerprint(lFirst) != ini_fingerprint(lSecond)))
+        {
+            break;
+        }
+
+        /* Moving a key to another section is a change */
+        if((INI_STATUS_OK != ini_remove_key(lFirst, "client", "retries"))
+            || (INI_STATUS_OK != ini_add(lFirst, "server", "retries", "3"))
+            || (ini_fingerprint(lFirst) == ini_fingerprint(lSecond))
+            || (INI_STATUS_OK != ini_remove_key(lFirst, "server", "retries"))
+            || (INI_STATUS_OK != ini_add(lFirst, "client", "retries", "3"))
+            || (ini_fingerprint(lFirst) != ini_fingerprint(lSecond)))
+        {
+            break;
+        }
+
+        /* So are the empty sections */
+        if((INI_STATUS_OK != ini_add_section(lFirst, "empty"))
+            || (ini_fingerprint(lFirst) == ini_fingerprint(lSecond))
+            || (INI_STATUS_OK != ini_remove_section(lFirst, "empty"))
+            || (ini_fingerprint(lFirst) != ini_fingerprint(lSecond)))
+        {
+            break;
+        }
+
+        lResult = 0;
+    } while(0);
+
+    ini_free(lFirst);
+    ini_free(lSecond);
+    return lResult;
 }
 
 /* ----------------------------------------------------- */
@@ -44,6 +343,24 @@ int main(const int argc, const char * const * const argv) {
 
     /* Executing test */
     switch (lTestNum) {
+        case 0:
+            lResult = test_lookups();
+            break;
+        case 1:
+            lResult = test_typed();
+            break;
+        case 2:
+            lResult = test_iteration();
+            break;
+        case 3:
+            lResult = test_modifiers();
+            break;
+        case 4:
+            lResult = test_tolerant();
+            break;
+        case 5:
+            lResult = test_fingerprints();
+            break;
         default:
             (void)lResult;
             printf("[INFO ] test #%d not available\n", lTestNum);
@@ -51,5 +368,10 @@ int main(const int argc, const char * const * const argv) {
             break;
     }
 
+    if(0 != lResult) {
+        printf("[ERROR] test #%d failed\n", lTestNum);
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,1925 @@
+/**
+ * @brief initools C++ API test file
+ *
+ * @file main.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+#include "INIBinding.hpp"
+#include "INIRuntimeSchema.hpp"
+#include "INILoader.hpp"
+#include "INIShared.hpp"
+#include "INIJournal.hpp"
+#include "INIDiff.hpp"
+#include "INIParser.hpp"
+#include "INIRegistry.hpp"
+
+/* C++ system */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <future>
+#include <stdexcept>
+#include <mutex>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+/* C system */
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#ifdef INI_HAVE_ZLIB
+#include <zlib.h>
+#endif /* INI_HAVE_ZLIB */
+
+/* Defines --------------------------------------------- */
+/** @brief Fails the current test, with the line and the condition */
+#define TEST_CHECK(pCondition) \
+    do { \
+        if(!(pCondition)) { \
+            std::cerr << "[ERROR] <" << __func__ << "> Line " << __LINE__ << " : " << #pCondition << std::endl; \
+            return -1; \
+        } \
+    } while(0)
+
+/* Notes ----------------------------------------------- */
+
+/* Variable declaration -------------------------------- */
+
+/* Type definitions ------------------------------------ */
+struct BoundConfig {
+    uint16_t    mPort;
+    bool        mEnabled;
+    std::string mHost;
+};
+
+/** @brief Records what the parser reports, one line per element */
+class RecordingHandler : public INIParserHandler {
+    public:
+        virtual int onSection(const std::string_view &pSection, const uint32_t &pLine) {
+            mEvents.push_back(std::to_string(pLine) + " [" + std::string(pSection) + "]");
+            return 0;
+        }
+
+        virtual int onEntry(const std::string_view &pSection,
+            const std::string_view &pKey,
+            const std::string_view &pValue,
+            const uint32_t &pLine)
+        {
+            (void)pSection;
+
+            mEvents.push_back(std::to_string(pLine) + " " + std::string(pKey) + "=" + std::string(pValue));
+            return 0;
+        }
+
+        virtual int onError(const INIParseError &pError, const uint32_t &pLine, const uint32_t &pColumn) {
+            mEvents.push_back(std::to_string(pLine) + ":" + std::to_string(pColumn) + " " + INIParser::errorName(pError));
+            return 0;
+        }
+
+        std::vector<std::string> mEvents;
+};
+
+/* Support functions ----------------------------------- */
+static void print_usage(const char * const pProgName)
+{
+    printf("[USAGE] %s test#\n", pProgName);
+    printf("        Test -1 : default/no test\n");
+    printf("        Test  0 : Interned strings\n");
+    printf("        Test  1 : Compile-time schema binding\n");
+    printf("        Test  2 : Runtime schema validation\n");
+    printf("        Test  3 : Value interpolation\n");
+    printf("        Test  4 : Typed list views\n");
+    printf("        Test  5 : Prefix and glob queries\n");
+    printf("        Test  6 : Hierarchical section tree\n");
+    printf("        Test  7 : Asynchronous loading\n");
+    printf("        Test  8 : Shared memory images\n");
+    printf("        Test  9 : Write-ahead journal\n");
+    printf("        Test 10 : Diff and three-way merge\n");
+    printf("        Test 11 : Columnar extraction\n");
+    printf("        Test 12 : Case-insensitive diff and merge\n");
+    printf("        Test 13 : Compressed files\n");
+    printf("        Test 14 : Multi-line values\n");
+    printf("        Test 15 : Inlined lookups\n");
+    printf("        Test 16 : JSON export\n");
+    printf("        Test 17 : Registry\n");
+    printf("        Test 18 : Command line tool\n");
+    printf("        Test 19 : Frozen documents\n");
+    printf("        Test 20 : Value index\n");
+    printf("        Test 21 : Parallel generation\n");
+}
+
+static int parse(INI &pINI, const std::string &pText) {
+    return pINI.parseBuffer(pText.data(), pText.size());
+}
+
+/** @brief Writes a scratch file in the working directory, named after the test */
+static std::string writeFile(const std::string &pName, const std::string &pText) {
+    const std::string lPath = "initools_test_" + std::to_string(getpid()) + "_" + pName;
+
+    std::ofstream lStream(lPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    lStream << pText;
+
+    return lPath;
+}
+
+#ifdef INI_HAVE_ZLIB
+/** @brief Compresses pText as one gzip member */
+static std::string gzip(const std::string &pText) {
+    z_stream lStream;
+    std::memset(&lStream, 0, sizeof(lStream));
+    if(Z_OK != deflateInit2(&lStream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY)) {
+        return std::string();
+    }
+
+    std::string lOut(deflateBound(&lStream, pText.size()), '\0');
+    lStream.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(pText.data()));
+    lStream.avail_in  = static_cast<uInt>(pText.size());
+    lStream.next_out  = reinterpret_cast<Bytef *>(&lOut[0U]);
+    lStream.avail_out = static_cast<uInt>(lOut.size());
+
+    const int lResult = deflate(&lStream, Z_FINISH);
+    lOut.resize(lStream.total_out);
+    deflateEnd(&lStream);
+
+    return (Z_STREAM_END == lResult) ? lOut : std::string();
+}
+#endif /* INI_HAVE_ZLIB */
+
+#ifdef INI_TOOL_PATH
+/** @brief Reads back a whole file, empty if missing */
+static std::string readBack(const std::string &pPath) {
+    std::ifstream lStream(pPath, std::ios::in | std::ios::binary);
+    std::ostringstream lText;
+    lText << lStream.rdbuf();
+
+    return lText.str();
+}
+
+/** @brief Runs the command line tool, its output going to pOutput */
+static int runTool(const std::string &pArgs, std::string &pOutput) {
+    const std::string lLog = writeFile("tool.log", "");
+    const int lResult = std::system((std::string(INI_TOOL_PATH) + " " + pArgs + " > " + lLog + " 2>&1").c_str());
+
+    pOutput = readBack(lLog);
+    std::remove(lLog.c_str());
+
+    return lResult;
+}
+#endif /* INI_TOOL_PATH */
+
+/* Tests ----------------------------------------------- */
+static int test_interning(void) {
+    INI lINI(INI_MODE_INTERNING);
+    TEST_CHECK(0 == parse(lINI, "[a]\nk=shared value\n[b]\nk=shared value\n"));
+    TEST_CHECK(0 < lINI.internedBytesSaved());
+    TEST_CHECK(lINI.atom("shared value") == lINI.atom("shared value"));
+    TEST_CHECK(0U != lINI.atom("shared value"));
+
+    /* Copies of the document strings, taken and dropped from several threads */
+    const size_t lSaved = lINI.internedBytesSaved();
+    INISectionQuery lSections = lINI.querySections("*");
+
+    std::vector<std::thread> lThreads;
+    for(size_t i = 0U; i < 4U; ++i) {
+        lThreads.emplace_back([&lSections](void) {
+            for(size_t j = 0U; j < 10000U; ++j) {
+                for(auto lIt = lSections.begin(); lIt != lSections.end(); ++lIt) {
+                    const INIString lName = lIt.value().mName;
+                    const INIString lValue = lIt.value().mEntries.begin()->second.mValue;
+                    (void)lName;
+                    (void)lValue;
+                }
+            }
+        });
+    }
+
+    for(auto &lThread : lThreads) {
+        lThread.join();
+    }
+
+    TEST_CHECK(lSaved == lINI.internedBytesSaved());
+
+    std::string lValue;
+    TEST_CHECK(0 == lINI.getValue("k", lValue, "a"));
+    TEST_CHECK("shared value" == lValue);
+
+    return 0;
+}
+
+static int test_binding(void) {
+    static constexpr auto sSchema = iniSchema(
+        iniField("server", "port",    &BoundConfig::mPort).defaults(8080U).range(1U, 1024U),
+        iniField("server", "enabled", &BoundConfig::mEnabled).defaults(true),
+        iniField("server", "host",    &BoundConfig::mHost).required()
+    );
+
+    BoundConfig               lConfig;
+    std::vector<INIBindIssue> lIssues;
+
+    /* From a document */
+    INI lINI;
+    TEST_CHECK(0 == parse(lINI, "[server]\nport=443\nhost=example.org\n"));
+    TEST_CHECK(0 == iniBind(lINI, sSchema, lConfig, lIssues));
+    TEST_CHECK(lIssues.empty());
+    TEST_CHECK((443U == lConfig.mPort) && lConfig.mEnabled && ("example.org" == lConfig.mHost));
+
+    /* Documents bind in their mode, names without case and values interpolated */
+    INI lModal(INI_MODE_INTERPOLATION | INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lModal, "[Server]\nPORT=${base}\nbase=22\nHost=${port}.example.org\n"));
+    TEST_CHECK(0 != iniBind(lModal, sSchema, lConfig, lIssues));
+    TEST_CHECK(1U == lIssues.size());
+    TEST_CHECK((INI_BIND_ERROR_UNKNOWN_KEY == lIssues[0U].mError) && ("base" == lIssues[0U].mKey));
+    TEST_CHECK((22U == lConfig.mPort) && ("22.example.org" == lConfig.mHost));
+
+    TEST_CHECK(0 == parse(lModal, "[server]\nport=${missing}\nhost=localhost\n"));
+    TEST_CHECK(0 != iniBind(lModal, sSchema, lConfig, lIssues));
+    TEST_CHECK(1U == lIssues.size());
+    TEST_CHECK((INI_BIND_ERROR_INVALID_VALUE == lIssues[0U].mError) && ("port" == lIssues[0U].mKey));
+
+    /* Every problem is reported */
+    std::istringstream lBad("[server]\nport=8443\ncolor=blue\n");
+    TEST_CHECK(0 != iniBind(lBad, sSchema, lConfig, lIssues));
+    TEST_CHECK(3U == lIssues.size());
+    TEST_CHECK((INI_BIND_ERROR_OUT_OF_RANGE == lIssues[0U].mError) && (2U == lIssues[0U].mLine));
+    TEST_CHECK((INI_BIND_ERROR_UNKNOWN_KEY == lIssues[1U].mError) && ("color" == lIssues[1U].mKey));
+    TEST_CHECK((INI_BIND_ERROR_MISSING_KEY == lIssues[2U].mError) && ("host" == lIssues[2U].mKey));
+
+    /* Syntax errors stop the binding, and say where */
+    std::istringstream lBroken("[server]\nport=80\n[client\n");
+    TEST_CHECK(0 != iniBind(lBroken, sSchema, lConfig, lIssues));
+    TEST_CHECK(1U == lIssues.size());
+    TEST_CHECK(INI_BIND_ERROR_SYNTAX == lIssues[0U].mError);
+    TEST_CHECK(INI_PARSE_ERROR_UNCLOSED_SECTION == lIssues[0U].mSyntax);
+    TEST_CHECK((3U == lIssues[0U].mLine) && (1U == lIssues[0U].mColumn));
+
+    return 0;
+}
+
+static int test_runtime_schema(void) {
+    INIRuntimeSchema lSchema;
+    TEST_CHECK(0 == lSchema.addSection("server", true));
+    TEST_CHECK(0 == lSchema.addKey("server", "port", INI_TYPE_UINT64, true));
+    TEST_CHECK(0 == lSchema.setUIntRange("server", "port", 1U, 1024U));
+    TEST_CHECK(0 == lSchema.addKey("server", "name", INI_TYPE_STRING));
+    TEST_CHECK(0 == lSchema.setPattern("server", "name", "srv-*"));
+    TEST_CHECK(0 == lSchema.addSection("backend.*"));
+    TEST_CHECK(0 == lSchema.addKey("backend.*", "weight", INI_TYPE_DOUBLE, true));
+
+    std::vector<INIViolation> lViolations;
+
+    /* Valid file, the typed values are kept */
+    const std::string lGood = writeFile("schema_good.ini",
+        "[server]\nport=443\nname=srv-1\n[backend.a]\nweight=0.5\n");
+    INI lINI;
+    TEST_CHECK(0 == lINI.parseFile(lGood, lSchema, lViolations));
+    TEST_CHECK(lViolations.empty());
+
+    uint16_t lPort = 0U;
+    TEST_CHECK((0 == lINI.get("port", lPort, "server")) && (443U == lPort));
+
+    /* Every violation is reported, with its line */
+    const std::string lBad = writeFile("schema_bad.ini",
+        "[server]\nport=8080\nname=db-1\ncolor=red\n[backend.b]\nweight=heavy\n[other]\n");
+    INI lOther;
+    TEST_CHECK(0 != lOther.parseFile(lBad, lSchema, lViolations));
+
+    std::vector<INIViolationKind> lKinds;
+    for(const auto &lViolation : lViolations) {
+        lKinds.push_back(lViolation.mKind);
+    }
+
+    TEST_CHECK((std::vector<INIViolationKind>{
+        INI_VIOLATION_OUT_OF_RANGE,
+        INI_VIOLATION_PATTERN_MISMATCH,
+        INI_VIOLATION_UNKNOWN_KEY,
+        INI_VIOLATION_INVALID_TYPE,
+        INI_VIOLATION_UNKNOWN_SECTION,
+    } == lKinds));
+    TEST_CHECK((2U == lViolations[0U].mLine) && ("port" == lViolations[0U].mKey));
+    TEST_CHECK((6U == lViolations[3U].mLine) && ("backend.b" == lViolations[3U].mSection));
+
+    /* Missing required sections and keys */
+    const std::string lMissing = writeFile("schema_missing.ini", "[backend.c]\n");
+    INI lEmpty;
+    TEST_CHECK(0 != lEmpty.parseFile(lMissing, lSchema, lViolations));
+    TEST_CHECK(2U == lViolations.size());
+    TEST_CHECK(INI_VIOLATION_MISSING_SECTION == lViolations[0U].mKind);
+    TEST_CHECK((INI_VIOLATION_MISSING_KEY == lViolations[1U].mKind) && ("weight" == lViolations[1U].mKey));
+
+    std::remove(lGood.c_str());
+    std::remove(lBad.c_str());
+    std::remove(lMissing.c_str());
+
+    return 0;
+}
+
+static int test_interpolation(void) {
+    INI lINI(INI_MODE_INTERPOLATION);
+    TEST_CHECK(0 == parse(lINI,
+        "[paths]\n"
+        "root=/srv\n"
+        "data=${root}/data\n"
+        "price=$${not a reference}\n"
+        "[app]\n"
+        "cache=${paths:data}/cache\n"
+        "home=${env:INITOOLS_TEST_HOME}/app\n"
+        "loop=${loop2}\n"
+        "loop2=${loop}\n"
+        "later=${paths:missing}\n"));
+
+    std::string lValue;
+    TEST_CHECK((0 == lINI.getValue("cache", lValue, "app")) && ("/srv/data/cache" == lValue));
+    TEST_CHECK((0 == lINI.getValue("price", lValue, "paths")) && ("${not a reference}" == lValue));
+    TEST_CHECK(0 != lINI.getValue("loop", lValue, "app"));
+
+    /* Failures are not kept : defining the variable or the key later is picked up */
+    unsetenv("INITOOLS_TEST_HOME");
+    TEST_CHECK(0 != lINI.getValue("home", lValue, "app"));
+    setenv("INITOOLS_TEST_HOME", "/home/test", 1);
+    TEST_CHECK((0 == lINI.getValue("home", lValue, "app")) && ("/home/test/app" == lValue));
+    unsetenv("INITOOLS_TEST_HOME");
+
+    TEST_CHECK(0 != lINI.getValue("later", lValue, "app"));
+    TEST_CHECK(0 == lINI.addString("missing", "found", "paths"));
+    TEST_CHECK((0 == lINI.getValue("later", lValue, "app")) && ("found" == lValue));
+
+    /* Changing a key drops the values resolved through it */
+    TEST_CHECK(0 == lINI.setString("root", "/opt", "paths"));
+    TEST_CHECK((0 == lINI.getValue("cache", lValue, "app")) && ("/opt/data/cache" == lValue));
+
+    /* Concurrent readers share the resolved values */
+    TEST_CHECK(0 == lINI.setString("root", "/var", "paths"));
+
+    std::vector<std::thread> lThreads;
+    std::vector<int>         lFailures(4U, 0);
+    for(size_t i = 0U; i < lFailures.size(); ++i) {
+        lThreads.emplace_back([&lINI, &lFailures, i](void) {
+            for(size_t j = 0U; j < 1000U; ++j) {
+                std::string_view lView;
+                if((0 != lINI.getView("cache", lView, "app")) || ("/var/data/cache" != lView)) {
+                    ++lFailures[i];
+                }
+            }
+        });
+    }
+
+    for(auto &lThread : lThreads) {
+        lThread.join();
+    }
+
+    for(const int &lFailure : lFailures) {
+        TEST_CHECK(0 == lFailure);
+    }
+
+    TEST_CHECK(0 != lINI.resolveAll());
+
+    return 0;
+}
+
+static int test_lists(void) {
+    INI lINI;
+    TEST_CHECK(0 == parse(lINI,
+        "[lists]\n"
+        "sizes= 1, 2 ,3\n"
+        "mixed=4;5,6;7\n"));
+
+    /* Each type and each delimiter keeps its own conversion */
+    INIArrayView<int64_t> lInts;
+    TEST_CHECK(0 == lINI.getArray("sizes", lInts, "lists"));
+    TEST_CHECK((3U == lInts.size()) && (1 == lInts[0]) && (3 == lInts[2]));
+
+    INIArrayView<double> lDoubles;
+    TEST_CHECK(0 == lINI.getArray("sizes", lDoubles, "lists"));
+    TEST_CHECK((3U == lDoubles.size()) && (2.0 == lDoubles[1]));
+
+    INIArrayView<std::string_view> lCommas;
+    INIArrayView<std::string_view> lSemicolons;
+    TEST_CHECK(0 == lINI.getList("mixed", lCommas, "lists"));
+    TEST_CHECK(0 == lINI.getList("mixed", lSemicolons, "lists", ';'));
+    TEST_CHECK((2U == lCommas.size()) && ("4;5" == lCommas[0]));
+    TEST_CHECK((3U == lSemicolons.size()) && ("5,6" == lSemicolons[1]));
+
+    /* The views handed out earlier are still valid */
+    TEST_CHECK((1 == lInts[0]) && (2 == lInts[1]) && (3 == lInts[2]));
+    TEST_CHECK((2U == lCommas.size()) && ("6;7" == lCommas[1]));
+
+    INIArrayView<int64_t> lAgain;
+    TEST_CHECK(0 == lINI.getArray("sizes", lAgain, "lists"));
+    TEST_CHECK(lInts.data() == lAgain.data());
+
+    /* Failed conversions are reported on every read */
+    INIArrayView<int64_t> lBad;
+    TEST_CHECK(0 != lINI.getArray("mixed", lBad, "lists"));
+    TEST_CHECK(0 != lINI.getArray("mixed", lBad, "lists"));
+
+    /* Modifying the entry splits the new value */
+    TEST_CHECK(0 == lINI.setString("sizes", "8,9", "lists"));
+    TEST_CHECK(0 == lINI.getArray("sizes", lInts, "lists"));
+    TEST_CHECK((2U == lInts.size()) && (9 == lInts[1]));
+
+    /* Concurrent readers share the conversions */
+    std::vector<std::thread> lThreads;
+    std::vector<int>         lFailures(4U, 0);
+    for(size_t i = 0U; i < lFailures.size(); ++i) {
+        lThreads.emplace_back([&lINI, &lFailures, i](void) {
+            for(size_t j = 0U; j < 1000U; ++j) {
+                INIArrayView<uint32_t>         lValues;
+                INIArrayView<float>            lFloats;
+                INIArrayView<std::string_view> lItems;
+                if((0 != lINI.getArray("sizes", lValues, "lists"))
+                    || (0 != lINI.getArray("sizes", lFloats, "lists"))
+                    || (0 != lINI.getList("mixed", lItems, "lists", (0U == (j % 2U)) ? ',' : ';'))
+                    || (8U != lValues[0]) || (9.0F != lFloats[1]))
+                {
+                    ++lFailures[i];
+                }
+            }
+        });
+    }
+
+    for(auto &lThread : lThreads) {
+        lThread.join();
+    }
+
+    for(const int &lFailure : lFailures) {
+        TEST_CHECK(0 == lFailure);
+    }
+
+    return 0;
+}
+
+/** @brief Collects the names of a query, in the order they come */
+template<typename Query>
+static std::vector<std::string> names(const Query &pQuery) {
+    std::vector<std::string> lNames;
+    for(auto lIt = pQuery.begin(); pQuery.end() != lIt; ++lIt) {
+        lNames.emplace_back(*lIt);
+    }
+
+    return lNames;
+}
+
+static int test_queries(void) {
+    INI lINI;
+    TEST_CHECK(0 == parse(lINI,
+        "[backend.eu-west.42]\n"
+        "tls_cert=a.pem\n"
+        "tls_key=a.key\n"
+        "port=443\n"
+        "[backend.eu-west.7]\n"
+        "[backend.eu-westish]\n"
+        "[backend.us-east.1]\n"
+        "[frontend]\n"));
+
+    typedef std::vector<std::string> Names;
+
+    /* Prefixes, in name order */
+    TEST_CHECK((Names {"backend.eu-west.42", "backend.eu-west.7"} == names(lINI.querySections("backend.eu-west.*"))));
+    TEST_CHECK(4U == lINI.querySections("backend.*").count());
+    TEST_CHECK((Names {"tls_cert", "tls_key"} == names(lINI.queryKeys("tls_*", "backend.eu-west.42"))));
+
+    /* Globs, plain names and misses */
+    TEST_CHECK((Names {"backend.eu-west.7", "backend.us-east.1"} == names(lINI.querySections("backend.*.?"))));
+    TEST_CHECK((Names {"backend.eu-west.42"} == names(lINI.querySections("*[0-9][0-9]"))));
+    TEST_CHECK((Names {"tls_key"} == names(lINI.queryKeys("tls_[!c]*", "backend.eu-west.42"))));
+    TEST_CHECK((Names {"frontend"} == names(lINI.querySections("frontend"))));
+    TEST_CHECK(lINI.querySections("front").empty());
+    TEST_CHECK(lINI.querySections("zzz*").empty());
+    TEST_CHECK(lINI.queryKeys("*", "missing").empty());
+
+    /* The index follows the modifications */
+    TEST_CHECK(0 == lINI.addSection("backend.eu-west.8"));
+    TEST_CHECK(0 == lINI.removeSection("backend.eu-west.42"));
+    TEST_CHECK((Names {"backend.eu-west.7", "backend.eu-west.8"} == names(lINI.querySections("backend.eu-west.*"))));
+
+    TEST_CHECK(0 == lINI.addString("tls_ca", "ca.pem", "frontend"));
+    TEST_CHECK(0 == lINI.addString("tls_cert", "b.pem", "frontend"));
+    TEST_CHECK(0 == lINI.removeKey("frontend", "tls_cert"));
+    TEST_CHECK((Names {"tls_ca"} == names(lINI.queryKeys("tls_*", "frontend"))));
+
+    /* Case-insensitive documents match on the folded names */
+    INI lFolded(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lFolded,
+        "[Backend.EU]\n"
+        "TLS_Cert=a.pem\n"
+        "[backend.us]\n"));
+    TEST_CHECK(2U == lFolded.querySections("BACKEND.*").count());
+    TEST_CHECK(1U == lFolded.queryKeys("tls_*", "backend.eu").count());
+
+    return 0;
+}
+
+static int test_tree(void) {
+    INI lINI(INI_MODE_HIERARCHY);
+    TEST_CHECK(0 == parse(lINI,
+        "[app]\n"
+        "level=info\n"
+        "port=80\n"
+        "[app.db.primary]\n"
+        "port=5432\n"
+        "[app.web]\n"
+        "[other/x]\n"));
+
+    /* Intermediate names get section-less nodes */
+    const INITreeNode *lNode = lINI.getNode("app.db");
+    TEST_CHECK((nullptr != lNode) && (nullptr == lNode->mSection) && ("db" == lNode->mName));
+    TEST_CHECK((1U == lNode->mChildren.size()) && ("app.db.primary" == lNode->mChildren[0U]->mPath));
+
+    /* Children come in file order, with their parent linked */
+    lNode = lINI.getNode("app");
+    TEST_CHECK((nullptr != lNode) && (nullptr != lNode->mSection) && (2U == lNode->mChildren.size()));
+    TEST_CHECK(("db" == lNode->mChildren[0U]->mName) && ("web" == lNode->mChildren[1U]->mName));
+    TEST_CHECK(lNode == lNode->mChildren[1U]->mParent);
+
+    /* Missing keys are inherited from the nearest ancestor */
+    std::string lValue;
+    TEST_CHECK((0 == lINI.getInheritedValue("port", lValue, "app.db.primary")) && ("5432" == lValue));
+    TEST_CHECK((0 == lINI.getInheritedValue("level", lValue, "app.db.primary")) && ("info" == lValue));
+    TEST_CHECK((0 == lINI.getInheritedValue("port", lValue, "app.web")) && ("80" == lValue));
+    TEST_CHECK(0 != lINI.getInheritedValue("missing", lValue, "app.web"));
+    TEST_CHECK(0 != lINI.getInheritedValue("port", lValue, "nowhere"));
+
+    /* Removing a section prunes the nodes it leaves empty */
+    TEST_CHECK(0 == lINI.removeSection("app.db.primary"));
+    TEST_CHECK(nullptr == lINI.getNode("app.db"));
+    TEST_CHECK(nullptr != lINI.getNode("app.web"));
+
+    /* Another separator rebuilds the tree */
+    TEST_CHECK(nullptr == lINI.getNode("other"));
+    TEST_CHECK(0 == lINI.setSeparator('/'));
+    lNode = lINI.getNode("other/x");
+    TEST_CHECK((nullptr != lNode) && (nullptr != lNode->mParent) && ("other" == lNode->mParent->mPath));
+    TEST_CHECK(nullptr == lINI.getNode("app.web")->mParent->mParent);
+
+    /* The tree is only kept in hierarchy mode */
+    INI lFlat;
+    TEST_CHECK(0 != lFlat.setSeparator('/'));
+
+    return 0;
+}
+
+static int test_loader(void) {
+    /* A throwing task does not take its worker down */
+    {
+        INIThreadPool lPool(1U);
+        std::promise<int> lDone;
+        lPool.submit([](void) { throw std::runtime_error("injected"); });
+        lPool.submit([&lDone](void) { lDone.set_value(42); });
+        TEST_CHECK(42 == lDone.get_future().get());
+    }
+
+    std::vector<std::string> lFiles;
+    for(size_t i = 0U; i < 8U; ++i) {
+        lFiles.push_back(writeFile("loader_" + std::to_string(i) + ".ini",
+            "[file]\nindex=" + std::to_string(i) + "\n"));
+    }
+
+    INILoader lLoader(2U);
+
+    /* Futures complete with the parsed documents */
+    std::vector<std::future<std::unique_ptr<INI>>> lFutures = lLoader.load(lFiles);
+    for(size_t i = 0U; i < lFutures.size(); ++i) {
+        std::unique_ptr<INI> lINI = lFutures[i].get();
+        std::string lValue;
+        TEST_CHECK((nullptr != lINI) && (0 == lINI->getValue("index", lValue, "file")));
+        TEST_CHECK(std::to_string(i) == lValue);
+    }
+
+    /* A missing file fails its own future only */
+    std::future<std::unique_ptr<INI>> lMissing = lLoader.load("initools_test_missing.ini");
+    std::future<std::unique_ptr<INI>> lPresent = lLoader.load(lFiles[0U]);
+    bool lThrown = false;
+    try {
+        (void)lMissing.get();
+    } catch(const INIException &) {
+        lThrown = true;
+    }
+    TEST_CHECK(lThrown);
+    TEST_CHECK(nullptr != lPresent.get());
+
+    /* Callbacks get the result, even after one of them threw */
+    std::promise<int> lFailed;
+    std::promise<int> lLoaded;
+    lLoader.load(lFiles[1U], [](const std::string &pFile, int pResult, std::unique_ptr<INI> pINI) {
+        (void)pFile;
+        (void)pResult;
+        (void)pINI;
+        throw std::runtime_error("injected");
+    });
+    lLoader.load("initools_test_missing.ini", [&lFailed](const std::string &pFile, int pResult, std::unique_ptr<INI> pINI) {
+        (void)pFile;
+        lFailed.set_value((nullptr == pINI) ? pResult : 0);
+    });
+    lLoader.load(lFiles[2U], [&lLoaded](const std::string &pFile, int pResult, std::unique_ptr<INI> pINI) {
+        (void)pFile;
+        lLoaded.set_value((nullptr != pINI) ? pResult : -1);
+    });
+    TEST_CHECK(0 != lFailed.get_future().get());
+    TEST_CHECK(0 == lLoaded.get_future().get());
+
+    for(const auto &lFile : lFiles) {
+        std::remove(lFile.c_str());
+    }
+
+    return 0;
+}
+
+/** @brief Creates a shared memory segment holding pBytes */
+static int writeSegment(const std::string &pName, const std::string &pBytes) {
+    int lFd = shm_open(pName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(0 > lFd) {
+        return -1;
+    }
+
+    const bool lWritten = pBytes.size() == static_cast<size_t>(write(lFd, pBytes.data(), pBytes.size()));
+    close(lFd);
+
+    return lWritten ? 0 : -1;
+}
+
+static int test_shared(void) {
+    const std::string lName = "/initools_test_" + std::to_string(getpid());
+
+    INI lINI(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lINI,
+        "[Server]\n"
+        "Port=80\n"
+        "host=example.org\n"
+        "[client]\n"
+        "retries=3\n"));
+
+    TEST_CHECK(0 == INISharedConfig::publish(lINI, lName));
+
+    INISharedConfig lConfig;
+    TEST_CHECK(0 == lConfig.attach(lName));
+    TEST_CHECK((1U == lConfig.generation()) && (2U == lConfig.sectionCount()));
+
+    std::string_view lValue;
+    TEST_CHECK((0 == lConfig.getValue("port", lValue, "SERVER")) && ("80" == lValue));
+    TEST_CHECK((0 == lConfig.getValue("retries", lValue, "client")) && ("3" == lValue));
+    TEST_CHECK(0 != lConfig.getValue("missing", lValue, "client"));
+    TEST_CHECK(0 != lConfig.getValue("port", lValue, "missing"));
+
+    /* A left over segment of the next generation is skipped, not replaced */
+    const std::string lStale = lName + ".2";
+    TEST_CHECK(0 == writeSegment(lStale, "stale"));
+    TEST_CHECK(0 == lINI.setString("port", "8080", "server"));
+    TEST_CHECK(0 == INISharedConfig::publish(lINI, lName));
+
+    TEST_CHECK(1 == lConfig.refresh());
+    TEST_CHECK(3U == lConfig.generation());
+    TEST_CHECK((0 == lConfig.getValue("port", lValue, "server")) && ("8080" == lValue));
+    TEST_CHECK(0 == lConfig.refresh());
+
+    int lFd = shm_open(lStale.c_str(), O_RDONLY, 0);
+    TEST_CHECK(0 <= lFd);
+    close(lFd);
+    shm_unlink(lStale.c_str());
+
+    /* Images are checked before their first use */
+    std::string lImage;
+    TEST_CHECK(0 == INISharedConfig::serialize(lINI, lImage));
+
+    INISharedHeader lHeader;
+    std::memcpy(&lHeader, lImage.data(), sizeof(lHeader));
+
+    std::vector<std::string> lCorrupted;
+    INISharedHeader lBad = lHeader;
+    lBad.mSectionCount = UINT32_MAX;
+    lCorrupted.push_back(std::string(reinterpret_cast<const char *>(&lBad), sizeof(lBad)) + lImage.substr(sizeof(lBad)));
+    lBad = lHeader;
+    lBad.mSectionsOffset = 0U;
+    lCorrupted.push_back(std::string(reinterpret_cast<const char *>(&lBad), sizeof(lBad)) + lImage.substr(sizeof(lBad)));
+    lBad = lHeader;
+    lBad.mEntriesOffset = UINT64_MAX - 7U;
+    lCorrupted.push_back(std::string(reinterpret_cast<const char *>(&lBad), sizeof(lBad)) + lImage.substr(sizeof(lBad)));
+    lCorrupted.push_back(lImage.substr(0U, lImage.size() - 1U));
+    lCorrupted.push_back(lImage);
+    lCorrupted.back()[lHeader.mEntriesOffset] = '\x7F';
+
+    for(const auto &lCorrupt : lCorrupted) {
+        const std::string lImageName = lName + ".9";
+        TEST_CHECK(0 == writeSegment(lImageName, lCorrupt));
+
+        uint64_t lGeneration = 9U;
+        TEST_CHECK(0 == writeSegment(lName, std::string(reinterpret_cast<const char *>(&lGeneration), sizeof(lGeneration))));
+
+        INISharedConfig lOther;
+        TEST_CHECK(0 != lOther.attach(lName));
+        shm_unlink(lImageName.c_str());
+
+        INI lCopy;
+        TEST_CHECK(0 != INISharedConfig::deserialize(lCorrupt, lCopy));
+    }
+
+    /* The image round-trips through plain bytes */
+    INI lCopy(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == INISharedConfig::deserialize(lImage, lCopy));
+    std::string lPort;
+    TEST_CHECK((0 == lCopy.getValue("port", lPort, "server")) && ("8080" == lPort));
+
+    lConfig.detach();
+    shm_unlink((lName + ".3").c_str());
+    shm_unlink(lName.c_str());
+
+    return 0;
+}
+
+/** @brief Journal whose descriptor can be swapped, to inject failures */
+class FaultyJournal : public INIJournal {
+    public:
+        FaultyJournal(INI &pINI, const std::string &pPath) :
+            INIJournal(pINI, pPath),
+            mPipe(-1)
+        {
+            /* Empty for now */
+        }
+
+        virtual ~FaultyJournal() {
+            close();
+
+            if(0 <= mPipe) {
+                ::close(mPipe);
+            }
+        }
+
+        /** @brief Writes fail with EBADF */
+        void breakWrites(void) {
+            swap(::open(mPath.c_str(), O_RDONLY | O_CLOEXEC));
+        }
+
+        /** @brief Writes succeed, fdatasync fails with EINVAL */
+        void breakSyncs(void) {
+            int lPipe[2] = {-1, -1};
+            if(0 == pipe(lPipe)) {
+                mPipe = lPipe[0];
+            }
+
+            swap(lPipe[1]);
+        }
+
+    protected:
+        void swap(const int &pFd) {
+            std::lock_guard<std::mutex> lLock(mMutex);
+            ::close(mFd);
+            mFd = pFd;
+        }
+
+        int mPipe;
+};
+
+static int test_journal(void) {
+    const std::string lFile    = writeFile("journal.ini", "[app]\nname=a\n");
+    const std::string lJournal = lFile + ".journal";
+    std::string lValue;
+
+    /* A failed fdatasync fails the setter, and the later ones */
+    {
+        INI lINI;
+        TEST_CHECK(0 == lINI.parseFile(lFile));
+
+        FaultyJournal lFaulty(lINI, lJournal);
+        TEST_CHECK(0 == lFaulty.open());
+        TEST_CHECK(0 == lFaulty.setString("name", "b", "app"));
+        TEST_CHECK(!lFaulty.failed());
+
+        lFaulty.breakSyncs();
+        TEST_CHECK(0 != lFaulty.setString("name", "c", "app"));
+        TEST_CHECK(lFaulty.failed());
+
+        TEST_CHECK(0 != lFaulty.setString("name", "d", "app"));
+        TEST_CHECK(0 != lFaulty.addSection("other"));
+        TEST_CHECK((0 == lINI.getValue("name", lValue, "app")) && ("c" == lValue));
+        TEST_CHECK(!lINI.sectionExists("other"));
+        TEST_CHECK(0 != lFaulty.compact());
+    }
+
+    /* Only the durable changes are replayed */
+    {
+        INI lINI;
+        TEST_CHECK(0 == lINI.parseFile(lFile));
+
+        FaultyJournal lFaulty(lINI, lJournal);
+        TEST_CHECK(0 == lFaulty.open());
+        TEST_CHECK((0 == lINI.getValue("name", lValue, "app")) && ("b" == lValue));
+
+        /* A failed write fails every setter waiting on it */
+        lFaulty.breakWrites();
+
+        std::vector<std::thread> lThreads;
+        std::vector<int>         lResults(4U, 0);
+        for(size_t i = 0U; i < lResults.size(); ++i) {
+            lThreads.emplace_back([&lFaulty, &lResults, i](void) {
+                lResults[i] = lFaulty.addString("key" + std::to_string(i), "value", "app");
+            });
+        }
+
+        for(auto &lThread : lThreads) {
+            lThread.join();
+        }
+
+        for(const int &lResult : lResults) {
+            TEST_CHECK(0 != lResult);
+        }
+        TEST_CHECK(lFaulty.failed());
+    }
+
+    /* Concurrent setters, compacted in the background */
+    {
+        INI lINI;
+        TEST_CHECK(0 == lINI.parseFile(lFile));
+
+        INIJournal lINIJournal(lINI, lJournal, 256U);
+        TEST_CHECK(0 == lINIJournal.open());
+        TEST_CHECK((0 == lINI.getValue("name", lValue, "app")) && ("b" == lValue));
+        TEST_CHECK(!lINI.keyExists("key0", "app"));
+
+        std::vector<std::thread> lThreads;
+        std::vector<int>         lFailures(4U, 0);
+        for(size_t i = 0U; i < lFailures.size(); ++i) {
+            lThreads.emplace_back([&lINIJournal, &lFailures, i](void) {
+                if(0 != lINIJournal.addString("key" + std::to_string(i), "", "app")) {
+                    ++lFailures[i];
+                }
+
+                for(size_t j = 0U; j < 50U; ++j) {
+                    if(0 != lINIJournal.setUInt64("key" + std::to_string(i), j, "app")) {
+                        ++lFailures[i];
+                    }
+                }
+            });
+        }
+
+        for(auto &lThread : lThreads) {
+            lThread.join();
+        }
+
+        for(const int &lFailure : lFailures) {
+            TEST_CHECK(0 == lFailure);
+        }
+
+        TEST_CHECK(0 == lINIJournal.compact());
+        TEST_CHECK(0 == lINIJournal.setString("name", "e", "app"));
+        lINIJournal.close();
+    }
+
+    {
+        INI lINI;
+        TEST_CHECK(0 == lINI.parseFile(lFile));
+
+        INIJournal lINIJournal(lINI, lJournal);
+        TEST_CHECK(0 == lINIJournal.open());
+        TEST_CHECK((0 == lINI.getValue("name", lValue, "app")) && ("e" == lValue));
+        for(size_t i = 0U; i < 4U; ++i) {
+            TEST_CHECK((0 == lINI.getValue("key" + std::to_string(i), lValue, "app")) && ("49" == lValue));
+        }
+    }
+
+    std::remove(lFile.c_str());
+    std::remove(lJournal.c_str());
+
+    return 0;
+}
+
+static int test_diff(void) {
+    INI lFrom;
+    INI lTo;
+    TEST_CHECK(0 == parse(lFrom,
+        "[common]\n"
+        "same=1\n"
+        "changed=old\n"
+        "removed=x\n"
+        "[gone]\n"
+        "key=value\n"));
+    TEST_CHECK(0 == parse(lTo,
+        "[added]\n"
+        "fresh=new\n"
+        "[common]\n"
+        "added=y\n"
+        "changed=new\n"
+        "same=1\n"));
+
+    /* Sorted by section then key, each section edit first */
+    std::vector<INIEdit> lScript;
+    TEST_CHECK(0 == INIDiff::diff(lFrom, lTo, lScript));
+    TEST_CHECK(6U == lScript.size());
+    TEST_CHECK((INI_EDIT_ADD_SECTION == lScript[0U].mOp) && ("added" == lScript[0U].mSection.view()));
+    TEST_CHECK((INI_EDIT_ADD_KEY == lScript[1U].mOp) && ("fresh" == lScript[1U].mKey.view()) && ("new" == lScript[1U].mValue.view()));
+    TEST_CHECK((INI_EDIT_ADD_KEY == lScript[2U].mOp) && ("added" == lScript[2U].mKey.view()));
+    TEST_CHECK((INI_EDIT_CHANGE_KEY == lScript[3U].mOp) && ("changed" == lScript[3U].mKey.view()) && ("new" == lScript[3U].mValue.view()));
+    TEST_CHECK((INI_EDIT_REMOVE_KEY == lScript[4U].mOp) && ("removed" == lScript[4U].mKey.view()));
+    TEST_CHECK((INI_EDIT_REMOVE_SECTION == lScript[5U].mOp) && ("gone" == lScript[5U].mSection.view()));
+
+    /* Applying the script leaves nothing to diff */
+    TEST_CHECK(0 == INIDiff::apply(lFrom, lScript));
+    TEST_CHECK(0 == INIDiff::diff(lFrom, lTo, lScript));
+    TEST_CHECK(lScript.empty());
+
+    /* Three-way merge of independent changes */
+    INI lBase;
+    INI lOurs;
+    INI lTheirs;
+    TEST_CHECK(0 == parse(lBase, "[a]\nx=1\ny=2\n[b]\nz=3\n"));
+    TEST_CHECK(0 == parse(lOurs, "[a]\nx=10\ny=2\n[b]\nz=3\n"));
+    TEST_CHECK(0 == parse(lTheirs, "[a]\nx=1\ny=20\n[c]\nw=4\n"));
+
+    std::vector<INIConflict> lConflicts;
+    TEST_CHECK(0 == INIDiff::merge(lBase, lOurs, lTheirs, lScript, lConflicts));
+    TEST_CHECK(lConflicts.empty());
+    TEST_CHECK(0 == INIDiff::apply(lOurs, lScript));
+
+    std::string lValue;
+    TEST_CHECK((0 == lOurs.getValue("x", lValue, "a")) && ("10" == lValue));
+    TEST_CHECK((0 == lOurs.getValue("y", lValue, "a")) && ("20" == lValue));
+    TEST_CHECK((0 == lOurs.getValue("w", lValue, "c")) && ("4" == lValue));
+    TEST_CHECK(!lOurs.sectionExists("b"));
+
+    /* The same change on both sides is not a conflict, different ones are */
+    INI lMine;
+    INI lYours;
+    TEST_CHECK(0 == parse(lMine, "[a]\nx=5\ny=7\n[b]\nz=3\nv=1\n"));
+    TEST_CHECK(0 == parse(lYours, "[a]\nx=5\ny=8\n"));
+    TEST_CHECK(0 != INIDiff::merge(lBase, lMine, lYours, lScript, lConflicts));
+    TEST_CHECK(2U == lConflicts.size());
+    TEST_CHECK(("y" == lConflicts[0U].mOurs.mKey.view()) && ("8" == lConflicts[0U].mTheirs.mValue.view()));
+    TEST_CHECK((INI_EDIT_ADD_KEY == lConflicts[1U].mOurs.mOp) && (INI_EDIT_REMOVE_SECTION == lConflicts[1U].mTheirs.mOp));
+    TEST_CHECK(lScript.empty());
+
+    /* Removing keys of a section the other side removed is no
+     * conflict, whichever side removed the section */
+    INI lKeyRemoved;
+    INI lSectionRemoved;
+    TEST_CHECK(0 == parse(lKeyRemoved, "[a]\nx=1\ny=2\n[b]\n"));
+    TEST_CHECK(0 == parse(lSectionRemoved, "[a]\nx=1\ny=2\n"));
+
+    TEST_CHECK(0 == INIDiff::merge(lBase, lKeyRemoved, lSectionRemoved, lScript, lConflicts));
+    TEST_CHECK(lConflicts.empty());
+    TEST_CHECK((1U == lScript.size()) && (INI_EDIT_REMOVE_SECTION == lScript[0U].mOp));
+    TEST_CHECK(0 == INIDiff::merge(lBase, lSectionRemoved, lKeyRemoved, lScript, lConflicts));
+    TEST_CHECK(lConflicts.empty() && lScript.empty());
+
+    return 0;
+}
+
+static int test_columns(void) {
+    /* Enough rows for three workers, the last chunk ending inside
+     * a validity word. Every 7th device has no weight, every 11th
+     * a bad port. */
+    static const size_t sRows = 13000U;
+
+    std::string lText = "[other]\nport=1\n";
+    for(size_t i = 0U; i < sRows; ++i) {
+        char lName[16];
+        snprintf(lName, sizeof(lName), "dev.%05zu", i);
+
+        lText += "[" + std::string(lName) + "]\n";
+        lText += "ip=10.0." + std::to_string(i / 256U) + "." + std::to_string(i % 256U) + "\n";
+        lText += (0U == (i % 11U)) ? "port=none\n" : "port=" + std::to_string(1000U + i) + "\n";
+        if(0U != (i % 7U)) {
+            lText += "weight=" + std::to_string(i) + ".5\n";
+        }
+        lText += std::string("up=") + ((0U == (i % 2U)) ? "true" : "false") + "\n";
+    }
+
+    INI lINI;
+    TEST_CHECK(0 == parse(lINI, lText));
+
+    const std::vector<INIColumnSpec> lSpecs = {
+        {"ip", INI_TYPE_STRING},
+        {"port", INI_TYPE_INT64},
+        {"weight", INI_TYPE_DOUBLE},
+        {"up", INI_TYPE_BOOLEAN},
+    };
+
+    /* Serial and parallel extraction agree */
+    INIColumns lSerial;
+    INIColumns lParallel;
+    TEST_CHECK(0 == lINI.extractColumns("dev.*", lSpecs, lSerial, 1U));
+    TEST_CHECK(0 == lINI.extractColumns("dev.*", lSpecs, lParallel, 4U));
+    TEST_CHECK((sRows == lSerial.rows()) && (sRows == lParallel.rows()) && (4U == lSerial.mColumns.size()));
+
+    const INIColumn &lIPs     = lParallel.mColumns[0U];
+    const INIColumn &lPorts   = lParallel.mColumns[1U];
+    const INIColumn &lWeights = lParallel.mColumns[2U];
+    const INIColumn &lUps     = lParallel.mColumns[3U];
+    TEST_CHECK((INI_TYPE_DOUBLE == lWeights.type()) && ("weight" == lWeights.key()));
+
+    for(size_t i = 0U; i < sRows; ++i) {
+        TEST_CHECK(lSerial.mSections[i] == lParallel.mSections[i]);
+        TEST_CHECK("10.0." + std::to_string(i / 256U) + "." + std::to_string(i % 256U) == lIPs.strings()[i]);
+
+        TEST_CHECK(lPorts.valid(i) == (0U != (i % 11U)));
+        TEST_CHECK(!lPorts.valid(i) || (static_cast<int64_t>(1000U + i) == lPorts.int64s()[i]));
+        TEST_CHECK(lPorts.valid(i) || (0 == lPorts.int64s()[i]));
+
+        TEST_CHECK(lWeights.valid(i) == (0U != (i % 7U)));
+        TEST_CHECK(!lWeights.valid(i) || (static_cast<double>(i) + 0.5 == lWeights.doubles()[i]));
+
+        TEST_CHECK(lUps.booleans()[i] == ((0U == (i % 2U)) ? 1U : 0U));
+
+        for(size_t j = 0U; j < lSpecs.size(); ++j) {
+            TEST_CHECK(lSerial.mColumns[j].valid(i) == lParallel.mColumns[j].valid(i));
+        }
+    }
+
+    TEST_CHECK(sRows - 1182U == lPorts.validCount());
+    TEST_CHECK(sRows - 1858U == lWeights.validCount());
+    for(size_t j = 0U; j < lSpecs.size(); ++j) {
+        const INIArrayView<uint64_t> lSerialWords   = lSerial.mColumns[j].validity();
+        const INIArrayView<uint64_t> lParallelWords = lParallel.mColumns[j].validity();
+        TEST_CHECK(std::equal(lSerialWords.begin(), lSerialWords.end(), lParallelWords.begin(), lParallelWords.end()));
+    }
+    TEST_CHECK(0U == (lWeights.validity()[0U] & 1U));
+    TEST_CHECK(2U == (lWeights.validity()[0U] & 2U));
+
+    /* Nothing selected, and unsupported types */
+    INIColumns lNone;
+    TEST_CHECK(0 == lINI.extractColumns("none.*", lSpecs, lNone));
+    TEST_CHECK((0U == lNone.rows()) && (4U == lNone.mColumns.size()) && (0U == lNone.mColumns[0U].size()));
+    TEST_CHECK(0 != lINI.extractColumns("dev.*", {{"port", INI_TYPE_UINT64}}, lNone));
+
+    return 0;
+}
+
+static int test_diff_folded(void) {
+    /* Names match ignoring case as soon as one side folds */
+    INI lFrom(INI_MODE_CASE_INSENSITIVE);
+    INI lTo;
+    TEST_CHECK(0 == parse(lFrom, "[Server]\nPort=80\nHost=a\n"));
+    TEST_CHECK(0 == parse(lTo, "[server]\nport=8080\nhost=a\nextra=1\n"));
+
+    std::vector<INIEdit> lScript;
+    TEST_CHECK(0 == INIDiff::diff(lFrom, lTo, lScript));
+    TEST_CHECK(2U == lScript.size());
+    TEST_CHECK((INI_EDIT_ADD_KEY == lScript[0U].mOp) && ("extra" == lScript[0U].mKey.view()));
+    TEST_CHECK((INI_EDIT_CHANGE_KEY == lScript[1U].mOp) && ("8080" == lScript[1U].mValue.view()));
+
+    /* Merges of sections spelled differently on each side */
+    INI lBase(INI_MODE_CASE_INSENSITIVE);
+    INI lOurs(INI_MODE_CASE_INSENSITIVE);
+    INI lTheirs(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lBase, "[Server]\nPort=80\nHost=a\n"));
+    TEST_CHECK(0 == parse(lOurs, "[server]\nport=80\nhost=b\n"));
+    TEST_CHECK(0 == parse(lTheirs, "[SERVER]\nPORT=90\nHOST=a\n"));
+
+    std::vector<INIConflict> lConflicts;
+    TEST_CHECK(0 == INIDiff::merge(lBase, lOurs, lTheirs, lScript, lConflicts));
+    TEST_CHECK((1U == lScript.size()) && lConflicts.empty());
+    TEST_CHECK(0 == INIDiff::apply(lOurs, lScript));
+
+    std::string lValue;
+    TEST_CHECK((0 == lOurs.getValue("Port", lValue, "Server")) && ("90" == lValue));
+    TEST_CHECK((0 == lOurs.getValue("host", lValue, "server")) && ("b" == lValue));
+
+    /* The edits of one section stay together, whatever their spelling :
+     * our removal is spelled as in the base, our change as in our document */
+    INI lRemoved(INI_MODE_CASE_INSENSITIVE);
+    INI lChanged(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lRemoved, "[server]\nport=81\n"));
+    TEST_CHECK(0 == parse(lChanged, "[SERVER]\nhost=a\nport=82\n"));
+    TEST_CHECK(0 != INIDiff::merge(lBase, lRemoved, lChanged, lScript, lConflicts));
+    TEST_CHECK((1U == lConflicts.size()) && ("81" == lConflicts[0U].mOurs.mValue.view()) && ("82" == lConflicts[0U].mTheirs.mValue.view()));
+
+    /* Added keys keep their spelling, down to the generated file */
+    INI lPlain(INI_MODE_CASE_INSENSITIVE);
+    INI lAdded(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lPlain, "[S]\nx=1\n"));
+    TEST_CHECK(0 == parse(lAdded, "[S]\nx=1\nTimeout=5\n"));
+    TEST_CHECK(0 == INIDiff::diff(lPlain, lAdded, lScript));
+    TEST_CHECK((1U == lScript.size()) && ("Timeout" == lScript[0U].mKey.view()));
+    TEST_CHECK(0 == INIDiff::apply(lPlain, lScript));
+
+    std::ostringstream lStream;
+    TEST_CHECK(0 == lPlain.generate(lStream));
+    TEST_CHECK(std::string::npos != lStream.str().find("Timeout=5"));
+
+    /* A case-sensitive side is walked in folded order too */
+    INI lFolded(INI_MODE_CASE_INSENSITIVE);
+    INI lExact;
+    TEST_CHECK(0 == parse(lFolded, "[s]\na=1\nb=2\n"));
+    TEST_CHECK(0 == parse(lExact, "[S]\nB=2\na=1\n[T]\nk=v\n"));
+    TEST_CHECK(0 == INIDiff::diff(lFolded, lExact, lScript));
+    TEST_CHECK((2U == lScript.size()) && (INI_EDIT_ADD_SECTION == lScript[0U].mOp) && ("T" == lScript[0U].mSection.view()));
+    TEST_CHECK(0 == INIDiff::diff(lExact, lFolded, lScript));
+    TEST_CHECK((1U == lScript.size()) && (INI_EDIT_REMOVE_SECTION == lScript[0U].mOp));
+
+    return 0;
+}
+
+static int test_compressed(void) {
+    /* Large enough to span several input and parser chunks */
+    std::string lFirst = "[first]\n";
+    for(size_t i = 0U; i < 20000U; ++i) {
+        lFirst += "key" + std::to_string(i) + "=value " + std::to_string(i) + "\n";
+    }
+    const std::string lSecond = "[second]\nlast=done\n";
+
+#ifdef INI_HAVE_ZLIB
+    /* Concatenated members are read one after the other */
+    const std::string lData = gzip(lFirst) + gzip(lSecond);
+    TEST_CHECK(lData.size() < lFirst.size());
+    const std::string lFile = writeFile("compressed.ini.gz", lData);
+
+    INI lINI;
+    std::string lValue;
+    TEST_CHECK(0 == lINI.parseFile(lFile));
+    TEST_CHECK((0 == lINI.getValue("key19999", lValue, "first")) && ("value 19999" == lValue));
+    TEST_CHECK((0 == lINI.getValue("last", lValue, "second")) && ("done" == lValue));
+
+    /* The streaming parser decompresses too */
+    RecordingHandler lHandler;
+    INIParser lParser(lHandler);
+    std::ifstream lStream(lFile, std::ios::in | std::ios::binary);
+    TEST_CHECK(0 == lParser.parse(lStream));
+    TEST_CHECK(20003U == lHandler.mEvents.size());
+    TEST_CHECK("20001 key19999=value 19999" == lHandler.mEvents[20000U]);
+    TEST_CHECK("20003 last=done" == lHandler.mEvents.back());
+
+    /* Truncated streams are errors */
+    const std::string lTruncated = writeFile("truncated.ini.gz", lData.substr(0U, lData.size() / 2U));
+    INI lBroken;
+    TEST_CHECK(0 != lBroken.parseFile(lTruncated));
+
+    std::remove(lFile.c_str());
+    std::remove(lTruncated.c_str());
+#else /* INI_HAVE_ZLIB */
+    (void)lSecond;
+
+    /* Without zlib, gzip files are refused rather than parsed as text */
+    const std::string lFile = writeFile("compressed.ini.gz", std::string("\x1F\x8B\x08\x00", 4U) + lFirst);
+    INI lINI;
+    TEST_CHECK(0 != lINI.parseFile(lFile));
+    std::remove(lFile.c_str());
+#endif /* INI_HAVE_ZLIB */
+
+    return 0;
+}
+
+static int test_parser(void) {
+    typedef std::vector<std::string> Events;
+
+    /* '=' in values, escapes, joined and quoted lines */
+    {
+        RecordingHandler lHandler;
+        INIParser lParser(lHandler, INI_PARSER_MULTILINE);
+        const std::string lText =
+            "[s]\n"
+            "url=a=b?c=d\n"
+            "joined=one \\\n"
+            "  two\n"
+            "quoted=\"tab\\there\\nnew \\\"line\\\" \\\\\" ; comment\n"
+            "span=\"first\n"
+            "second\"\n"
+            "  indented=entry\n"
+            "last=1";
+        TEST_CHECK((0 == lParser.feed(lText.data(), lText.size())) && (0 == lParser.finish()));
+        TEST_CHECK((Events {
+            "1 [s]",
+            "2 url=a=b?c=d",
+            "3 joined=one two",
+            "5 quoted=tab\there\nnew \"line\" \\",
+            "6 span=first\nsecond",
+            "8 indented=entry",
+            "9 last=1",
+        } == lHandler.mEvents));
+    }
+
+    /* Indented lines are taken as they are, unless asked */
+    {
+        const std::string lText =
+            "[certs]\n"
+            "chain=MIIBLINE1\n"
+            "  MIIBLINE2==\n"
+            "\tkey=value\n"
+            "next=2\n";
+
+        RecordingHandler lHandler;
+        INIParser lParser(lHandler, INI_PARSER_MULTILINE);
+        TEST_CHECK((0 == lParser.feed(lText.data(), lText.size())) && (0 == lParser.finish()));
+        TEST_CHECK((Events {"1 [certs]", "2 chain=MIIBLINE1", "3 MIIBLINE2==", "4 key=value", "5 next=2"} == lHandler.mEvents));
+
+        RecordingHandler lIndented;
+        INIParser lIndentedParser(lIndented, INI_PARSER_MULTILINE | INI_PARSER_INDENTED);
+        TEST_CHECK((0 == lIndentedParser.feed(lText.data(), lText.size())) && (0 == lIndentedParser.finish()));
+        TEST_CHECK((Events {"1 [certs]", "2 chain=MIIBLINE1\nMIIBLINE2==\nkey=value", "5 next=2"} == lIndented.mEvents));
+
+        const std::string lStray = "[s]\nkey=value\n  stray words\n";
+        RecordingHandler lStrayHandler;
+        INIParser lStrayParser(lStrayHandler, INI_PARSER_MULTILINE);
+        TEST_CHECK((0 == lStrayParser.feed(lStray.data(), lStray.size())) && (0 == lStrayParser.finish()));
+        TEST_CHECK((Events {"1 [s]", "2 key=value", "3:3 no '=' sign"} == lStrayHandler.mEvents));
+    }
+
+    /* Syntax errors, with their position */
+    {
+        const std::string lText =
+            "[s]\n"
+            "bad=\"a\\qb\"\n"
+            "after=\"x\" y\n"
+            "open=\"never closed\n"
+            "more";
+
+        RecordingHandler lHandler;
+        INIParser lParser(lHandler, INI_PARSER_MULTILINE);
+        TEST_CHECK((0 == lParser.feed(lText.data(), lText.size())) && (0 == lParser.finish()));
+        TEST_CHECK((Events {"1 [s]", "2:7 invalid escape sequence", "3:11 text after a quoted value", "4:6 unclosed quoted value"} == lHandler.mEvents));
+
+        /* Strict documents refuse a second '=' */
+        INI lStrict;
+        TEST_CHECK(0 != parse(lStrict, "[s]\nurl=a=b\n"));
+    }
+
+    /* Generated files parse back to the same values */
+    INI lINI(INI_MODE_MULTILINE);
+    TEST_CHECK(0 == parse(lINI, "[s]\nplain=x\n"));
+
+    const std::vector<std::string> lValues = {
+        "line one\nline two\r\n",
+        "\"starts quoted",
+        "  \"starts quoted after blanks",
+        "ends with \\",
+        "ends with blanks \t",
+        "  leading blanks",
+        "a=b=c",
+        "back\\slash \"and\" quotes",
+        "tab\there",
+        "",
+    };
+    for(size_t i = 0U; i < lValues.size(); ++i) {
+        TEST_CHECK(0 == lINI.addString("k" + std::to_string(i), lValues[i], "s"));
+    }
+
+    const std::string lFile = writeFile("parser.ini", "");
+    TEST_CHECK(0 == lINI.generateFile(lFile));
+
+    INI lCopy(INI_MODE_MULTILINE);
+    TEST_CHECK(0 == lCopy.parseFile(lFile));
+    for(size_t i = 0U; i < lValues.size(); ++i) {
+        std::string lValue;
+        TEST_CHECK((0 == lCopy.getValue("k" + std::to_string(i), lValue, "s")) && (lValues[i] == lValue));
+    }
+
+    std::remove(lFile.c_str());
+
+    return 0;
+}
+
+static int test_lookups(void) {
+    INI lINI(INI_MODE_INTERPOLATION | INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lINI,
+        "[Net]\n"
+        "port=8080\n"
+        "big=300\n"
+        "negative=-5\n"
+        "ratio=0.25\n"
+        "on=true\n"
+        "text=hello\n"
+        "url=http://${host}:${port}/\n"
+        "host=example.org\n"
+        "broken=${missing}\n"));
+
+    /* The inlined lookups agree with the getters */
+    uint32_t lUInt32 = 0U;
+    uint16_t lUInt16 = 0U;
+    TEST_CHECK((0 == lINI.get("port", lUInt16, "net")) && (8080U == lUInt16));
+    TEST_CHECK((0 == lINI.getUInt32("port", lUInt32, "Net")) && (8080U == lUInt32));
+
+    uint8_t lUInt8 = 0U;
+    int8_t  lInt8  = 0;
+    TEST_CHECK(0 != lINI.get("big", lUInt8, "net"));
+    TEST_CHECK(0 != lINI.getUInt8("big", lUInt8, "net"));
+    TEST_CHECK((0 == lINI.get("negative", lInt8, "net")) && (-5 == lInt8));
+    TEST_CHECK(0 != lINI.get("negative", lUInt32, "net"));
+
+    double lDouble = 0.0;
+    bool   lBool   = false;
+    TEST_CHECK((0 == lINI.get("ratio", lDouble, "net")) && (0.25 == lDouble));
+    TEST_CHECK((0 == lINI.get("on", lBool, "NET")) && lBool);
+    TEST_CHECK(0 != lINI.get("text", lBool, "net"));
+    TEST_CHECK(0 != lINI.get("port", lDouble, "missing"));
+
+    std::string      lString;
+    std::string_view lView;
+    TEST_CHECK((0 == lINI.get("TEXT", lString, "net")) && ("hello" == lString));
+    TEST_CHECK((0 == lINI.get("url", lView, "net")) && ("http://example.org:8080/" == lView));
+
+    /* Views are '\0' terminated, and resolved like the getters */
+    TEST_CHECK((0 == lINI.getView("url", lView, "net")) && ('\0' == lView.data()[lView.size()]));
+    TEST_CHECK((0 == lINI.getValue("url", lString, "net")) && (lString == lView));
+    TEST_CHECK(0 != lINI.getView("broken", lView, "net"));
+    TEST_CHECK(0 != lINI.get("broken", lString, "net"));
+    TEST_CHECK(0 != lINI.getView("missing", lView, "net"));
+
+    return 0;
+}
+
+static int test_json(void) {
+    INI lINI(INI_MODE_INTERPOLATION | INI_MODE_MULTILINE);
+    TEST_CHECK(0 == parse(lINI,
+        "[a]\n"
+        "q=\"say \\\"hi\\\"\\tback\\\\slash\"\n"
+        "n=42\n"
+        "f=1.5e3\n"
+        "b=true\n"
+        "word=yes\n"
+        "ref=${n}!\n"
+        "[b]\n"
+        "ctl=\"\\r\"\n"));
+
+    std::string lOutput;
+    const INIWriteCallback lSink = [&lOutput](const char *pData, const size_t &pSize) {
+        lOutput.append(pData, pSize);
+        return 0;
+    };
+
+    /* Escaped strings, interpolated values exported resolved */
+    TEST_CHECK(0 == lINI.exportJson(lSink));
+    TEST_CHECK(lOutput ==
+        "{\"a\":{\"q\":\"say \\\"hi\\\"\\tback\\\\slash\",\"n\":\"42\",\"f\":\"1.5e3\","
+        "\"b\":\"true\",\"word\":\"yes\",\"ref\":\"42!\"},\"b\":{\"ctl\":\"\\r\"}}");
+
+    /* One line per section */
+    lOutput.clear();
+    TEST_CHECK(0 == lINI.exportJson(lSink, INI_JSON_NDJSON | INI_JSON_TYPED));
+    TEST_CHECK(lOutput ==
+        "{\"section\":\"a\",\"values\":{\"q\":\"say \\\"hi\\\"\\tback\\\\slash\",\"n\":42,\"f\":1500,"
+        "\"b\":true,\"word\":\"yes\",\"ref\":\"42!\"}}\n"
+        "{\"section\":\"b\",\"values\":{\"ctl\":\"\\r\"}}\n");
+
+    /* Large documents go out in bounded chunks */
+    INI lLarge;
+    std::string lText = "[big]\n";
+    for(size_t i = 0U; 20000U > i; ++i) {
+        lText += "key" + std::to_string(i) + "=" + std::string(16U, 'v') + "\n";
+    }
+    TEST_CHECK(0 == parse(lLarge, lText));
+
+    size_t lChunks = 0U;
+    size_t lTotal  = 0U;
+    bool   lBounded = true;
+    TEST_CHECK(0 == lLarge.exportJson([&](const char *pData, const size_t &pSize) {
+        (void)pData;
+        ++lChunks;
+        lTotal += pSize;
+        lBounded = lBounded && (0U < pSize) && (INI_JSON_CHUNK_SIZE >= pSize);
+        return 0;
+    }));
+    TEST_CHECK(lBounded && (1U < lChunks));
+
+    lOutput.clear();
+    TEST_CHECK(0 == lLarge.exportJson(lSink));
+    TEST_CHECK(lTotal == lOutput.size());
+    TEST_CHECK(0 == lOutput.compare(0U, 23U, "{\"big\":{\"key0\":\"vvvvvvv"));
+    TEST_CHECK("}}" == lOutput.substr(lOutput.size() - 2U));
+
+    /* A failing sink stops the export */
+    lChunks = 0U;
+    TEST_CHECK(0 != lLarge.exportJson([&lChunks](const char *pData, const size_t &pSize) {
+        (void)pData;
+        (void)pSize;
+        ++lChunks;
+        return -1;
+    }));
+    TEST_CHECK(1U == lChunks);
+
+    /* The writer escapes control characters on its own */
+    lOutput.clear();
+    {
+        /* The writer keeps its own copy of a temporary sink */
+        INIJsonWriter lWriter([&lOutput](const char *pData, const size_t &pSize) {
+            lOutput.append(pData, pSize);
+            return 0;
+        }, 4U);
+        TEST_CHECK(0 == lWriter.writeString(std::string_view("a\x01" "b\n\"c\"\\", 8U)));
+        TEST_CHECK(0 == lWriter.flush());
+    }
+    TEST_CHECK(lOutput == "\"a\\u0001b\\n\\\"c\\\"\\\\\"");
+
+    return 0;
+}
+
+static int test_registry(void) {
+    static const size_t sThreads = 8U;
+
+    INIRegistry *lRegistry = nullptr;
+    INIRegistry lDocuments(0U, [&lRegistry](const std::string &pName) {
+        std::unique_ptr<INI> lINI = std::make_unique<INI>(INI_MODE_INTERPOLATION);
+        const std::string lText =
+            "[net]\n"
+            "host=" + pName + ".example.org\n"
+            "port=8080\n"
+            "ports=80,443,8080\n"
+            "url=http://${host}:${port}/\n";
+        if(0 != lINI->parseBuffer(lText.data(), lText.size())) {
+            return std::unique_ptr<INI>();
+        }
+
+        /* Hold the load until every other thread waits on it */
+        if("first" == pName) {
+            for(size_t i = 0U; (2000U > i) && ((sThreads - 1U) > lRegistry->waits()); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        return lINI;
+    });
+    lRegistry = &lDocuments;
+    TEST_CHECK(nullptr != lDocuments.get("second"));
+
+    /* All threads share both documents and read them at once */
+    std::vector<std::future<int>> lResults;
+    for(size_t t = 0U; sThreads > t; ++t) {
+        lResults.push_back(std::async(std::launch::async, [&lDocuments](void) {
+            std::shared_ptr<const INI> lFirst  = lDocuments.get("first");
+            std::shared_ptr<const INI> lSecond = lDocuments.get("second");
+            if((nullptr == lFirst) || (nullptr == lSecond)) {
+                return -1;
+            }
+
+            int lErrors = 0;
+            for(size_t i = 0U; 100U > i; ++i) {
+                std::string lURL;
+                INIArrayView<uint32_t> lPorts;
+                std::vector<INIEdit> lScript;
+                lErrors += (0 == lFirst->getString("url", lURL, "net")) && ("http://first.example.org:8080/" == lURL) ? 0 : 1;
+                lErrors += (0 == lSecond->getArray("ports", lPorts, "net")) && (3U == lPorts.size()) ? 0 : 1;
+                lErrors += (0 == INIDiff::diff(*lFirst, *lSecond, lScript)) && (1U == lScript.size()) ? 0 : 1;
+            }
+
+            return lErrors;
+        }));
+    }
+
+    for(std::future<int> &lResult : lResults) {
+        TEST_CHECK(0 == lResult.get());
+    }
+
+    /* One load per name, the threads that came during the first load
+     * waited on it, the others hit */
+    TEST_CHECK(2U == lDocuments.misses());
+    TEST_CHECK((sThreads - 1U) == lDocuments.waits());
+    TEST_CHECK(sThreads == lDocuments.hits());
+
+    TEST_CHECK(nullptr != lDocuments.get("first"));
+    TEST_CHECK((sThreads + 1U) == lDocuments.hits());
+
+    /* Bounded budget, one shard so that the clock visits the names in order */
+    static const std::string sText = "[s]\nkey=some value\nother=another value\n";
+
+    INI lSample;
+    TEST_CHECK(0 == parse(lSample, sText));
+    const size_t lBytes = lSample.memoryUsage();
+
+    INIRegistry lBounded(3U * lBytes + lBytes / 2U, [](const std::string &pName) {
+        std::unique_ptr<INI> lINI = std::make_unique<INI>();
+        if(0 != lINI->parseBuffer(sText.data(), sText.size())) {
+            return std::unique_ptr<INI>();
+        }
+
+        (void)pName;
+        return lINI;
+    }, 1U);
+
+    const std::shared_ptr<const INI> lHeld = lBounded.get("a");
+    TEST_CHECK((nullptr != lBounded.get("b")) && (nullptr != lBounded.get("c")));
+    TEST_CHECK((3U == lBounded.size()) && ((3U * lBytes) == lBounded.usage()) && (0U == lBounded.evictions()));
+
+    /* Everything was referenced : a full turn clears the bits, then "a" goes */
+    TEST_CHECK(nullptr != lBounded.get("d"));
+    TEST_CHECK((3U == lBounded.size()) && (1U == lBounded.evictions()));
+    TEST_CHECK(lBounded.usage() <= lBounded.budget());
+
+    /* "b" gets a second chance, "c" goes */
+    TEST_CHECK(nullptr != lBounded.get("b"));
+    TEST_CHECK(nullptr != lBounded.get("e"));
+    TEST_CHECK((3U == lBounded.size()) && (2U == lBounded.evictions()));
+    TEST_CHECK(lBounded.usage() <= lBounded.budget());
+
+    const uint64_t lMisses = lBounded.misses();
+    TEST_CHECK((nullptr != lBounded.get("b")) && (nullptr != lBounded.get("d")) && (nullptr != lBounded.get("e")));
+    TEST_CHECK(lMisses == lBounded.misses());
+    TEST_CHECK(nullptr != lBounded.get("c"));
+    TEST_CHECK((lMisses + 1U) == lBounded.misses());
+
+    /* The evicted document stays valid for its holder */
+    std::string lValue;
+    TEST_CHECK((0 == lHeld->getValue("key", lValue, "s")) && ("some value" == lValue));
+
+    /* Erasing gives the footprint back */
+    lBounded.clear();
+    TEST_CHECK((0U == lBounded.size()) && (0U == lBounded.usage()));
+
+    return 0;
+}
+
+static int test_tool(void) {
+#ifdef INI_TOOL_PATH
+    static const std::string sText = "\n[net]\nport=8080\n\n\nhost=example.org\n[empty]\n";
+
+    INI lExpected;
+    TEST_CHECK(0 == parse(lExpected, sText));
+    std::ostringstream lLayout;
+    TEST_CHECK(0 == lExpected.generate(lLayout));
+    TEST_CHECK(sText != lLayout.str());
+
+    /* Text files are rewritten in the generator's layout,
+     * the library staying quiet on success */
+    std::string lOutput;
+    const std::string lText = writeFile("tool.ini", sText);
+    TEST_CHECK(0 == runTool("normalize -j 2 " + lText, lOutput));
+    TEST_CHECK(lLayout.str() == readBack(lText));
+    TEST_CHECK(std::string::npos == lOutput.find("Parsed INI file"));
+
+    /* Snapshots stay snapshots */
+    std::string lImage;
+    TEST_CHECK(0 == INISharedConfig::serialize(lExpected, lImage));
+    const std::string lSnapshot = writeFile("tool.snap", lImage);
+    TEST_CHECK(0 == runTool("normalize " + lSnapshot, lOutput));
+
+    /* Images keep the sections and keys in name order */
+    INI lOriginal;
+    INI lReloaded;
+    TEST_CHECK(0 == INISharedConfig::deserialize(lImage, lOriginal));
+    TEST_CHECK(0 == INISharedConfig::deserialize(readBack(lSnapshot), lReloaded));
+    std::ostringstream lOriginalLayout;
+    std::ostringstream lReloadedLayout;
+    TEST_CHECK(0 == lOriginal.generate(lOriginalLayout));
+    TEST_CHECK(0 == lReloaded.generate(lReloadedLayout));
+    TEST_CHECK(lOriginalLayout.str() == lReloadedLayout.str());
+
+    /* A snapshot pointing out of its bounds is rejected */
+    INISharedHeader lHeader;
+    std::memcpy(&lHeader, lImage.data(), sizeof(lHeader));
+    lHeader.mStringsOffset = UINT64_MAX - 4U;
+    std::string lCorrupt = lImage;
+    std::memcpy(&lCorrupt[0U], &lHeader, sizeof(lHeader));
+
+    INI lRejected;
+    TEST_CHECK(0 != INISharedConfig::deserialize(lCorrupt, lRejected));
+    const std::string lBad = writeFile("tool_bad.snap", lCorrupt);
+    TEST_CHECK(0 != runTool("lint " + lBad, lOutput));
+    TEST_CHECK(lCorrupt == readBack(lBad));
+
+#ifdef INI_HAVE_ZLIB
+    /* Compressed files cannot be written back as they were */
+    const std::string lCompressed = writeFile("tool.ini.gz", gzip(sText));
+    TEST_CHECK(0 != runTool("normalize " + lCompressed, lOutput));
+    TEST_CHECK(gzip(sText) == readBack(lCompressed));
+    TEST_CHECK(std::string::npos != lOutput.find("Refusing to rewrite compressed file"));
+
+    TEST_CHECK(0 == runTool("convert --to json -t " + lCompressed, lOutput));
+    const std::string lJson = lCompressed.substr(0U, lCompressed.size() - 3U) + ".json";
+    TEST_CHECK("{\"net\":{\"port\":8080,\"host\":\"example.org\"},\"empty\":{}}" == readBack(lJson));
+
+    std::remove(lCompressed.c_str());
+    std::remove(lJson.c_str());
+#endif /* INI_HAVE_ZLIB */
+
+    std::remove(lText.c_str());
+    std::remove(lSnapshot.c_str());
+    std::remove(lBad.c_str());
+#else /* INI_TOOL_PATH */
+    std::cout << "[INFO ] Tool not built, skipping" << std::endl;
+#endif /* INI_TOOL_PATH */
+
+    return 0;
+}
+
+static int test_freeze(void) {
+    INI lINI(INI_MODE_CASE_INSENSITIVE);
+    std::string lText;
+    for(size_t i = 0U; 200U > i; ++i) {
+        lText += "[Section" + std::to_string(i) + "]\n";
+        for(size_t j = 0U; 25U > j; ++j) {
+            lText += "Key" + std::to_string(j) + "=" + std::to_string(i * 100U + j) + "\n";
+        }
+    }
+    TEST_CHECK(0 == parse(lINI, lText));
+
+    TEST_CHECK(!lINI.frozen());
+    TEST_CHECK(0 == lINI.freeze());
+    TEST_CHECK(lINI.frozen());
+
+    /* Every pair is found through the hash, in any case */
+    size_t lFound = 0U;
+    for(size_t i = 0U; 200U > i; ++i) {
+        for(size_t j = 0U; 25U > j; ++j) {
+            uint32_t lValue = 0U;
+            const std::string lSection = ((0U == (i % 2U)) ? "section" : "SECTION") + std::to_string(i);
+            if((0 == lINI.getUInt32("kEY" + std::to_string(j), lValue, lSection)) && ((i * 100U + j) == lValue)) {
+                ++lFound;
+            }
+        }
+    }
+    TEST_CHECK(5000U == lFound);
+
+    /* Names that are not in the document */
+    std::string lValue;
+    TEST_CHECK(0 != lINI.getValue("Key25", lValue, "Section0"));
+    TEST_CHECK(0 != lINI.getValue("Key0", lValue, "Section200"));
+    TEST_CHECK(0 != lINI.getValue("Key0", lValue, "Section"));
+    TEST_CHECK(0 != lINI.getValue("", lValue, ""));
+
+    /* Read-only until thawed */
+    TEST_CHECK(0 != lINI.setString("Key0", "changed", "Section0"));
+    TEST_CHECK(0 != lINI.addString("Key99", "added", "Section0"));
+    TEST_CHECK(0 != lINI.removeKey("Section0", "Key1"));
+    TEST_CHECK(0 != lINI.removeSection("Section1"));
+    TEST_CHECK(0 != parse(lINI, "[Section0]\nKey0=parsed\n"));
+    TEST_CHECK((0 == lINI.getValue("Key0", lValue, "Section0")) && ("0" == lValue));
+
+    lINI.thaw();
+    TEST_CHECK(!lINI.frozen());
+    TEST_CHECK(0 == lINI.setString("Key0", "changed", "Section0"));
+    TEST_CHECK(0 == lINI.removeKey("Section0", "Key1"));
+
+    /* Freezing again sees the changes */
+    TEST_CHECK(0 == lINI.freeze());
+    TEST_CHECK((0 == lINI.getValue("KEY0", lValue, "section0")) && ("changed" == lValue));
+    TEST_CHECK(0 != lINI.getValue("Key1", lValue, "Section0"));
+    TEST_CHECK((0 == lINI.getValue("Key2", lValue, "Section0")) && ("2" == lValue));
+
+    /* The index itself is minimal : one slot per pair */
+    std::vector<std::string> lNames;
+    for(size_t i = 0U; 1000U > i; ++i) {
+        lNames.push_back("name" + std::to_string(i));
+    }
+
+    std::vector<INIEntry> lEntries(lNames.size());
+    std::vector<INIFrozenItem> lItems;
+    for(size_t i = 0U; lNames.size() > i; ++i) {
+        lItems.push_back(INIFrozenItem{"section", lNames[i], &lEntries[i]});
+    }
+
+    INIFrozenIndex lIndex;
+    TEST_CHECK(0 == lIndex.build(lItems));
+    TEST_CHECK(lItems.size() == lIndex.size());
+
+    size_t lHits = 0U;
+    for(size_t i = 0U; lNames.size() > i; ++i) {
+        lHits += (&lEntries[i] == lIndex.find("section", lNames[i])) ? 1U : 0U;
+    }
+    TEST_CHECK(lNames.size() == lHits);
+    TEST_CHECK(nullptr == lIndex.find("section", "name1000"));
+    TEST_CHECK(nullptr == lIndex.find("other", "name0"));
+
+    /* Empty documents freeze too */
+    INI lEmpty;
+    TEST_CHECK(0 == lEmpty.freeze());
+    TEST_CHECK(0 != lEmpty.getValue("key", lValue, "section"));
+
+    return 0;
+}
+
+static int test_value_index(void) {
+    INI lINI(INI_MODE_CASE_INSENSITIVE);
+    TEST_CHECK(0 == parse(lINI,
+        "[db1]\n"
+        "role=primary\n"
+        "address=10.0.0.1\n"
+        "[db2]\n"
+        "role=replica\n"
+        "address=10.0.0.2\n"
+        "[db3]\n"
+        "Role=primary\n"
+        "backup=10.0.0.1\n"));
+
+    /* Not indexed yet */
+    TEST_CHECK(lINI.findValue("primary").empty());
+
+    TEST_CHECK(0 == lINI.indexValues(INI_VALUE_INDEX_VALUES | INI_VALUE_INDEX_PAIRS));
+
+    /* Sections of the entries, names as first written */
+    auto lSections = [](const INIValueQuery &pQuery) {
+        std::vector<std::string> lResult;
+        for(const INIValueRef &lRef : pQuery) {
+            lResult.push_back(std::string(lRef.mSection) + "/" + std::string(lRef.mKey));
+        }
+        std::sort(lResult.begin(), lResult.end());
+        return lResult;
+    };
+
+    TEST_CHECK((std::vector<std::string>{"db1/role", "db3/Role"}) == lSections(lINI.findValue("primary")));
+    TEST_CHECK((std::vector<std::string>{"db1/address", "db3/backup"}) == lSections(lINI.findValue("10.0.0.1")));
+    TEST_CHECK((std::vector<std::string>{"db1/address"}) == lSections(lINI.findValue("ADDRESS", "10.0.0.1")));
+    TEST_CHECK(2U == lINI.findValue("role", "primary").count());
+    TEST_CHECK(lINI.findValue("Primary").empty());
+    TEST_CHECK(lINI.findValue("missing").empty());
+
+    /* Kept up to date by the setters, adders and removers */
+    TEST_CHECK(0 == lINI.setString("role", "primary", "db2"));
+    TEST_CHECK(3U == lINI.findValue("role", "primary").count());
+    TEST_CHECK(lINI.findValue("replica").empty());
+
+    TEST_CHECK(0 == lINI.addSection("db4"));
+    TEST_CHECK(0 == lINI.addString("role", "primary", "db4"));
+    TEST_CHECK(4U == lINI.findValue("primary").count());
+
+    TEST_CHECK(0 == lINI.removeKey("db1", "role"));
+    TEST_CHECK(0 == lINI.removeSection("db3"));
+    TEST_CHECK((std::vector<std::string>{"db2/role", "db4/role"}) == lSections(lINI.findValue("primary")));
+    TEST_CHECK((std::vector<std::string>{"db1/address"}) == lSections(lINI.findValue("10.0.0.1")));
+
+    /* Parsing replaces the document, the index is built again */
+    TEST_CHECK(0 == parse(lINI, "[db5]\nrole=primary\n[db6]\nrole=primary\n"));
+    TEST_CHECK((std::vector<std::string>{"db5/role", "db6/role"}) == lSections(lINI.findValue("Role", "primary")));
+    TEST_CHECK(lINI.findValue("10.0.0.1").empty());
+
+    /* The views see the current values */
+    for(const INIValueRef &lRef : lINI.findValue("primary")) {
+        TEST_CHECK("primary" == lRef.mValue);
+        TEST_CHECK(lRef.mEntry->mValue.view() == lRef.mValue);
+    }
+
+    /* Agrees with a scan, including values sharing a hash bucket */
+    INI lLarge;
+    std::string lText = "[large]\n";
+    for(size_t i = 0U; 5000U > i; ++i) {
+        lText += "key" + std::to_string(i) + "=" + std::to_string(i % 37U) + "\n";
+    }
+    TEST_CHECK(0 == parse(lLarge, lText));
+    TEST_CHECK(0 == lLarge.indexValues(INI_VALUE_INDEX_PAIRS));
+    TEST_CHECK(lLarge.findValue("7").empty());
+    TEST_CHECK(1U == lLarge.findValue("key44", "7").count());
+    TEST_CHECK(0U == lLarge.findValue("key45", "7").count());
+
+    TEST_CHECK(0 == lLarge.indexValues(INI_VALUE_INDEX_VALUES));
+    size_t lTotal = 0U;
+    for(size_t v = 0U; 37U > v; ++v) {
+        const size_t lCount = lLarge.findValue(std::to_string(v)).count();
+        TEST_CHECK(((5000U / 37U) + ((v < (5000U % 37U)) ? 1U : 0U)) == lCount);
+        lTotal += lCount;
+    }
+    TEST_CHECK(5000U == lTotal);
+
+    lLarge.dropValueIndex();
+    TEST_CHECK(lLarge.findValue("7").empty());
+
+    return 0;
+}
+
+static int test_generate(void) {
+    /* Enough entries for several chunks, with values that need quoting */
+    INI lINI(INI_MODE_MULTILINE);
+    std::string lText = "[huge]\n";
+    for(size_t i = 0U; 20000U > i; ++i) {
+        lText += "key" + std::to_string(i) + "=value " + std::to_string(i) + "\n";
+    }
+    for(size_t i = 0U; 50U > i; ++i) {
+        lText += "[section" + std::to_string(i) + "]\n";
+        for(size_t j = 0U; 1000U > j; ++j) {
+            lText += "key" + std::to_string(j) + "=";
+            switch(j % 4U) {
+                case 0U:  lText += "plain"; break;
+                case 1U:  lText += "\"trailing blank \""; break;
+                case 2U:  lText += "\"two\\nlines\""; break;
+                default:  lText += "a=b"; break;
+            }
+            lText += "\n";
+        }
+    }
+    TEST_CHECK(0 == parse(lINI, lText));
+
+    std::ostringstream lStream;
+    TEST_CHECK(0 == lINI.generate(lStream));
+
+    std::string lOutputs[3U];
+    const size_t lThreads[3U] = {1U, 4U, 0U};
+    for(size_t i = 0U; 3U > i; ++i) {
+        const std::string lFile = writeFile("generate_" + std::to_string(i) + ".ini", "");
+        TEST_CHECK(0 == lINI.generateFile(lFile, lThreads[i]));
+
+        std::ifstream lRead(lFile, std::ios::in | std::ios::binary);
+        std::ostringstream lContents;
+        lContents << lRead.rdbuf();
+        lOutputs[i] = lContents.str();
+
+        std::remove(lFile.c_str());
+    }
+
+    /* Byte for byte the same, however many workers */
+    TEST_CHECK(70000U < lStream.str().size());
+    TEST_CHECK(std::string::npos != lStream.str().find("key1=\"trailing blank \"\n"));
+    TEST_CHECK(lStream.str() == lOutputs[0U]);
+    TEST_CHECK(lOutputs[0U] == lOutputs[1U]);
+    TEST_CHECK(lOutputs[0U] == lOutputs[2U]);
+
+    /* And it parses back to the same document */
+    INI lBack(INI_MODE_MULTILINE);
+    TEST_CHECK(0 == parse(lBack, lOutputs[1U]));
+    std::ostringstream lBackStream;
+    TEST_CHECK(0 == lBack.generate(lBackStream));
+    TEST_CHECK(lBackStream.str() == lOutputs[1U]);
+
+    return 0;
+}
+
+/* ----------------------------------------------------- */
+/* Main tests ------------------------------------------ */
+/* ----------------------------------------------------- */
+int main(const int argc, const char * const * const argv) {
+    /* Test function initialization */
+    int32_t lTestNum;
+    int16_t lResult = 0;
+
+    if ((argc < 2) || (strcmp(argv[1], "--help") == 0)) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    lTestNum = strtol(argv[1], NULL, 10);
+
+    printf("[TEST ] Executing test #%d\n", lTestNum);
+
+    /* Executing test */
+    switch (lTestNum) {
+        case 0:
+            lResult = test_interning();
+            break;
+        case 1:
+            lResult = test_binding();
+            break;
+        case 2:
+            lResult = test_runtime_schema();
+            break;
+        case 3:
+            lResult = test_interpolation();
+            break;
+        case 4:
+            lResult = test_lists();
+            break;
+        case 5:
+            lResult = test_queries();
+            break;
+        case 6:
+            lResult = test_tree();
+            break;
+        case 7:
+            lResult = test_loader();
+            break;
+        case 8:
+            lResult = test_shared();
+            break;
+        case 9:
+            lResult = test_journal();
+            break;
+        case 10:
+            lResult = test_diff();
+            break;
+        case 11:
+            lResult = test_columns();
+            break;
+        case 12:
+            lResult = test_diff_folded();
+            break;
+        case 13:
+            lResult = test_compressed();
+            break;
+        case 14:
+            lResult = test_parser();
+            break;
+        case 15:
+            lResult = test_lookups();
+            break;
+        case 16:
+            lResult = test_json();
+            break;
+        case 17:
+            lResult = test_registry();
+            break;
+        case 18:
+            lResult = test_tool();
+            break;
+        case 19:
+            lResult = test_freeze();
+            break;
+        case 20:
+            lResult = test_value_index();
+            break;
+        case 21:
+            lResult = test_generate();
+            break;
+        default:
+            (void)lResult;
+            printf("[INFO ] test #%d not available\n", lTestNum);
+            fflush(stdout);
+            break;
+    }
+
+    if(0 != lResult) {
+        printf("[ERROR] test #%d failed\n", lTestNum);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
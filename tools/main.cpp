@@ -0,0 +1,490 @@
+/**
+ * @brief initools command line tool
+ *
+ * @file main.cpp
+ */
+
+/* Includes -------------------------------------------- */
+#include "INI.hpp"
+#include "INIShared.hpp"
+#include "INIThreadPool.hpp"
+
+/* C++ system */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+/* C system */
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+/* Defines --------------------------------------------- */
+/** @brief Parses per file for the bench command, by default */
+#define INI_TOOL_RUNS 10U
+
+/* Notes ----------------------------------------------- */
+
+/* Variable declaration -------------------------------- */
+/** @brief Serializes the lines printed by the workers */
+static std::mutex sOutputMutex;
+
+/* Type definitions ------------------------------------ */
+enum INIToolCommand {
+    INI_TOOL_LINT = 0,
+    INI_TOOL_NORMALIZE,
+    INI_TOOL_CONVERT,
+    INI_TOOL_BENCH,
+};
+
+enum INIToolFormat {
+    INI_TOOL_FORMAT_INI = 0,
+    INI_TOOL_FORMAT_JSON,
+    INI_TOOL_FORMAT_NDJSON,
+    INI_TOOL_FORMAT_SNAPSHOT,
+};
+
+/** @brief Format of an input file, as detected when reading it */
+enum INIToolInput {
+    INI_TOOL_INPUT_TEXT = 0,
+    INI_TOOL_INPUT_COMPRESSED,
+    INI_TOOL_INPUT_SNAPSHOT,
+};
+
+struct INIToolOptions {
+    INIToolCommand mCommand;
+    INIToolFormat  mFormat;
+    size_t         mJobs;
+    size_t         mRuns;
+    uint32_t       mMode;
+    bool           mTyped;
+    bool           mVerbose;
+    std::string    mOutputDir;
+
+    std::vector<std::string> mFiles;
+};
+
+/** @brief Totals over every file, updated by the workers */
+struct INIToolSummary {
+    std::atomic<size_t>   mFiles;
+    std::atomic<size_t>   mFailed;
+    std::atomic<uint64_t> mBytes;
+};
+
+typedef std::chrono::steady_clock INIToolClock;
+
+/* Support functions ----------------------------------- */
+static void printUsage(const char * const pProgName)
+{
+    std::cout << "[USAGE] " << pProgName << " <command> [options] <file>..." << std::endl;
+    std::cout << "        lint      : Parse the files and report the errors" << std::endl;
+    std::cout << "        normalize : Rewrite the files in place, in the generator's layout" << std::endl;
+    std::cout << "                    (snapshots stay snapshots, compressed files are refused)" << std::endl;
+    std::cout << "        convert   : Convert the files, see --to" << std::endl;
+    std::cout << "        bench     : Parse the files repeatedly and time them" << std::endl;
+    std::cout << "        -j <jobs> : Worker threads, one per hardware thread by default" << std::endl;
+    std::cout << "        --to <ini|json|ndjson|snapshot> : Output format of convert" << std::endl;
+    std::cout << "        -o <dir>  : Output directory of convert, next to the input by default" << std::endl;
+    std::cout << "        -n <runs> : Parses per file for bench (" << INI_TOOL_RUNS << " by default)" << std::endl;
+    std::cout << "        -@ <list> : Also read file names from a list, one per line ('-' for stdin)" << std::endl;
+    std::cout << "        -i        : Case-insensitive section and key names" << std::endl;
+    std::cout << "        -m        : Multi-line, continued and quoted values" << std::endl;
+    std::cout << "        -M        : Same as -m, indented lines also continue the value" << std::endl;
+    std::cout << "        -k        : Keep going after syntax errors, reporting all of them" << std::endl;
+    std::cout << "        -t        : Typed JSON values" << std::endl;
+    std::cout << "        -v        : Print the timing of every file" << std::endl;
+    std::cout << "        Snapshots (shared memory images) are detected when reading." << std::endl;
+}
+
+static int readList(const std::string &pList, std::vector<std::string> &pFiles) {
+    std::ifstream lFile;
+    if("-" != pList) {
+        lFile.open(pList);
+        if(!lFile.is_open()) {
+            std::cerr << "[ERROR] Failed to open list " << pList << std::endl;
+            return -1;
+        }
+    }
+
+    std::istream &lStream = ("-" == pList) ? std::cin : lFile;
+
+    std::string lLine;
+    while(std::getline(lStream, lLine)) {
+        if(!lLine.empty()) {
+            pFiles.push_back(lLine);
+        }
+    }
+
+    return 0;
+}
+
+static int parseArgs(const int argc, const char * const * const argv, INIToolOptions &pOptions) {
+    const std::string lCommand = argv[1U];
+    if("lint" == lCommand) {
+        pOptions.mCommand = INI_TOOL_LINT;
+    } else if("normalize" == lCommand) {
+        pOptions.mCommand = INI_TOOL_NORMALIZE;
+    } else if("convert" == lCommand) {
+        pOptions.mCommand = INI_TOOL_CONVERT;
+    } else if("bench" == lCommand) {
+        pOptions.mCommand = INI_TOOL_BENCH;
+    } else {
+        std::cerr << "[ERROR] Unknown command " << lCommand << std::endl;
+        return -1;
+    }
+
+    for(int i = 2; i < argc; ++i) {
+        const std::string lArg = argv[i];
+        const bool lHasValue = (i + 1) < argc;
+
+        if(("-j" == lArg) && lHasValue) {
+            pOptions.mJobs = std::strtoul(argv[++i], nullptr, 10);
+        } else if(("-n" == lArg) && lHasValue) {
+            pOptions.mRuns = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1U);
+        } else if(("-o" == lArg) && lHasValue) {
+            pOptions.mOutputDir = argv[++i];
+        } else if(("-@" == lArg) && lHasValue) {
+            if(0 != readList(argv[++i], pOptions.mFiles)) {
+                return -1;
+            }
+        } else if(("--to" == lArg) && lHasValue) {
+            const std::string lFormat = argv[++i];
+            if("ini" == lFormat) {
+                pOptions.mFormat = INI_TOOL_FORMAT_INI;
+            } else if("json" == lFormat) {
+                pOptions.mFormat = INI_TOOL_FORMAT_JSON;
+            } else if("ndjson" == lFormat) {
+                pOptions.mFormat = INI_TOOL_FORMAT_NDJSON;
+            } else if("snapshot" == lFormat) {
+                pOptions.mFormat = INI_TOOL_FORMAT_SNAPSHOT;
+            } else {
+                std::cerr << "[ERROR] Unknown format " << lFormat << std::endl;
+                return -1;
+            }
+        } else if("-i" == lArg) {
+            pOptions.mMode |= INI_MODE_CASE_INSENSITIVE;
+        } else if("-m" == lArg) {
+            pOptions.mMode |= INI_MODE_MULTILINE;
+        } else if("-M" == lArg) {
+            pOptions.mMode |= INI_MODE_MULTILINE | INI_MODE_INDENTED;
+        } else if("-k" == lArg) {
+            pOptions.mMode |= INI_MODE_TOLERANT;
+        } else if("-t" == lArg) {
+            pOptions.mTyped = true;
+        } else if("-v" == lArg) {
+            pOptions.mVerbose = true;
+        } else if(('-' == lArg[0U]) && (1U < lArg.size())) {
+            std::cerr << "[ERROR] Unknown option " << lArg << std::endl;
+            return -1;
+        } else {
+            pOptions.mFiles.push_back(lArg);
+        }
+    }
+
+    if(pOptions.mFiles.empty()) {
+        std::cerr << "[ERROR] No input file" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int readFile(const std::string &pFile, std::string &pData) {
+    std::ifstream lFile(pFile, std::ios::in | std::ios::binary);
+    if(!lFile.is_open()) {
+        return -1;
+    }
+
+    std::ostringstream lStream;
+    lStream << lFile.rdbuf();
+    pData = lStream.str();
+
+    return lFile.bad() ? -1 : 0;
+}
+
+static int writeFile(const std::string &pFile, const std::string &pData) {
+    std::ofstream lFile(pFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!lFile.is_open()) {
+        return -1;
+    }
+
+    lFile.write(pData.data(), static_cast<std::streamsize>(pData.size()));
+    lFile.close();
+
+    return lFile.fail() ? -1 : 0;
+}
+
+/** @brief Loads a text file (possibly compressed) or a snapshot */
+static std::unique_ptr<INI> load(const std::string &pFile, const uint32_t &pMode, uint64_t &pBytes, INIToolInput &pInput) {
+    /* gzip and zstd magic bytes */
+    static const unsigned char sGzipMagic[] = {0x1FU, 0x8BU};
+    static const unsigned char sZstdMagic[] = {0x28U, 0xB5U, 0x2FU, 0xFDU};
+
+    std::ifstream lFile(pFile, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!lFile.is_open()) {
+        std::cerr << "[ERROR] Failed to open " << pFile << std::endl;
+        return nullptr;
+    }
+
+    pBytes = static_cast<uint64_t>(lFile.tellg());
+    lFile.seekg(0);
+
+    unsigned char lHead[sizeof(uint32_t)] = {0U};
+    lFile.read(reinterpret_cast<char *>(lHead), sizeof(lHead));
+    lFile.close();
+
+    uint32_t lMagic = 0U;
+    std::memcpy(&lMagic, lHead, sizeof(lMagic));
+
+    if(INI_SHARED_MAGIC == lMagic) {
+        pInput = INI_TOOL_INPUT_SNAPSHOT;
+    } else if((0 == std::memcmp(lHead, sGzipMagic, sizeof(sGzipMagic)))
+        || (0 == std::memcmp(lHead, sZstdMagic, sizeof(sZstdMagic))))
+    {
+        pInput = INI_TOOL_INPUT_COMPRESSED;
+    } else {
+        pInput = INI_TOOL_INPUT_TEXT;
+    }
+
+    std::unique_ptr<INI> lINI = std::make_unique<INI>(pMode);
+
+    int lResult = 0;
+    if(INI_TOOL_INPUT_SNAPSHOT == pInput) {
+        std::string lData;
+        lResult = readFile(pFile, lData);
+        if(0 == lResult) {
+            lResult = INISharedConfig::deserialize(lData, *lINI);
+        }
+    } else {
+        lResult = lINI->parseFile(pFile);
+    }
+
+    if(0 != lResult) {
+        return nullptr;
+    }
+
+    return lINI;
+}
+
+static std::string outputFile(const std::string &pFile, const std::string &pDir, const INIToolFormat &pFormat) {
+    static const char * const sExtensions[] = {".ini", ".json", ".ndjson", ".snap"};
+
+    const size_t lSlash = pFile.find_last_of('/');
+    const size_t lBegin = (std::string::npos == lSlash) ? 0U : (lSlash + 1U);
+    size_t lDot = pFile.find_last_of('.');
+    if((std::string::npos == lDot) || (lDot < lBegin)) {
+        lDot = pFile.size();
+    }
+
+    const std::string lDir  = pDir.empty() ? pFile.substr(0U, lBegin) : (pDir + "/");
+    const std::string lStem = pFile.substr(lBegin, lDot - lBegin);
+
+    return lDir + lStem + sExtensions[pFormat];
+}
+
+static int convert(const INI &pINI, const INIToolOptions &pOptions, const std::string &pFile) {
+    const std::string lOutput = outputFile(pFile, pOptions.mOutputDir, pOptions.mFormat);
+    if(lOutput == pFile) {
+        std::cerr << "[ERROR] Refusing to overwrite " << pFile << ", use -o" << std::endl;
+        return -1;
+    }
+
+    std::string lData;
+    switch(pOptions.mFormat) {
+        case INI_TOOL_FORMAT_SNAPSHOT:
+            if(0 != INISharedConfig::serialize(pINI, lData)) {
+                return -1;
+            }
+            break;
+        case INI_TOOL_FORMAT_JSON:
+        case INI_TOOL_FORMAT_NDJSON: {
+            uint32_t lFlags = (INI_TOOL_FORMAT_NDJSON == pOptions.mFormat) ? INI_JSON_NDJSON : INI_JSON_DEFAULT;
+            if(pOptions.mTyped) {
+                lFlags |= INI_JSON_TYPED;
+            }
+
+            const INIWriteCallback lSink = [&lData](const char *pData, const size_t &pSize) {
+                lData.append(pData, pSize);
+                return 0;
+            };
+
+            if(0 != pINI.exportJson(lSink, lFlags)) {
+                return -1;
+            }
+            break;
+        }
+        default: {
+            std::ostringstream lStream;
+            if(0 != pINI.generate(lStream)) {
+                return -1;
+            }
+            lData = lStream.str();
+            break;
+        }
+    }
+
+    if(0 != writeFile(lOutput, lData)) {
+        std::cerr << "[ERROR] Failed to write " << lOutput << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/** @brief Rewrites the file in its own format. Compressed
+ * files are refused, as they could only be written back as text. */
+static int normalize(const INI &pINI, const std::string &pFile, const INIToolInput &pInput) {
+    std::string lData;
+    switch(pInput) {
+        case INI_TOOL_INPUT_COMPRESSED:
+            std::cerr << "[ERROR] Refusing to rewrite compressed file " << pFile << ", use convert" << std::endl;
+            return -1;
+        case INI_TOOL_INPUT_SNAPSHOT:
+            if(0 != INISharedConfig::serialize(pINI, lData)) {
+                return -1;
+            }
+            break;
+        default: {
+            std::ostringstream lStream;
+            if(0 != pINI.generate(lStream)) {
+                return -1;
+            }
+            lData = lStream.str();
+            break;
+        }
+    }
+
+    /* Replace the file at once, never leaving it half written */
+    const std::string lTemp = pFile + ".tmp";
+    if((0 != writeFile(lTemp, lData)) || (0 != std::rename(lTemp.c_str(), pFile.c_str()))) {
+        std::cerr << "[ERROR] Failed to rewrite " << pFile << std::endl;
+        std::remove(lTemp.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+/** @brief Runs the command on one file, from a worker */
+static int process(const INIToolOptions &pOptions, const std::string &pFile, uint64_t &pBytes) {
+    const size_t lRuns = (INI_TOOL_BENCH == pOptions.mCommand) ? pOptions.mRuns : 1U;
+
+    std::unique_ptr<INI> lINI;
+    INIToolInput lInput = INI_TOOL_INPUT_TEXT;
+    for(size_t i = 0U; i < lRuns; ++i) {
+        uint64_t lBytes = 0U;
+        lINI = load(pFile, pOptions.mMode, lBytes, lInput);
+        pBytes += lBytes;
+
+        if(nullptr == lINI) {
+            return -1;
+        }
+    }
+
+    if(!lINI->diagnostics().empty()) {
+        /* Tolerant mode, the file is reported as a whole */
+        std::ostringstream lReport;
+        for(const INIDiagnostic &lDiagnostic : lINI->diagnostics()) {
+            lReport << pFile << ":" << lDiagnostic.mLine << ":" << lDiagnostic.mColumn
+                << ": " << INIParser::errorName(lDiagnostic.mKind) << "\n";
+        }
+
+        std::lock_guard<std::mutex> lLock(sOutputMutex);
+        std::cerr << lReport.str() << std::flush;
+        return -1;
+    }
+
+    switch(pOptions.mCommand) {
+        case INI_TOOL_NORMALIZE:
+            return normalize(*lINI, pFile, lInput);
+        case INI_TOOL_CONVERT:
+            return convert(*lINI, pOptions, pFile);
+        default:
+            return 0;
+    }
+}
+
+static double seconds(const INIToolClock::duration &pDuration) {
+    return std::chrono::duration<double>(pDuration).count();
+}
+
+/* ----------------------------------------------------- */
+/* Main ------------------------------------------------ */
+/* ----------------------------------------------------- */
+int main(const int argc, const char * const * const argv) {
+    if ((argc < 2) || (std::strcmp(argv[1U], "--help") == 0)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    INIToolOptions lOptions;
+    lOptions.mCommand = INI_TOOL_LINT;
+    lOptions.mFormat  = INI_TOOL_FORMAT_INI;
+    lOptions.mJobs    = 0U;
+    lOptions.mRuns    = INI_TOOL_RUNS;
+    lOptions.mMode    = INI_MODE_QUIET; /* Files are reported by the workers */
+    lOptions.mTyped   = false;
+    lOptions.mVerbose = false;
+
+    if(0 != parseArgs(argc, argv, lOptions)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    INIToolSummary lSummary;
+    lSummary.mFiles  = 0U;
+    lSummary.mFailed = 0U;
+    lSummary.mBytes  = 0U;
+
+    const INIToolClock::time_point lStart = INIToolClock::now();
+
+    size_t lWorkers = 0U;
+    {
+        /* Files are independent, one task each. The pool
+         * runs every queued task before being destroyed. */
+        INIThreadPool lPool(lOptions.mJobs);
+        lWorkers = lPool.workers();
+
+        for(const std::string &lFile : lOptions.mFiles) {
+            lPool.submit([&lOptions, &lSummary, &lFile](void) {
+                const INIToolClock::time_point lFileStart = INIToolClock::now();
+
+                uint64_t lBytes = 0U;
+                const int lResult = process(lOptions, lFile, lBytes);
+
+                const double lElapsed = seconds(INIToolClock::now() - lFileStart);
+
+                lSummary.mFiles.fetch_add(1U);
+                lSummary.mBytes.fetch_add(lBytes);
+                if(0 != lResult) {
+                    lSummary.mFailed.fetch_add(1U);
+                }
+
+                if(lOptions.mVerbose || (0 != lResult)) {
+                    std::lock_guard<std::mutex> lLock(sOutputMutex);
+                    std::cout << ((0 == lResult) ? "[OK   ] " : "[FAIL ] ") << lFile
+                        << " " << lBytes << " B " << (lElapsed * 1000.0) << " ms" << std::endl;
+                }
+            });
+        }
+    }
+
+    const double lElapsed = seconds(INIToolClock::now() - lStart);
+    const double lMegaBytes = static_cast<double>(lSummary.mBytes.load()) / (1024.0 * 1024.0);
+
+    std::cout << "[INFO ] " << lSummary.mFiles.load() << " files, "
+        << lSummary.mFailed.load() << " failed, "
+        << lWorkers << " workers, "
+        << lElapsed << " s, "
+        << (lMegaBytes / lElapsed) << " MiB/s, "
+        << (static_cast<double>(lSummary.mFiles.load()) / lElapsed) << " files/s" << std::endl;
+
+    return (0U == lSummary.mFailed.load()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}